@@ -13,6 +13,8 @@
 #include "mouse.h"
 #include "music2000.h"
 #include "music5000.h"
+#include "perf.h"
+#include "sched.h"
 #include "serial.h"
 #include "scsi.h"
 #include "sid_b-em.h"
@@ -28,10 +30,24 @@
 #include "wd1770.h"
 
 static int dbg_core6502 = 0;
+static int fetch_hooks = 0;
+static unsigned char *clip_paste_str, *clip_paste_ptr;
+
+/*
+ * Anything that needs to see each instruction before it is executed,
+ * the debugger or a paste in progress, sets fetch_hooks so that the
+ * common case costs a single test per opcode fetch.
+ */
+
+static inline void update_fetch_hooks(void)
+{
+    fetch_hooks = dbg_core6502 || clip_paste_ptr;
+}
 
 static int dbg_debug_enable(int newvalue) {
     int oldvalue = dbg_core6502;
     dbg_core6502 = newvalue;
+    update_fetch_hooks();
     return oldvalue;
 };
 
@@ -161,32 +177,17 @@ static uint32_t dbg_disassemble(uint32_t addr, char *buf, size_t bufsize) {
 int tubecycle;
 
 int output = 0;
-static int timetolive = 0;
+
+int m6502_slice = 40000;
 
 static int cycles;
-static int otherstuffcount = 0;
 static int romsel;
 static int ram4k, ram8k, ram12k, ram20k;
 
 static inline void polltime(int c)
 {
     cycles -= c;
-    via_poll(&sysvia, c);
-    via_poll(&uservia, c);
-    video_poll(c, 1);
-    otherstuffcount -= c;
-    if (motoron) {
-        if (fdc_time) {
-            fdc_time -= c;
-            if (fdc_time <= 0)
-                fdc_callback();
-        }
-        disc_time -= c;
-        if (disc_time <= 0) {
-            disc_time += 16;
-            disc_poll();
-        }
-    }
+    sched_advance(c);
     tubecycle += c;
 }
 
@@ -197,11 +198,42 @@ static uint8_t *memlook[2][256];
 static int memstat[2][256];
 static int vis20k = 0;
 
+/*
+ * Fast paths used by the opcode handlers.  Pages that are plain RAM
+ * or ROM are accessed straight through the page table; I/O pages, ROM
+ * writes, RAM still to be fetched by the video and the OS vectors
+ * watched for paste, along with everything while the debugger is
+ * attached or the heat map is being recorded, go through
+ * readmem/writemem.
+ */
+
+static inline uint8_t readmem_fast(uint16_t addr)
+{
+    int page = addr >> 8;
+
+    if (memstat[vis20k][page] && !(dbg_core6502 | debug_heatmap))
+        return memlook[vis20k][page][addr];
+    return readmem(addr);
+}
+
+static inline void writemem_fast(uint16_t addr, uint8_t val)
+{
+    int page = addr >> 8;
+
+    if (memstat[vis20k][page] == 1 && page != 2 && !(dbg_core6502 | debug_heatmap)) {
+        uint8_t *ptr = &memlook[vis20k][page][addr];
+        if (ptr < ram || ptr >= ram + RAM_SIZE || !video_watch[(ptr - ram) >> 8]) {
+            *ptr = val;
+            return;
+        }
+    }
+    writemem(addr, val);
+}
+
 static uint8_t acccon;
 
 static uint16_t buf_remv = 0xffff;
 static uint16_t buf_cnpv = 0xffff;
-static unsigned char *clip_paste_str, *clip_paste_ptr;
 static int os_paste_ch;
 
 void os_paste_start(char *str)
@@ -211,6 +243,7 @@ void os_paste_start(char *str)
             free(clip_paste_str);
         clip_paste_str = clip_paste_ptr = (unsigned char *)str;
         os_paste_ch = -1;
+        update_fetch_hooks();
         log_debug("6502: paste start, clip_paste_str=%p", clip_paste_str);
     }
 }
@@ -233,7 +266,8 @@ static void os_paste_remv(void)
             if (!ch) {
                 al_free(clip_paste_str);
                 clip_paste_str = clip_paste_ptr = NULL;
-                opcode = readmem(pc);
+                update_fetch_hooks();
+                opcode = readmem_fast(pc);
                 return;
             }
             if (ch == 0xc2 && *clip_paste_ptr == 0xa3) {
@@ -263,16 +297,11 @@ static void os_paste_cnpv(void)
         opcode = 0x60; // RTS
         return;
     }
-    opcode = readmem(pc);
+    opcode = readmem_fast(pc);
 }
 
-static inline void fetch_opcode(void)
+static void fetch_opcode_hooked(void)
 {
-    pc3 = oldoldpc;
-    oldoldpc = oldpc;
-    oldpc = pc;
-    vis20k = RAMbank[pc >> 12];
-
     if (dbg_core6502)
         debug_preexec(&core6502_cpu_debug, pc);
     if (pc == buf_remv && x == 0 && clip_paste_ptr)
@@ -280,22 +309,37 @@ static inline void fetch_opcode(void)
     else if (pc == buf_cnpv && x == 0 && clip_paste_ptr)
         os_paste_cnpv();
     else
-        opcode = readmem(pc);
+        opcode = readmem_fast(pc);
+}
+
+static inline void fetch_opcode(void)
+{
+    pc3 = oldoldpc;
+    oldoldpc = oldpc;
+    oldpc = pc;
+    vis20k = RAMbank[pc >> 12];
+
+    if (fetch_hooks)
+        fetch_opcode_hooked();
+    else
+        opcode = readmem_fast(pc);
     pc++;
 }
 
 static inline uint16_t read_zp_indirect(uint16_t zp)
 {
-    return readmem(zp & 0xff) + (readmem((zp + 1) & 0xff) << 8);
+    return readmem_fast(zp & 0xff) + (readmem_fast((zp + 1) & 0xff) << 8);
 }
 
 static uint32_t do_readmem(uint32_t addr)
 {
 
-        if (pc == addr)
-                fetchc[addr] = 31;
-        else
-                readc[addr] = 31;
+        if (debug_heatmap) {
+                if (pc == addr)
+                        debug_heatmap_access(fetchc, HEATMAP_FETCH, addr);
+                else
+                        debug_heatmap_access(readc, HEATMAP_READ, addr);
+        }
         if (memstat[vis20k][addr >> 8])
                 return memlook[vis20k][addr >> 8][addr];
         if (MASTER && (acccon & 0x40) && addr >= 0xFC00)
@@ -322,8 +366,10 @@ static uint32_t do_readmem(uint32_t addr)
         case 0xFC34:
         case 0xFC38:
         case 0xFC3C:
-                if (sound_beebsid)
+                if (sound_beebsid) {
+                        sound_sync();
                         return sid_read(addr);
+                }
                 break;
 
         case 0xFC40:
@@ -450,10 +496,14 @@ static void do_writemem(uint32_t addr, uint32_t val)
 {
         int c;
 
-        writec[addr] = 31;
+        if (debug_heatmap)
+                debug_heatmap_access(writec, HEATMAP_WRITE, addr);
         c = memstat[vis20k][addr >> 8];
         if (c == 1) {
-                memlook[vis20k][addr >> 8][addr] = val;
+                uint8_t *ptr = &memlook[vis20k][addr >> 8][addr];
+                if (ptr >= ram && ptr < ram + RAM_SIZE && video_watch[(ptr - ram) >> 8])
+                        video_sync();
+                *ptr = val;
                 switch(addr) {
                     case 0x022c:
                         buf_remv = (buf_remv & 0xff00) | val;
@@ -504,8 +554,10 @@ static void do_writemem(uint32_t addr, uint32_t val)
         case 0xFC34:
         case 0xFC38:
         case 0xFC3C:
-                if (sound_beebsid)
+                if (sound_beebsid) {
+                        sound_sync();
                         sid_write(addr, val);
+                }
                 break;
 
         case 0xFC40:
@@ -591,6 +643,7 @@ static void do_writemem(uint32_t addr, uint32_t val)
                 ram_fe34 = val;
                 if (BPLUS) {
                         acccon = val;
+                        video_sync();
                         vidbank = (val & 0x80) << 8;
                         if (val & 0x80)
                                 RAMbank[0xC] = RAMbank[0xD] = 1;
@@ -601,6 +654,7 @@ static void do_writemem(uint32_t addr, uint32_t val)
                         acccon = val;
                         ram8k = (val & 8);
                         ram20k = (val & 4);
+                        video_sync();
                         vidbank = (val & 1) ? 0x8000 : 0;
                         if (val & 2)
                                 RAMbank[0xC] = RAMbank[0xD] = 1;
@@ -703,6 +757,36 @@ int nmi, oldnmi, interrupt, takeint;
 uint16_t pc3, oldpc, oldoldpc;
 uint8_t opcode;
 
+/*
+ * Devices that are polled at a fixed rate rather than waiting for a
+ * specific time are handled together every 128 cycles.
+ */
+
+static void otherstuff_poll(void);
+static sched_event_t otherstuff_event = SCHED_EVENT("otherstuff", otherstuff_poll);
+
+static void otherstuff_poll(void) {
+    sched_at(&otherstuff_event, otherstuff_event.when + 128);
+    acia_poll(&sysacia);
+    if (sound_music5000)
+        music2000_poll();
+    if (!tapelcount) {
+        tape_poll();
+        tapelcount = tapellatch;
+    }
+    tapelcount--;
+    if (motorspin) {
+        motorspin--;
+        if (!motorspin)
+            fdc_spindown();
+    }
+    mcount--;
+    if (!mcount) {
+        mcount = 6;
+        mouse_poll();
+    }
+}
+
 void m6502_reset()
 {
         int c;
@@ -730,11 +814,13 @@ void m6502_reset()
         cycles = 0;
         ram4k = ram8k = ram12k = ram20k = 0;
 
-        pc = readmem(0xFFFC) | (readmem(0xFFFD) << 8);
+        pc = readmem_fast(0xFFFC) | (readmem_fast(0xFFFD) << 8);
         p.i = 1;
         nmi = oldnmi = 0;
         output = 0;
         tubecycle = tubecycles = 0;
+        if (!sched_pending(&otherstuff_event))
+                sched_add(&otherstuff_event, 0);
         log_debug("PC : %04X\n", pc);
 }
 
@@ -750,46 +836,13 @@ void dumpregs()
 
 static inline uint16_t getsw()
 {
-        uint16_t temp = readmem(pc);
+        uint16_t temp = readmem_fast(pc);
         pc++;
-        temp |= (readmem(pc) << 8);
+        temp |= (readmem_fast(pc) << 8);
         pc++;
         return temp;
 }
 
-static void otherstuff_poll(void) {
-    otherstuffcount += 128;
-    acia_poll(&sysacia);
-    if (sound_music5000)
-        music2000_poll();
-    sound_poll();
-    if (!tapelcount) {
-        tape_poll();
-        tapelcount = tapellatch;
-    }
-    tapelcount--;
-    if (motorspin) {
-        motorspin--;
-        if (!motorspin)
-            fdc_spindown();
-    }
-    if (ide_count) {
-        ide_count -= 200;
-        if (ide_count <= 0)
-            ide_callback();
-    }
-    if (adc_time) {
-        adc_time--;
-        if (!adc_time)
-            adc_poll();
-    }
-    mcount--;
-    if (!mcount) {
-        mcount = 6;
-        mouse_poll();
-    }
-}
-
 #define getw() getsw()
 
 static inline void setzn(uint8_t v)
@@ -800,12 +853,12 @@ static inline void setzn(uint8_t v)
 
 static inline void push(uint8_t v)
 {
-    writemem(0x100 + s--, v);
+    writemem_fast(0x100 + s--, v);
 }
 
 static inline uint8_t pull(void)
 {
-    return readmem(0x100 + ++s);
+    return readmem_fast(0x100 + ++s);
 }
 
 static inline void adc_nmos(uint8_t temp)
@@ -964,13 +1017,57 @@ static void branchcycles(int temp)
         }
 }
 
+/*
+ * Interrupt entry and the work done between instructions are common
+ * to both cores.  The cmos argument is a constant at every call so
+ * each core gets its own specialised copy with no run-time test.
+ */
+
+static inline void take_interrupt(uint16_t vector, bool cmos)
+{
+    push(pc >> 8);
+    push(pc & 0xFF);
+    push(pack_flags(0x20));
+    pc = readmem_fast(vector) | (readmem_fast(vector + 1) << 8);
+    p.i = 1;
+    if (cmos)
+        p.d = 0;
+    polltime(7);
+}
+
+static inline void end_instruction(bool cmos)
+{
+    if (takeint) {
+        interrupt &= ~128;
+        takeint = 0;
+        take_interrupt(0xFFFE, cmos);
+    }
+    interrupt &= ~128;
+
+    if (tube_exec && tubecycle) {
+        int tempi = (tubecycle * tube_multipler) >> 1;
+        tubecycles += tempi;
+        perf_count.tube_cycles += tempi;
+        if (tubecycles > 3)
+            tube_exec();
+        tubecycle = 0;
+    }
+
+    if (nmi && !oldnmi) {
+        take_interrupt(0xFFFA, cmos);
+        nmi = 0;
+    }
+    if (cmos)
+        oldnmi = nmi;
+}
+
 void m6502_exec()
 {
         uint16_t addr;
         uint8_t temp;
         int tempi;
         int8_t offset;
-        cycles += 40000;
+        cycles += m6502_slice;
 
         while (cycles > 0) {
                 fetch_opcode();
@@ -982,74 +1079,74 @@ void m6502_exec()
                         push(pc >> 8);
                         push(pc & 0xFF);
                         push(pack_flags(0x30));
-                        pc = readmem(0xFFFE) | (readmem(0xFFFF) << 8);
+                        pc = readmem_fast(0xFFFE) | (readmem_fast(0xFFFF) << 8);
                         p.i = 1;
                         polltime(7);
                         takeint = 0;
                         break;
 
                 case 0x01:      /*ORA (,x) */
-                        temp = readmem(pc) + x;
+                        temp = readmem_fast(pc) + x;
                         pc++;
                         addr = read_zp_indirect(temp);
                         polltime(6);
                         takeint = (interrupt && !p.i);
-                        a |= readmem(addr);
+                        a |= readmem_fast(addr);
                         setzn(a);
                         break;
 
                 case 0x03:      /*Undocumented - SLO (,x) */
-                        temp = readmem(pc) + x;
+                        temp = readmem_fast(pc) + x;
                         pc++;
                         addr = read_zp_indirect(temp);
                         polltime(5);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         polltime(1);
                         p.c = temp & 0x80;
                         temp <<= 1;
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         a |= temp;
                         setzn(a);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x04:      /*Undocumented - NOP zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x05:      /*ORA zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        a |= readmem(addr);
+                        a |= readmem_fast(addr);
                         setzn(a);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x06:      /*ASL zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         p.c = temp & 0x80;
                         temp <<= 1;
                         setzn(temp);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x07:      /*Undocumented - SLO zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         p.c = temp & 0x80;
                         temp <<= 1;
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         a |= temp;
                         setzn(a);
                         polltime(5);
@@ -1065,7 +1162,7 @@ void m6502_exec()
                         break;
 
                 case 0x09:      /*ORA imm */
-                        a |= readmem(pc);
+                        a |= readmem_fast(pc);
                         pc++;
                         setzn(a);
                         polltime(2);
@@ -1081,7 +1178,7 @@ void m6502_exec()
                         break;
 
                 case 0x0B:      /*Undocumented - ANC imm */
-                        a &= readmem(pc);
+                        a &= readmem_fast(pc);
                         pc++;
                         setzn(a);
                         p.c = p.n;
@@ -1099,41 +1196,41 @@ void m6502_exec()
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        a |= readmem(addr);
+                        a |= readmem_fast(addr);
                         setzn(a);
                         break;
 
                 case 0x0E:      /*ASL abs */
                         addr = getw();
                         polltime(4);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         polltime(1);
                         p.c = temp & 0x80;
                         temp <<= 1;
                         setzn(temp);
                         takeint = (interrupt && !p.i);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         break;
 
                 case 0x0F:      /*Undocumented - SLO abs */
                         addr = getw();
                         polltime(4);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         polltime(1);
                         p.c = temp & 0x80;
                         temp <<= 1;
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         a |= temp;
                         setzn(a);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x10:
-                        /*BPL*/ offset = (int8_t) readmem(pc);
+                        /*BPL*/ offset = (int8_t) readmem_fast(pc);
                         pc++;
                         temp = 2;
                         if (!p.n) {
@@ -1146,76 +1243,76 @@ void m6502_exec()
                         break;
 
                 case 0x11:      /*ORA (),y */
-                        temp = readmem(pc);
+                        temp = readmem_fast(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        a |= readmem(addr + y);
+                        a |= readmem_fast(addr + y);
                         setzn(a);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x13:      /*Undocumented - SLO (),y */
-                        temp = readmem(pc);
+                        temp = readmem_fast(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
                         polltime(5);
-                        temp = readmem(addr + y);
+                        temp = readmem_fast(addr + y);
                         polltime(1);
-                        writemem(addr + y, temp);
+                        writemem_fast(addr + y, temp);
                         polltime(1);
                         p.c = temp & 0x80;
                         temp <<= 1;
-                        writemem(addr + y, temp);
+                        writemem_fast(addr + y, temp);
                         a |= temp;
                         setzn(a);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x14:      /*Undocumented - NOP zp,x */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        readmem((addr + x) & 0xFF);
+                        readmem_fast((addr + x) & 0xFF);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x15:      /*ORA zp,x */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        a |= readmem((addr + x) & 0xFF);
+                        a |= readmem_fast((addr + x) & 0xFF);
                         setzn(a);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x16:      /*ASL zp,x */
-                        addr = (readmem(pc) + x) & 0xFF;
+                        addr = (readmem_fast(pc) + x) & 0xFF;
                         pc++;
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         p.c = temp & 0x80;
                         temp <<= 1;
                         setzn(temp);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x17:      /*Undocumented - SLO zp,x */
-                        addr = (readmem(pc) + x) & 0xFF;
+                        addr = (readmem_fast(pc) + x) & 0xFF;
                         pc++;
                         polltime(3);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         polltime(1);
                         p.c = temp & 0x80;
                         temp <<= 1;
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         a |= temp;
                         setzn(a);
                         takeint = (interrupt && !p.i);
@@ -1231,7 +1328,7 @@ void m6502_exec()
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        a |= readmem(addr + y);
+                        a |= readmem_fast(addr + y);
                         setzn(a);
                         polltime(4);
                         takeint = (interrupt && !p.i);
@@ -1247,13 +1344,13 @@ void m6502_exec()
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
                         polltime(4);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         polltime(1);
                         p.c = temp & 0x80;
                         temp <<= 1;
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         a |= temp;
                         setzn(a);
                         takeint = (interrupt && !p.i);
@@ -1263,7 +1360,7 @@ void m6502_exec()
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + x) & 0xFF00))
                                 polltime(1);
-                        readmem(addr);
+                        readmem_fast(addr);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
@@ -1275,20 +1372,20 @@ void m6502_exec()
                         addr += x;
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        a |= readmem(addr);
+                        a |= readmem_fast(addr);
                         setzn(a);
                         break;
 
                 case 0x1E:      /*ASL abs,x */
                         addr = getw();
-                        readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
+                        readmem_fast((addr & 0xFF00) | ((addr + x) & 0xFF));
                         addr += x;
-                        temp = readmem(addr);
-                        writemem(addr, temp);
+                        temp = readmem_fast(addr);
+                        writemem_fast(addr, temp);
                         p.c = temp & 0x80;
                         temp <<= 1;
                         takeint = (interrupt && !p.i);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         setzn(temp);
                         polltime(7);
                         break;
@@ -1298,13 +1395,13 @@ void m6502_exec()
                         if ((addr & 0xFF00) ^ ((addr + x) & 0xFF00))
                                 polltime(1);
                         polltime(4);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         polltime(1);
                         p.c = temp & 0x80;
                         temp <<= 1;
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         a |= temp;
                         setzn(a);
                         takeint = (interrupt && !p.i);
@@ -1322,39 +1419,39 @@ void m6502_exec()
                         break;
 
                 case 0x21:      /*AND (,x) */
-                        temp = readmem(pc) + x;
+                        temp = readmem_fast(pc) + x;
                         pc++;
                         addr = read_zp_indirect(temp);
-                        a &= readmem(addr);
+                        a &= readmem_fast(addr);
                         setzn(a);
                         polltime(6);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x23:      /*Undocumented - RLA (,x) */
-                        temp = readmem(pc) + x;
+                        temp = readmem_fast(pc) + x;
                         pc++;
                         addr = read_zp_indirect(temp);
                         polltime(5);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         polltime(1);
                         tempi = p.c;
                         p.c = temp & 0x80;
                         temp <<= 1;
                         if (tempi)
                                 temp |= 1;
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         a &= temp;
                         setzn(a);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x24:      /*BIT zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         p.z = !(a & temp);
                         p.v = temp & 0x40;
                         p.n = temp & 0x80;
@@ -1363,39 +1460,39 @@ void m6502_exec()
                         break;
 
                 case 0x25:      /*AND zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        a &= readmem(addr);
+                        a &= readmem_fast(addr);
                         setzn(a);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x26:      /*ROL zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         tempi = p.c;
                         p.c = temp & 0x80;
                         temp <<= 1;
                         if (tempi)
                                 temp |= 1;
                         setzn(temp);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x27:      /*Undocumented - RLA zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         tempi = p.c;
                         p.c = temp & 0x80;
                         temp <<= 1;
                         if (tempi)
                                 temp |= 1;
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         a &= temp;
                         setzn(a);
                         polltime(5);
@@ -1410,7 +1507,7 @@ void m6502_exec()
                         break;
 
                 case 0x29:
-                        /*AND*/ a &= readmem(pc);
+                        /*AND*/ a &= readmem_fast(pc);
                         pc++;
                         setzn(a);
                         polltime(2);
@@ -1429,7 +1526,7 @@ void m6502_exec()
                         break;
 
                 case 0x2B:      /*Undocumented - ANC imm */
-                        a &= readmem(pc);
+                        a &= readmem_fast(pc);
                         pc++;
                         setzn(a);
                         p.c = p.n;
@@ -1441,7 +1538,7 @@ void m6502_exec()
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         p.z = !(a & temp);
                         p.v = temp & 0x40;
                         p.n = temp & 0x80;
@@ -1451,16 +1548,16 @@ void m6502_exec()
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        a &= readmem(addr);
+                        a &= readmem_fast(addr);
                         setzn(a);
                         break;
 
                 case 0x2E:      /*ROL abs */
                         addr = getw();
                         polltime(4);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         tempi = p.c;
                         p.c = temp & 0x80;
                         temp <<= 1;
@@ -1470,19 +1567,19 @@ void m6502_exec()
                         polltime(1);
                         if (!takeint)
                                 takeint = (interrupt && !p.i);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         setzn(temp);
                         break;
 
                 case 0x2F:      /*Undocumented - RLA abs */
                         addr = getw();  /*Found in The Hobbit */
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         tempi = p.c;
                         p.c = temp & 0x80;
                         temp <<= 1;
                         if (tempi)
                                 temp |= 1;
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         a &= temp;
                         setzn(a);
                         polltime(6);
@@ -1490,7 +1587,7 @@ void m6502_exec()
                         break;
 
                 case 0x30:
-                        /*BMI*/ offset = (int8_t) readmem(pc);
+                        /*BMI*/ offset = (int8_t) readmem_fast(pc);
                         pc++;
                         temp = 2;
                         if (p.n) {
@@ -1503,83 +1600,83 @@ void m6502_exec()
                         break;
 
                 case 0x31:      /*AND (),y */
-                        temp = readmem(pc);
+                        temp = readmem_fast(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        a &= readmem(addr + y);
+                        a &= readmem_fast(addr + y);
                         setzn(a);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x33:      /*Undocumented - RLA (),y */
-                        temp = readmem(pc);
+                        temp = readmem_fast(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
                         polltime(5);
-                        temp = readmem(addr + y);
+                        temp = readmem_fast(addr + y);
                         polltime(1);
-                        writemem(addr + y, temp);
+                        writemem_fast(addr + y, temp);
                         tempi = p.c;
                         p.c = temp & 0x80;
                         temp <<= 1;
                         if (tempi)
                                 temp |= 1;
                         polltime(1);
-                        writemem(addr + y, temp);
+                        writemem_fast(addr + y, temp);
                         a &= temp;
                         setzn(a);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x34:      /*Undocumented - NOP zp,x */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        readmem((addr + x) & 0xFF);
+                        readmem_fast((addr + x) & 0xFF);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x35:      /*AND zp,x */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        a &= readmem((addr + x) & 0xFF);
+                        a &= readmem_fast((addr + x) & 0xFF);
                         setzn(a);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x36:      /*ROL zp,x */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
                         addr += x;
                         addr &= 0xFF;
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         tempi = p.c;
                         p.c = temp & 0x80;
                         temp <<= 1;
                         if (tempi)
                                 temp |= 1;
                         setzn(temp);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x37:      /*Undocumented - RLA zp,x */
-                        addr = (readmem(pc) + x) & 0xFF;
+                        addr = (readmem_fast(pc) + x) & 0xFF;
                         pc++;
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         tempi = p.c;
                         p.c = temp & 0x80;
                         temp <<= 1;
                         if (tempi)
                                 temp |= 1;
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         a &= temp;
                         setzn(a);
                         polltime(5);
@@ -1596,7 +1693,7 @@ void m6502_exec()
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        a &= readmem(addr + y);
+                        a &= readmem_fast(addr + y);
                         setzn(a);
                         polltime(4);
                         takeint = (interrupt && !p.i);
@@ -1612,16 +1709,16 @@ void m6502_exec()
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
                         polltime(4);
-                        temp = readmem(addr + y);
+                        temp = readmem_fast(addr + y);
                         polltime(1);
-                        writemem(addr + y, temp);
+                        writemem_fast(addr + y, temp);
                         tempi = p.c;
                         p.c = temp & 0x80;
                         temp <<= 1;
                         if (tempi)
                                 temp |= 1;
                         polltime(1);
-                        writemem(addr + y, temp);
+                        writemem_fast(addr + y, temp);
                         a &= temp;
                         setzn(a);
                         takeint = (interrupt && !p.i);
@@ -1631,7 +1728,7 @@ void m6502_exec()
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + x) & 0xFF00))
                                 polltime(1);
-                        readmem(addr + x);
+                        readmem_fast(addr + x);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
@@ -1641,7 +1738,7 @@ void m6502_exec()
                         if ((addr & 0xFF00) ^ ((addr + x) & 0xFF00))
                                 polltime(1);
                         addr += x;
-                        a &= readmem(addr);
+                        a &= readmem_fast(addr);
                         setzn(a);
                         polltime(4);
                         takeint = (interrupt && !p.i);
@@ -1649,16 +1746,16 @@ void m6502_exec()
 
                 case 0x3E:      /*ROL abs,x */
                         addr = getw();
-                        readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
+                        readmem_fast((addr & 0xFF00) | ((addr + x) & 0xFF));
                         addr += x;
-                        temp = readmem(addr);
-                        writemem(addr, temp);
+                        temp = readmem_fast(addr);
+                        writemem_fast(addr, temp);
                         tempi = p.c;
                         p.c = temp & 0x80;
                         temp <<= 1;
                         if (tempi)
                                 temp |= 1;
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         setzn(temp);
                         polltime(7);
                         takeint = (interrupt && !p.i);
@@ -1669,16 +1766,16 @@ void m6502_exec()
                         if ((addr & 0xFF00) ^ ((addr + x) & 0xFF00))
                                 polltime(1);
                         polltime(4);
-                        temp = readmem(addr + x);
+                        temp = readmem_fast(addr + x);
                         polltime(1);
-                        writemem(addr + x, temp);
+                        writemem_fast(addr + x, temp);
                         tempi = p.c;
                         p.c = temp & 0x80;
                         temp <<= 1;
                         if (tempi)
                                 temp |= 1;
                         polltime(1);
-                        writemem(addr + x, temp);
+                        writemem_fast(addr + x, temp);
                         a &= temp;
                         setzn(a);
                         takeint = (interrupt && !p.i);
@@ -1695,72 +1792,72 @@ void m6502_exec()
                         break;
 
                 case 0x41:      /*EOR (,x) */
-                        temp = readmem(pc) + x;
+                        temp = readmem_fast(pc) + x;
                         pc++;
                         addr = read_zp_indirect(temp);
-                        a ^= readmem(addr);
+                        a ^= readmem_fast(addr);
                         setzn(a);
                         polltime(6);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x43:      /*Undocumented - SRE (,x) */
-                        temp = readmem(pc) + x;
+                        temp = readmem_fast(pc) + x;
                         pc++;
                         addr = read_zp_indirect(temp);
                         polltime(5);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         p.c = temp & 1;
                         temp >>= 1;
                         polltime(1);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         a ^= temp;
                         setzn(a);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x44:      /*Undocumented - NOP zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        readmem(addr);
+                        readmem_fast(addr);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x45:      /*EOR zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        a ^= readmem(addr);
+                        a ^= readmem_fast(addr);
                         setzn(a);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x46:      /*LSR zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         p.c = temp & 1;
                         temp >>= 1;
                         setzn(temp);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x47:      /*Undocumented - SRE zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
                         polltime(3);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         p.c = temp & 1;
                         temp >>= 1;
                         polltime(1);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         a ^= temp;
                         setzn(a);
                         takeint = (interrupt && !p.i);
@@ -1773,7 +1870,7 @@ void m6502_exec()
                         break;
 
                 case 0x49:      /*EOR imm */
-                        a ^= readmem(pc);
+                        a ^= readmem_fast(pc);
                         pc++;
                         setzn(a);
                         polltime(2);
@@ -1789,7 +1886,7 @@ void m6502_exec()
                         break;
 
                 case 0x4B:      /*Undocumented - ASR imm */
-                        a &= readmem(pc);
+                        a &= readmem_fast(pc);
                         pc++;
                         p.c = a & 1;
                         a >>= 1;
@@ -1809,16 +1906,16 @@ void m6502_exec()
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        a ^= readmem(addr);
+                        a ^= readmem_fast(addr);
                         setzn(a);
                         break;
 
                 case 0x4E:      /*LSR abs */
                         addr = getw();
                         polltime(4);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         takeint = ((interrupt & 128) && !p.i);  // takeint=1;
                         polltime(1);
                         if (!takeint)
@@ -1826,26 +1923,26 @@ void m6502_exec()
                         p.c = temp & 1;
                         temp >>= 1;
                         setzn(temp);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         break;
 
                 case 0x4F:      /*Undocumented - SRE abs */
                         addr = getw();
                         polltime(4);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         p.c = temp & 1;
                         temp >>= 1;
                         polltime(1);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         a ^= temp;
                         setzn(a);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x50:
-                        /*BVC*/ offset = (int8_t) readmem(pc);
+                        /*BVC*/ offset = (int8_t) readmem_fast(pc);
                         pc++;
                         temp = 2;
                         if (!p.v) {
@@ -1858,76 +1955,76 @@ void m6502_exec()
                         break;
 
                 case 0x51:      /*EOR (),y */
-                        temp = readmem(pc);
+                        temp = readmem_fast(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        a ^= readmem(addr + y);
+                        a ^= readmem_fast(addr + y);
                         setzn(a);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x53:      /*Undocumented - SRE (),y */
-                        temp = readmem(pc);
+                        temp = readmem_fast(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
                         polltime(5);
-                        temp = readmem(addr + y);
+                        temp = readmem_fast(addr + y);
                         polltime(1);
-                        writemem(addr + y, temp);
+                        writemem_fast(addr + y, temp);
                         p.c = temp & 1;
                         temp >>= 1;
                         polltime(1);
-                        writemem(addr + y, temp);
+                        writemem_fast(addr + y, temp);
                         a ^= temp;
                         setzn(a);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x54:      /*Undocumented - NOP zp,x */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        readmem((addr + x) & 0xFF);
+                        readmem_fast((addr + x) & 0xFF);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x55:      /*EOR zp,x */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        a ^= readmem((addr + x) & 0xFF);
+                        a ^= readmem_fast((addr + x) & 0xFF);
                         setzn(a);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x56:      /*LSR zp,x */
-                        addr = (readmem(pc) + x) & 0xFF;
+                        addr = (readmem_fast(pc) + x) & 0xFF;
                         pc++;
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         p.c = temp & 1;
                         temp >>= 1;
                         setzn(temp);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x57:      /*Undocumented - SRE zp,x */
-                        addr = (readmem(pc) + x) & 0xFF;
+                        addr = (readmem_fast(pc) + x) & 0xFF;
                         pc++;
                         polltime(3);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         p.c = temp & 1;
                         temp >>= 1;
                         polltime(1);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         a ^= temp;
                         setzn(a);
                         takeint = (interrupt && !p.i);
@@ -1943,7 +2040,7 @@ void m6502_exec()
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        a ^= readmem(addr + y);
+                        a ^= readmem_fast(addr + y);
                         setzn(a);
                         polltime(4);
                         takeint = (interrupt && !p.i);
@@ -1959,13 +2056,13 @@ void m6502_exec()
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
                         polltime(4);
-                        temp = readmem(addr + y);
+                        temp = readmem_fast(addr + y);
                         polltime(1);
-                        writemem(addr + y, temp);
+                        writemem_fast(addr + y, temp);
                         p.c = temp & 1;
                         temp >>= 1;
                         polltime(1);
-                        writemem(addr + y, temp);
+                        writemem_fast(addr + y, temp);
                         a ^= temp;
                         setzn(a);
                         takeint = (interrupt && !p.i);
@@ -1975,10 +2072,10 @@ void m6502_exec()
                         addr = getw();
                         polltime(4);
                         if ((addr & 0xFF00) ^ ((addr + x) & 0xFF00)) {
-                                readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
+                                readmem_fast((addr & 0xFF00) | ((addr + x) & 0xFF));
                                 polltime(1);
                         }
-                        readmem(addr + x);
+                        readmem_fast(addr + x);
                         takeint = (interrupt && !p.i);
                         break;
 
@@ -1986,24 +2083,24 @@ void m6502_exec()
                         addr = getw();
                         polltime(4);
                         if ((addr & 0xFF00) ^ ((addr + x) & 0xFF00)) {
-                                readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
+                                readmem_fast((addr & 0xFF00) | ((addr + x) & 0xFF));
                                 polltime(1);
                         }
                         addr += x;
-                        a ^= readmem(addr);
+                        a ^= readmem_fast(addr);
                         setzn(a);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x5E:      /*LSR abs,x */
                         addr = getw();
-                        readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
+                        readmem_fast((addr & 0xFF00) | ((addr + x) & 0xFF));
                         addr += x;
-                        temp = readmem(addr);
-                        writemem(addr, temp);
+                        temp = readmem_fast(addr);
+                        writemem_fast(addr, temp);
                         p.c = temp & 1;
                         temp >>= 1;
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         setzn(temp);
                         polltime(7);
                         takeint = (interrupt && !p.i);
@@ -2014,13 +2111,13 @@ void m6502_exec()
                         if ((addr & 0xFF00) ^ ((addr + x) & 0xFF00))
                                 polltime(1);
                         polltime(4);
-                        temp = readmem(addr + x);
+                        temp = readmem_fast(addr + x);
                         polltime(1);
-                        writemem(addr + x, temp);
+                        writemem_fast(addr + x, temp);
                         p.c = temp & 1;
                         temp >>= 1;
                         polltime(1);
-                        writemem(addr + x, temp);
+                        writemem_fast(addr + x, temp);
                         a ^= temp;
                         setzn(a);
                         takeint = (interrupt && !p.i);
@@ -2036,76 +2133,76 @@ void m6502_exec()
                         break;
 
                 case 0x61:      /*ADC (,x) */
-                        temp = readmem(pc) + x;
+                        temp = readmem_fast(pc) + x;
                         pc++;
                         addr = read_zp_indirect(temp);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         adc_nmos(temp);
                         polltime(6);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x63:      /*Undocumented - RRA (,x) */
-                        temp = readmem(pc) + x;
+                        temp = readmem_fast(pc) + x;
                         pc++;
                         addr = read_zp_indirect(temp);
                         polltime(5);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         temp >>= 1;
                         if (p.c)
                                 temp |= 0x80;
                         polltime(1);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         adc_nmos(temp);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x64:      /*Undocumented - NOP zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        readmem(addr);
+                        readmem_fast(addr);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x65:      /*ADC zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         adc_nmos(temp);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x66:      /*ROR zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         tempi = p.c;
                         p.c = temp & 1;
                         temp >>= 1;
                         if (tempi)
                                 temp |= 0x80;
                         setzn(temp);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x67:      /*Undocumented - RRA zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
                         polltime(3);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         temp >>= 1;
                         if (p.c)
                                 temp |= 0x80;
                         polltime(1);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         adc_nmos(temp);
                         takeint = (interrupt && !p.i);
                         break;
@@ -2118,7 +2215,7 @@ void m6502_exec()
                         break;
 
                 case 0x69:      /*ADC imm */
-                        temp = readmem(pc);
+                        temp = readmem_fast(pc);
                         pc++;
                         adc_nmos(temp);
                         polltime(2);
@@ -2137,7 +2234,7 @@ void m6502_exec()
                         break;
 
                 case 0x6B:      /*Undocumented - ARR */
-                        a &= readmem(pc);
+                        a &= readmem_fast(pc);
                         pc++;
                         tempi = p.c;
                         if (p.d) {      /*This instruction is just as broken on a real 6502 as it is here */
@@ -2168,10 +2265,10 @@ void m6502_exec()
                 case 0x6C:      /*JMP () */
                         addr = getw();
                         if ((addr & 0xFF) == 0xFF)
-                                pc = readmem(addr) | (readmem(addr - 0xFF) <<
+                                pc = readmem_fast(addr) | (readmem_fast(addr - 0xFF) <<
                                                       8);
                         else
-                                pc = readmem(addr) | (readmem(addr + 1) << 8);
+                                pc = readmem_fast(addr) | (readmem_fast(addr + 1) << 8);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
@@ -2180,17 +2277,17 @@ void m6502_exec()
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         adc_nmos(temp);
                         break;
 
                 case 0x6E:      /*ROR abs */
                         addr = getw();
                         polltime(4);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         polltime(1);
                         takeint = (interrupt && !p.i);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         if ((interrupt & 128) && !p.i)
                                 takeint = 1;
                         polltime(1);
@@ -2202,26 +2299,26 @@ void m6502_exec()
                         if (tempi)
                                 temp |= 0x80;
                         setzn(temp);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         break;
 
                 case 0x6F:      /*Undocumented - RRA abs */
                         addr = getw();
                         polltime(4);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         temp >>= 1;
                         if (p.c)
                                 temp |= 0x80;
                         polltime(1);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         adc_nmos(temp);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x70:
-                        /*BVS*/ offset = (int8_t) readmem(pc);
+                        /*BVS*/ offset = (int8_t) readmem_fast(pc);
                         pc++;
                         temp = 2;
                         if (p.v) {
@@ -2234,82 +2331,82 @@ void m6502_exec()
                         break;
 
                 case 0x71:      /*ADC (),y */
-                        temp = readmem(pc);
+                        temp = readmem_fast(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        temp = readmem(addr + y);
+                        temp = readmem_fast(addr + y);
                         adc_nmos(temp);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x73:      /*Undocumented - RRA (,y) */
-                        temp = readmem(pc);
+                        temp = readmem_fast(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
                         polltime(5);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         temp >>= 1;
                         if (p.c)
                                 temp |= 0x80;
                         polltime(1);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         adc_nmos(temp);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x74:      /*Undocumented - NOP zp,x */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        readmem((addr + x) & 0xFF);
+                        readmem_fast((addr + x) & 0xFF);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x75:      /*ADC zp,x */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        temp = readmem((addr + x) & 0xFF);
+                        temp = readmem_fast((addr + x) & 0xFF);
                         adc_nmos(temp);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x76:      /*ROR zp,x */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
                         addr += x;
                         addr &= 0xFF;
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         tempi = p.c;
                         p.c = temp & 1;
                         temp >>= 1;
                         if (tempi)
                                 temp |= 0x80;
                         setzn(temp);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x77:      /*Undocumented - RRA zp,x */
-                        addr = (readmem(pc) + x) & 0xFF;
+                        addr = (readmem_fast(pc) + x) & 0xFF;
                         pc++;
                         polltime(3);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         temp >>= 1;
                         if (p.c)
                                 temp |= 0x80;
                         polltime(1);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         adc_nmos(temp);
                         takeint = (interrupt && !p.i);
                         break;
@@ -2324,7 +2421,7 @@ void m6502_exec()
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        temp = readmem(addr + y);
+                        temp = readmem_fast(addr + y);
                         adc_nmos(temp);
                         polltime(4);
                         takeint = (interrupt && !p.i);
@@ -2340,14 +2437,14 @@ void m6502_exec()
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
                         polltime(4);
-                        temp = readmem(addr + y);
+                        temp = readmem_fast(addr + y);
                         polltime(1);
-                        writemem(addr + y, temp);
+                        writemem_fast(addr + y, temp);
                         temp >>= 1;
                         if (p.c)
                                 temp |= 0x80;
                         polltime(1);
-                        writemem(addr + y, temp);
+                        writemem_fast(addr + y, temp);
                         adc_nmos(temp);
                         takeint = (interrupt && !p.i);
                         break;
@@ -2356,7 +2453,7 @@ void m6502_exec()
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + x) & 0xFF00))
                                 polltime(1);
-                        readmem(addr);
+                        readmem_fast(addr);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
@@ -2366,7 +2463,7 @@ void m6502_exec()
                         if ((addr & 0xFF00) ^ ((addr + x) & 0xFF00))
                                 polltime(1);
                         addr += x;
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         adc_nmos(temp);
                         polltime(4);
                         takeint = (interrupt && !p.i);
@@ -2374,16 +2471,16 @@ void m6502_exec()
 
                 case 0x7E:      /*ROR abs,x */
                         addr = getw();
-                        readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
+                        readmem_fast((addr & 0xFF00) | ((addr + x) & 0xFF));
                         addr += x;
-                        temp = readmem(addr);
-                        writemem(addr, temp);
+                        temp = readmem_fast(addr);
+                        writemem_fast(addr, temp);
                         tempi = p.c;
                         p.c = temp & 1;
                         temp >>= 1;
                         if (tempi)
                                 temp |= 0x80;
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         setzn(temp);
                         polltime(7);
                         takeint = (interrupt && !p.i);
@@ -2394,78 +2491,78 @@ void m6502_exec()
                         if ((addr & 0xFF00) ^ ((addr + x) & 0xFF00))
                                 polltime(1);
                         polltime(4);
-                        temp = readmem(addr + x);
+                        temp = readmem_fast(addr + x);
                         polltime(1);
-                        writemem(addr + x, temp);
+                        writemem_fast(addr + x, temp);
                         temp >>= 1;
                         if (p.c)
                                 temp |= 0x80;
                         polltime(1);
-                        writemem(addr + x, temp);
+                        writemem_fast(addr + x, temp);
                         adc_nmos(temp);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x80:      /*Undocumented - NOP imm */
-                        readmem(pc);
+                        readmem_fast(pc);
                         pc++;
                         polltime(2);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x81:      /*STA (,x) */
-                        temp = readmem(pc) + x;
+                        temp = readmem_fast(pc) + x;
                         pc++;
                         addr = read_zp_indirect(temp);
-                        writemem(addr, a);
+                        writemem_fast(addr, a);
                         polltime(6);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x82:      /*Undocumented - NOP imm *//*Should sometimes lock up the machine */
-                        readmem(pc);
+                        readmem_fast(pc);
                         pc++;
                         polltime(2);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x83:      /*Undocumented - SAX (,x) */
-                        temp = readmem(pc) + x;
+                        temp = readmem_fast(pc) + x;
                         pc++;
                         addr = read_zp_indirect(temp);
-                        writemem(addr, a & x);
+                        writemem_fast(addr, a & x);
                         polltime(6);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x84:      /*STY zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        writemem(addr, y);
+                        writemem_fast(addr, y);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x85:      /*STA zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        writemem(addr, a);
+                        writemem_fast(addr, a);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x86:      /*STX zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        writemem(addr, x);
+                        writemem_fast(addr, x);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x87:      /*Undocumented - SAX zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        writemem(addr, a & x);
+                        writemem_fast(addr, a & x);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
@@ -2478,7 +2575,7 @@ void m6502_exec()
                         break;
 
                 case 0x89:      /*Undocumented - NOP imm */
-                        readmem(pc);
+                        readmem_fast(pc);
                         pc++;
                         polltime(2);
                         takeint = (interrupt && !p.i);
@@ -2492,7 +2589,7 @@ void m6502_exec()
                         break;
 
                 case 0x8B:      /*Undocumented - ANE */
-                        temp = readmem(pc);
+                        temp = readmem_fast(pc);
                         pc++;
                         a = (a | 0xEE) & x & temp;      /*Internal parameter always 0xEE on BBC, always 0xFF on Electron */
                         setzn(a);
@@ -2504,32 +2601,32 @@ void m6502_exec()
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        writemem(addr, y);
+                        writemem_fast(addr, y);
                         break;
 
                 case 0x8D:      /*STA abs */
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        writemem(addr, a);
+                        writemem_fast(addr, a);
                         break;
 
                 case 0x8E:      /*STX abs */
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        writemem(addr, x);
+                        writemem_fast(addr, x);
                         break;
 
                 case 0x8F:      /*Undocumented - SAX abs */
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        writemem(addr, a & x);
+                        writemem_fast(addr, a & x);
                         break;
 
                 case 0x90:
-                        /*BCC*/ offset = (int8_t) readmem(pc);
+                        /*BCC*/ offset = (int8_t) readmem_fast(pc);
                         pc++;
                         temp = 2;
                         if (!p.c) {
@@ -2542,51 +2639,51 @@ void m6502_exec()
                         break;
 
                 case 0x91:      /*STA (),y */
-                        temp = readmem(pc);
+                        temp = readmem_fast(pc);
                         pc++;
                         addr = read_zp_indirect(temp) + y;
-                        writemem(addr, a);
+                        writemem_fast(addr, a);
                         polltime(6);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x93:      /*Undocumented - SHA (),y */
-                        temp = readmem(pc);
+                        temp = readmem_fast(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
-                        writemem(addr + y, a & x & ((addr >> 8) + 1));
+                        writemem_fast(addr + y, a & x & ((addr >> 8) + 1));
                         polltime(6);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x94:      /*STY zp,x */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        writemem((addr + x) & 0xFF, y);
+                        writemem_fast((addr + x) & 0xFF, y);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x95:      /*STA zp,x */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        writemem((addr + x) & 0xFF, a);
+                        writemem_fast((addr + x) & 0xFF, a);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x96:      /*STX zp,y */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        writemem((addr + y) & 0xFF, x);
+                        writemem_fast((addr + y) & 0xFF, x);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x97:      /*Undocumented - SAX zp,y */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        writemem((addr + y) & 0xFF, a & x);
+                        writemem_fast((addr + y) & 0xFF, a & x);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
@@ -2601,10 +2698,10 @@ void m6502_exec()
                 case 0x99:      /*STA abs,y */
                         addr = getw();
                         polltime(4);
-                        readmem((addr & 0xFF00) | ((addr + y) & 0xFF));
+                        readmem_fast((addr & 0xFF00) | ((addr + y) & 0xFF));
                         polltime(1);
                         takeint = (interrupt && !p.i);
-                        writemem(addr + y, a);
+                        writemem_fast(addr + y, a);
                         break;
 
                 case 0x9A:
@@ -2615,8 +2712,8 @@ void m6502_exec()
 
                 case 0x9B:      /*Undocumented - SHS abs,y */
                         addr = getw();
-                        readmem((addr & 0xFF00) + ((addr + y) & 0xFF));
-                        writemem(addr + y, a & x & ((addr >> 8) + 1));
+                        readmem_fast((addr & 0xFF00) + ((addr + y) & 0xFF));
+                        writemem_fast(addr + y, a & x & ((addr >> 8) + 1));
                         s = a & x;
                         polltime(5);
                         takeint = (interrupt && !p.i);
@@ -2624,8 +2721,8 @@ void m6502_exec()
 
                 case 0x9C:      /*Undocumented - SHY abs,x */
                         addr = getw();
-                        readmem((addr & 0xFF00) + ((addr + x) & 0xFF));
-                        writemem(addr + x, y & ((addr >> 8) + 1));
+                        readmem_fast((addr & 0xFF00) + ((addr + x) & 0xFF));
+                        writemem_fast(addr + x, y & ((addr >> 8) + 1));
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
@@ -2633,32 +2730,32 @@ void m6502_exec()
                 case 0x9D:      /*STA abs,x */
                         addr = getw();
                         polltime(4);
-                        readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
+                        readmem_fast((addr & 0xFF00) | ((addr + x) & 0xFF));
                         polltime(1);
                         takeint = (interrupt && !p.i);
-                        writemem(addr + x, a);
+                        writemem_fast(addr + x, a);
                         break;
 
                 case 0x9E:      /*Undocumented - SHX abs,y */
                         addr = getw();
                         polltime(4);
-                        readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
+                        readmem_fast((addr & 0xFF00) | ((addr + x) & 0xFF));
                         polltime(1);
                         takeint = (interrupt && !p.i);
-                        writemem(addr + y, x & ((addr >> 8) + 1));
+                        writemem_fast(addr + y, x & ((addr >> 8) + 1));
                         break;
 
                 case 0x9F:      /*Undocumented - SHA abs,y */
                         addr = getw();
                         polltime(4);
-                        readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
+                        readmem_fast((addr & 0xFF00) | ((addr + x) & 0xFF));
                         polltime(1);
                         takeint = (interrupt && !p.i);
-                        writemem(addr + y, a & x & ((addr >> 8) + 1));
+                        writemem_fast(addr + y, a & x & ((addr >> 8) + 1));
                         break;
 
                 case 0xA0:      /*LDY imm */
-                        y = readmem(pc);
+                        y = readmem_fast(pc);
                         pc++;
                         setzn(y);
                         polltime(2);
@@ -2666,17 +2763,17 @@ void m6502_exec()
                         break;
 
                 case 0xA1:      /*LDA (,x) */
-                        temp = readmem(pc) + x;
+                        temp = readmem_fast(pc) + x;
                         pc++;
                         addr = read_zp_indirect(temp);
-                        a = readmem(addr);
+                        a = readmem_fast(addr);
                         setzn(a);
                         polltime(6);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xA2:      /*LDX imm */
-                        x = readmem(pc);
+                        x = readmem_fast(pc);
                         pc++;
                         setzn(x);
                         polltime(2);
@@ -2684,46 +2781,46 @@ void m6502_exec()
                         break;
 
                 case 0xA3:      /*Undocumented - LAX (,y) */
-                        temp = readmem(pc) + x;
+                        temp = readmem_fast(pc) + x;
                         pc++;
                         addr = read_zp_indirect(temp);
-                        a = x = readmem(addr);
+                        a = x = readmem_fast(addr);
                         setzn(a);
                         polltime(6);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xA4:      /*LDY zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        y = readmem(addr);
+                        y = readmem_fast(addr);
                         setzn(y);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xA5:      /*LDA zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        a = readmem(addr);
+                        a = readmem_fast(addr);
                         setzn(a);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xA6:      /*LDX zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        x = readmem(addr);
+                        x = readmem_fast(addr);
                         setzn(x);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xA7:      /*Undocumented - LAX zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        a = x = readmem(addr);
+                        a = x = readmem_fast(addr);
                         setzn(a);
                         polltime(3);
                         takeint = (interrupt && !p.i);
@@ -2737,7 +2834,7 @@ void m6502_exec()
                         break;
 
                 case 0xA9:      /*LDA imm */
-                        a = readmem(pc);
+                        a = readmem_fast(pc);
                         pc++;
                         setzn(a);
                         polltime(1);
@@ -2753,7 +2850,7 @@ void m6502_exec()
                         break;
 
                 case 0xAB:      /*Undocumented - LAX */
-                        temp = readmem(pc);
+                        temp = readmem_fast(pc);
                         pc++;
                         a = x = ((a | 0xEE) & temp);    /*WAAAAY more complicated than this, but it varies from machine to machine anyway */
                         setzn(a);
@@ -2765,7 +2862,7 @@ void m6502_exec()
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        y = readmem(addr);
+                        y = readmem_fast(addr);
                         setzn(y);
                         break;
 
@@ -2773,7 +2870,7 @@ void m6502_exec()
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        a = readmem(addr);
+                        a = readmem_fast(addr);
                         setzn(a);
                         break;
 
@@ -2781,7 +2878,7 @@ void m6502_exec()
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        x = readmem(addr);
+                        x = readmem_fast(addr);
                         setzn(x);
                         break;
 
@@ -2789,12 +2886,12 @@ void m6502_exec()
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        a = x = readmem(addr);
+                        a = x = readmem_fast(addr);
                         setzn(a);
                         break;
 
                 case 0xB0:
-                        /*BCS*/ offset = (int8_t) readmem(pc);
+                        /*BCS*/ offset = (int8_t) readmem_fast(pc);
                         pc++;
                         temp = 2;
                         if (p.c) {
@@ -2807,60 +2904,60 @@ void m6502_exec()
                         break;
 
                 case 0xB1:      /*LDA (),y */
-                        temp = readmem(pc);
+                        temp = readmem_fast(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        a = readmem(addr + y);
+                        a = readmem_fast(addr + y);
                         setzn(a);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xB3:      /*LAX (),y */
-                        temp = readmem(pc);
+                        temp = readmem_fast(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        a = x = readmem(addr + y);
+                        a = x = readmem_fast(addr + y);
                         setzn(a);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xB4:      /*LDY zp,x */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        y = readmem((addr + x) & 0xFF);
+                        y = readmem_fast((addr + x) & 0xFF);
                         setzn(y);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xB5:      /*LDA zp,x */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        a = readmem((addr + x) & 0xFF);
+                        a = readmem_fast((addr + x) & 0xFF);
                         setzn(a);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xB6:      /*LDX zp,y */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        x = readmem((addr + y) & 0xFF);
+                        x = readmem_fast((addr + y) & 0xFF);
                         setzn(x);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xB7:      /*LAX zp,y */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        a = x = readmem((addr + y) & 0xFF);
+                        a = x = readmem_fast((addr + y) & 0xFF);
                         setzn(a);
                         polltime(3);
                         takeint = (interrupt && !p.i);
@@ -2877,7 +2974,7 @@ void m6502_exec()
                         polltime(3);
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        a = readmem(addr + y);
+                        a = readmem_fast(addr + y);
                         setzn(a);
                         polltime(1);
                         takeint = (interrupt && !p.i);
@@ -2895,7 +2992,7 @@ void m6502_exec()
                         polltime(3);
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        a = x = s = s & readmem(addr + y);      /*No, really! */
+                        a = x = s = s & readmem_fast(addr + y);      /*No, really! */
                         setzn(a);
                         polltime(1);
                         takeint = (interrupt && !p.i);
@@ -2905,7 +3002,7 @@ void m6502_exec()
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + x) & 0xFF00))
                                 polltime(1);
-                        y = readmem(addr + x);
+                        y = readmem_fast(addr + x);
                         setzn(y);
                         polltime(4);
                         takeint = (interrupt && !p.i);
@@ -2915,7 +3012,7 @@ void m6502_exec()
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + x) & 0xFF00))
                                 polltime(1);
-                        a = readmem(addr + x);
+                        a = readmem_fast(addr + x);
                         setzn(a);
                         polltime(4);
                         takeint = (interrupt && !p.i);
@@ -2925,7 +3022,7 @@ void m6502_exec()
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        x = readmem(addr + y);
+                        x = readmem_fast(addr + y);
                         setzn(x);
                         polltime(4);
                         takeint = (interrupt && !p.i);
@@ -2935,14 +3032,14 @@ void m6502_exec()
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        a = x = readmem(addr + y);
+                        a = x = readmem_fast(addr + y);
                         setzn(a);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xC0:      /*CPY imm */
-                        temp = readmem(pc);
+                        temp = readmem_fast(pc);
                         pc++;
                         setzn(y - temp);
                         p.c = (y >= temp);
@@ -2951,10 +3048,10 @@ void m6502_exec()
                         break;
 
                 case 0xC1:      /*CMP (,x) */
-                        temp = readmem(pc) + x;
+                        temp = readmem_fast(pc) + x;
                         pc++;
                         addr = read_zp_indirect(temp);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         setzn(a - temp);
                         p.c = (a >= temp);
                         polltime(6);
@@ -2962,32 +3059,32 @@ void m6502_exec()
                         break;
 
                 case 0xC2:      /*Undocumented - NOP imm *//*Should sometimes lock up the machine */
-                        readmem(pc);
+                        readmem_fast(pc);
                         pc++;
                         polltime(2);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xC3:      /*Undocumented - DCP (,x) */
-                        temp = readmem(pc) + x;
+                        temp = readmem_fast(pc) + x;
                         pc++;
                         addr = read_zp_indirect(temp);
                         polltime(5);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         temp--;
                         polltime(1);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         setzn(a - temp);
                         p.c = (a >= temp);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xC4:      /*CPY zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         setzn(y - temp);
                         p.c = (y >= temp);
                         polltime(3);
@@ -2995,9 +3092,9 @@ void m6502_exec()
                         break;
 
                 case 0xC5:      /*CMP zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         setzn(a - temp);
                         p.c = (a >= temp);
                         polltime(3);
@@ -3005,20 +3102,20 @@ void m6502_exec()
                         break;
 
                 case 0xC6:      /*DEC zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        temp = readmem(addr) - 1;
-                        writemem(addr, temp);
+                        temp = readmem_fast(addr) - 1;
+                        writemem_fast(addr, temp);
                         setzn(temp);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xC7:      /*Undocumented - DCP zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        temp = readmem(addr) - 1;
-                        writemem(addr, temp);
+                        temp = readmem_fast(addr) - 1;
+                        writemem_fast(addr, temp);
                         setzn(a - temp);
                         p.c = (a >= temp);
                         polltime(5);
@@ -3033,7 +3130,7 @@ void m6502_exec()
                         break;
 
                 case 0xC9:      /*CMP imm */
-                        temp = readmem(pc);
+                        temp = readmem_fast(pc);
                         pc++;
                         setzn(a - temp);
                         p.c = (a >= temp);
@@ -3049,7 +3146,7 @@ void m6502_exec()
                         break;
 
                 case 0xCB:      /*Undocumented - SBX imm */
-                        temp = readmem(pc);
+                        temp = readmem_fast(pc);
                         pc++;
                         setzn((a & x) - temp);
                         p.c = ((a & x) >= temp);
@@ -3062,7 +3159,7 @@ void m6502_exec()
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         setzn(y - temp);
                         p.c = (y >= temp);
                         break;
@@ -3071,7 +3168,7 @@ void m6502_exec()
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         setzn(a - temp);
                         p.c = (a >= temp);
                         break;
@@ -3079,22 +3176,22 @@ void m6502_exec()
                 case 0xCE:      /*DEC abs */
                         addr = getw();
                         polltime(4);
-                        temp = readmem(addr) - 1;
+                        temp = readmem_fast(addr) - 1;
                         polltime(1);
 //                                takeint=(interrupt && !p.i);
-                        writemem(addr, temp + 1);
+                        writemem_fast(addr, temp + 1);
                         takeint = ((interrupt & 128) && !p.i);  // takeint=1;
                         polltime(1);
                         if (!takeint)
                                 takeint = (interrupt && !p.i);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         setzn(temp);
                         break;
 
                 case 0xCF:      /*Undocumented - DCP abs */
                         addr = getw();
-                        temp = readmem(addr) - 1;
-                        writemem(addr, temp);
+                        temp = readmem_fast(addr) - 1;
+                        writemem_fast(addr, temp);
                         setzn(a - temp);
                         p.c = (a >= temp);
                         polltime(6);
@@ -3102,7 +3199,7 @@ void m6502_exec()
                         break;
 
                 case 0xD0:
-                        /*BNE*/ offset = (int8_t) readmem(pc);
+                        /*BNE*/ offset = (int8_t) readmem_fast(pc);
                         pc++;
                         temp = 2;
                         if (!p.z) {
@@ -3115,12 +3212,12 @@ void m6502_exec()
                         break;
 
                 case 0xD1:      /*CMP (),y */
-                        temp = readmem(pc);
+                        temp = readmem_fast(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        temp = readmem(addr + y);
+                        temp = readmem_fast(addr + y);
                         setzn(a - temp);
                         p.c = (a >= temp);
                         polltime(5);
@@ -3128,34 +3225,34 @@ void m6502_exec()
                         break;
 
                 case 0xD3:      /*Undocumented - DCP (),y */
-                        temp = readmem(pc);
+                        temp = readmem_fast(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
                         polltime(5);
-                        temp = readmem(addr) - 1;
+                        temp = readmem_fast(addr) - 1;
                         polltime(1);
-                        writemem(addr, temp + 1);
+                        writemem_fast(addr, temp + 1);
                         polltime(1);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         setzn(a - temp);
                         p.c = (a >= temp);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xD4:      /*Undocumented - NOP zp,x */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        readmem((addr + x) & 0xFF);
+                        readmem_fast((addr + x) & 0xFF);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xD5:      /*CMP zp,x */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        temp = readmem((addr + x) & 0xFF);
+                        temp = readmem_fast((addr + x) & 0xFF);
                         setzn(a - temp);
                         p.c = (a >= temp);
                         polltime(3);
@@ -3163,20 +3260,20 @@ void m6502_exec()
                         break;
 
                 case 0xD6:      /*DEC zp,x */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        temp = readmem((addr + x) & 0xFF) - 1;
+                        temp = readmem_fast((addr + x) & 0xFF) - 1;
                         setzn(temp);
-                        writemem((addr + x) & 0xFF, temp);
+                        writemem_fast((addr + x) & 0xFF, temp);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xD7:      /*Undocumented - DCP zp,x */
-                        addr = (readmem(pc) + x) & 0xFF;
+                        addr = (readmem_fast(pc) + x) & 0xFF;
                         pc++;
-                        temp = readmem(addr) - 1;
-                        writemem(addr, temp);
+                        temp = readmem_fast(addr) - 1;
+                        writemem_fast(addr, temp);
                         setzn(a - temp);
                         p.c = (a >= temp);
                         polltime(5);
@@ -3193,7 +3290,7 @@ void m6502_exec()
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        temp = readmem(addr + y);
+                        temp = readmem_fast(addr + y);
                         setzn(a - temp);
                         p.c = (a >= temp);
                         polltime(4);
@@ -3210,11 +3307,11 @@ void m6502_exec()
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
                         polltime(4);
-                        temp = readmem(addr + y) - 1;
+                        temp = readmem_fast(addr + y) - 1;
                         polltime(1);
-                        writemem(addr + y, temp + 1);
+                        writemem_fast(addr + y, temp + 1);
                         polltime(1);
-                        writemem(addr + y, temp);
+                        writemem_fast(addr + y, temp);
                         setzn(a - temp);
                         p.c = (a >= temp);
                         takeint = (interrupt && !p.i);
@@ -3224,7 +3321,7 @@ void m6502_exec()
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + x) & 0xFF00))
                                 polltime(1);
-                        readmem(addr + x);
+                        readmem_fast(addr + x);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
@@ -3233,7 +3330,7 @@ void m6502_exec()
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + x) & 0xFF00))
                                 polltime(1);
-                        temp = readmem(addr + x);
+                        temp = readmem_fast(addr + x);
                         setzn(a - temp);
                         p.c = (a >= temp);
                         polltime(4);
@@ -3242,11 +3339,11 @@ void m6502_exec()
 
                 case 0xDE:      /*DEC abs,x */
                         addr = getw();
-                        readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
+                        readmem_fast((addr & 0xFF00) | ((addr + x) & 0xFF));
                         addr += x;
-                        temp = readmem(addr) - 1;
-                        writemem(addr, temp + 1);
-                        writemem(addr, temp);
+                        temp = readmem_fast(addr) - 1;
+                        writemem_fast(addr, temp + 1);
+                        writemem_fast(addr, temp);
                         setzn(temp);
                         polltime(7);
                         takeint = (interrupt && !p.i);
@@ -3257,18 +3354,18 @@ void m6502_exec()
                         if ((addr & 0xFF00) ^ ((addr + x) & 0xFF00))
                                 polltime(1);
                         polltime(4);
-                        temp = readmem(addr + x) - 1;
+                        temp = readmem_fast(addr + x) - 1;
                         polltime(1);
-                        writemem(addr + x, temp + 1);
+                        writemem_fast(addr + x, temp + 1);
                         polltime(1);
-                        writemem(addr + x, temp);
+                        writemem_fast(addr + x, temp);
                         setzn(a - temp);
                         p.c = (a >= temp);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xE0:      /*CPX imm */
-                        temp = readmem(pc);
+                        temp = readmem_fast(pc);
                         pc++;
                         setzn(x - temp);
                         p.c = (x >= temp);
@@ -3277,41 +3374,41 @@ void m6502_exec()
                         break;
 
                 case 0xE1:      /*SBC (,x) *//*This was missed out of every B-em version since 0.6 as it was never used! */
-                        temp = readmem(pc) + x;
+                        temp = readmem_fast(pc) + x;
                         pc++;
                         addr = read_zp_indirect(temp);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         sbc_nmos(temp);
                         polltime(6);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xE2:      /*Undocumented - NOP imm *//*Should sometimes lock up the machine */
-                        readmem(pc);
+                        readmem_fast(pc);
                         pc++;
                         polltime(2);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xE3:      /*Undocumented - ISB (,x) */
-                        temp = readmem(pc) + x;
+                        temp = readmem_fast(pc) + x;
                         pc++;
                         addr = read_zp_indirect(temp);
                         polltime(5);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         temp++;
                         polltime(1);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         sbc_nmos(temp);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xE4:      /*CPX zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         setzn(x - temp);
                         p.c = (x >= temp);
                         polltime(3);
@@ -3319,34 +3416,34 @@ void m6502_exec()
                         break;
 
                 case 0xE5:      /*SBC zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         sbc_nmos(temp);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xE6:      /*INC zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        temp = readmem(addr) + 1;
-                        writemem(addr, temp);
+                        temp = readmem_fast(addr) + 1;
+                        writemem_fast(addr, temp);
                         setzn(temp);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xE7:      /*Undocumented - ISB zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
                         polltime(3);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         temp++;
                         polltime(1);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         sbc_nmos(temp);
                         takeint = (interrupt && !p.i);
                         break;
@@ -3359,7 +3456,7 @@ void m6502_exec()
                         break;
 
                 case 0xE9:      /*SBC imm */
-                        temp = readmem(pc);
+                        temp = readmem_fast(pc);
                         pc++;
                         sbc_nmos(temp);
                         polltime(2);
@@ -3372,7 +3469,7 @@ void m6502_exec()
                         break;
 
                 case 0xEB:      /*Undocumented - SBC imm */
-                        temp = readmem(pc);
+                        temp = readmem_fast(pc);
                         pc++;
                         sbc_nmos(temp);
                         polltime(2);
@@ -3383,7 +3480,7 @@ void m6502_exec()
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         setzn(x - temp);
                         p.c = (x >= temp);
                         break;
@@ -3392,40 +3489,40 @@ void m6502_exec()
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         sbc_nmos(temp);
                         break;
 
                 case 0xEE:      /*INC abs */
                         addr = getw();
                         polltime(4);
-                        temp = readmem(addr) + 1;
+                        temp = readmem_fast(addr) + 1;
                         polltime(1);
-                        writemem(addr, temp - 1);
+                        writemem_fast(addr, temp - 1);
                         if ((interrupt & 128) && !p.i)
                                 takeint = 1;
                         polltime(1);
                         if (interrupt && !p.i)
                                 takeint = 1;
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         setzn(temp);
                         break;
 
                 case 0xEF:      /*Undocumented - ISB abs */
                         addr = getw();
                         polltime(4);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         temp++;
                         polltime(1);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         sbc_nmos(temp);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xF0:
-                        /*BEQ*/ offset = (int8_t) readmem(pc);
+                        /*BEQ*/ offset = (int8_t) readmem_fast(pc);
                         pc++;
                         temp = 2;
                         if (p.z) {
@@ -3439,70 +3536,70 @@ void m6502_exec()
                         break;
 
                 case 0xF1:      /*SBC (),y */
-                        temp = readmem(pc);
+                        temp = readmem_fast(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        temp = readmem(addr + y);
+                        temp = readmem_fast(addr + y);
                         sbc_nmos(temp);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xF3:      /*Undocumented - ISB (),y */
-                        temp = readmem(pc);
+                        temp = readmem_fast(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
                         polltime(5);
-                        temp = readmem(addr + y);
+                        temp = readmem_fast(addr + y);
                         polltime(1);
-                        writemem(addr + y, temp);
+                        writemem_fast(addr + y, temp);
                         temp++;
                         polltime(1);
-                        writemem(addr + y, temp);
+                        writemem_fast(addr + y, temp);
                         sbc_nmos(temp);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xF4:      /*Undocumented - NOP zpx */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xF5:      /*SBC zp,x */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        temp = readmem((addr + x) & 0xFF);
+                        temp = readmem_fast((addr + x) & 0xFF);
                         sbc_nmos(temp);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xF6:      /*INC zp,x */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        temp = readmem((addr + x) & 0xFF) + 1;
-                        writemem((addr + x) & 0xFF, temp);
+                        temp = readmem_fast((addr + x) & 0xFF) + 1;
+                        writemem_fast((addr + x) & 0xFF, temp);
                         setzn(temp);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xF7:      /*Undocumented - ISB zp,x */
-                        addr = (readmem(pc) + x) & 0xFF;
+                        addr = (readmem_fast(pc) + x) & 0xFF;
                         pc++;
                         polltime(3);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         temp++;
                         polltime(1);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         sbc_nmos(temp);
                         takeint = (interrupt && !p.i);
                         break;
@@ -3517,7 +3614,7 @@ void m6502_exec()
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        temp = readmem(addr + y);
+                        temp = readmem_fast(addr + y);
                         sbc_nmos(temp);
                         polltime(4);
                         takeint = (interrupt && !p.i);
@@ -3531,12 +3628,12 @@ void m6502_exec()
                 case 0xFB:      /*Undocumented - ISB abs,y */
                         addr = getw() + y;
                         polltime(5);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         temp++;
                         polltime(1);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         sbc_nmos(temp);
                         takeint = (interrupt && !p.i);
                         break;
@@ -3545,7 +3642,7 @@ void m6502_exec()
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + x) & 0xFF00))
                                 polltime(1);
-                        readmem(addr + x);
+                        readmem_fast(addr + x);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
@@ -3554,7 +3651,7 @@ void m6502_exec()
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + x) & 0xFF00))
                                 polltime(1);
-                        temp = readmem(addr + x);
+                        temp = readmem_fast(addr + x);
                         sbc_nmos(temp);
                         polltime(4);
                         takeint = (interrupt && !p.i);
@@ -3562,11 +3659,11 @@ void m6502_exec()
 
                 case 0xFE:      /*INC abs,x */
                         addr = getw();
-                        readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
+                        readmem_fast((addr & 0xFF00) | ((addr + x) & 0xFF));
                         addr += x;
-                        temp = readmem(addr) + 1;
-                        writemem(addr, temp - 1);
-                        writemem(addr, temp);
+                        temp = readmem_fast(addr) + 1;
+                        writemem_fast(addr, temp - 1);
+                        writemem_fast(addr, temp);
                         setzn(temp);
                         polltime(7);
                         takeint = (interrupt && !p.i);
@@ -3575,12 +3672,12 @@ void m6502_exec()
                 case 0xFF:      /*Undocumented - ISB abs,x */
                         addr = getw() + x;
                         polltime(5);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         polltime(1);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         temp++;
                         polltime(1);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         sbc_nmos(temp);
                         takeint = (interrupt && !p.i);
                         break;
@@ -3700,45 +3797,7 @@ void m6502_exec()
                         log_debug("A=%02X X=%02X Y=%02X S=%02X PC=%04X %c%c%c%c%c%c op=%02X %02X%02X\n",a,x,y,s,pc,(p.n)?'N':' ',(p.v)?'V':' ',(p.d)?'D':' ',(p.i)?'I':' ',(p.z)?'Z':' ',(p.c)?'C':' ',opcode,ram[0x29],uservia.ifr);
                 }*/
 //                if (pc==0x400) output=1;
-                if (timetolive) {
-                        timetolive--;
-                        if (!timetolive)
-                                output = 0;
-                }
-                if (takeint) {
-//                        output=1;
-                        interrupt &= ~128;
-                        takeint = 0;
-//                        skipint=0;
-                        push(pc >> 8);
-                        push(pc & 0xFF);
-                        push(pack_flags(0x20));
-                        pc = readmem(0xFFFE) | (readmem(0xFFFF) << 8);
-                        p.i = 1;
-                        polltime(7);
-//                        log_debug("INT\n");
-                }
-                interrupt &= ~128;
-
-                if (otherstuffcount <= 0)
-                    otherstuff_poll();
-                if (tube_exec && tubecycle) {
-                        tubecycles += (tubecycle * tube_multipler) >> 1;
-                        if (tubecycles > 3)
-                                tube_exec();
-                        tubecycle = 0;
-                }
-
-                if (nmi && !oldnmi) {
-                        push(pc >> 8);
-                        push(pc & 0xFF);
-                        push(pack_flags(0x20));
-                        pc = readmem(0xFFFA) | (readmem(0xFFFB) << 8);
-                        p.i = 1;
-                        polltime(7);
-                        nmi = 0;
-//                        printf("NMI\n");
-                }
+                end_instruction(false);
         }
 }
 
@@ -3749,7 +3808,7 @@ void m65c02_exec()
         uint16_t tempw;
         int tempi;
         int8_t offset;
-        cycles += 40000;
+        cycles += m6502_slice;
 //        log_debug("PC = %04X\n",pc);
 //        log_debug("Exec cycles %i\n",cycles);
         while (cycles > 0) {
@@ -3762,7 +3821,7 @@ void m65c02_exec()
                         push(pc >> 8);
                         push(pc & 0xFF);
                         push(pack_flags(0x30));
-                        pc = readmem(0xFFFE) | (readmem(0xFFFF) << 8);
+                        pc = readmem_fast(0xFFFE) | (readmem_fast(0xFFFF) << 8);
                         p.i = 1;
                         p.d = 0;
                         polltime(7);
@@ -3770,42 +3829,42 @@ void m65c02_exec()
                         break;
 
                 case 0x01:      /*ORA (,x) */
-                        temp = readmem(pc) + x;
+                        temp = readmem_fast(pc) + x;
                         pc++;
                         addr = read_zp_indirect(temp);
                         polltime(6);
                         takeint = (interrupt && !p.i);
-                        a |= readmem(addr);
+                        a |= readmem_fast(addr);
                         setzn(a);
                         break;
 
                 case 0x04:      /*TSB zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         p.z = !(temp & a);
                         temp |= a;
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         polltime(5);
                         break;
 
                 case 0x05:      /*ORA zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        a |= readmem(addr);
+                        a |= readmem_fast(addr);
                         setzn(a);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x06:      /*ASL zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         p.c = temp & 0x80;
                         temp <<= 1;
                         setzn(temp);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
@@ -3819,7 +3878,7 @@ void m65c02_exec()
                         break;
 
                 case 0x09:      /*ORA imm */
-                        a |= readmem(pc);
+                        a |= readmem_fast(pc);
                         pc++;
                         setzn(a);
                         polltime(2);
@@ -3836,10 +3895,10 @@ void m65c02_exec()
 
                 case 0x0C:      /*TSB abs */
                         addr = getw();
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         p.z = !(temp & a);
                         temp |= a;
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         polltime(6);
                         break;
 
@@ -3847,26 +3906,26 @@ void m65c02_exec()
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        a |= readmem(addr);
+                        a |= readmem_fast(addr);
                         setzn(a);
                         break;
 
                 case 0x0E:      /*ASL abs */
                         addr = getw();
                         polltime(4);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         polltime(1);
-                        readmem(addr);
+                        readmem_fast(addr);
                         polltime(1);
                         p.c = temp & 0x80;
                         temp <<= 1;
                         setzn(temp);
                         takeint = (interrupt && !p.i);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         break;
 
                 case 0x10:
-                        /*BPL*/ offset = (int8_t) readmem(pc);
+                        /*BPL*/ offset = (int8_t) readmem_fast(pc);
                         pc++;
                         temp = 2;
                         if (!p.n) {
@@ -3879,53 +3938,53 @@ void m65c02_exec()
                         break;
 
                 case 0x11:      /*ORA (),y */
-                        temp = readmem(pc);
+                        temp = readmem_fast(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        a |= readmem(addr + y);
+                        a |= readmem_fast(addr + y);
                         setzn(a);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x12:      /*ORA () */
-                        temp = readmem(pc);
+                        temp = readmem_fast(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
-                        a |= readmem(addr);
+                        a |= readmem_fast(addr);
                         setzn(a);
                         polltime(5);
                         break;
 
                 case 0x14:      /*TRB zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         p.z = !(temp & a);
                         temp &= ~a;
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         polltime(5);
                         break;
 
                 case 0x15:      /*ORA zp,x */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        a |= readmem((addr + x) & 0xFF);
+                        a |= readmem_fast((addr + x) & 0xFF);
                         setzn(a);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x16:      /*ASL zp,x */
-                        addr = (readmem(pc) + x) & 0xFF;
+                        addr = (readmem_fast(pc) + x) & 0xFF;
                         pc++;
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         p.c = temp & 0x80;
                         temp <<= 1;
                         setzn(temp);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
@@ -3940,7 +3999,7 @@ void m65c02_exec()
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        a |= readmem(addr + y);
+                        a |= readmem_fast(addr + y);
                         setzn(a);
                         polltime(4);
                         takeint = (interrupt && !p.i);
@@ -3954,10 +4013,10 @@ void m65c02_exec()
 
                 case 0x1C:      /*TRB abs */
                         addr = getw();
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         p.z = !(temp & a);
                         temp &= ~a;
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         polltime(6);
                         break;
 
@@ -3968,22 +4027,22 @@ void m65c02_exec()
                         addr += x;
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        a |= readmem(addr);
+                        a |= readmem_fast(addr);
                         setzn(a);
                         break;
 
                 case 0x1E:      /*ASL abs,x */
                         addr = getw();
-                        readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
+                        readmem_fast((addr & 0xFF00) | ((addr + x) & 0xFF));
                         tempw =
                             ((addr & 0xFF00) ^ ((addr + x) & 0xFF00)) ? 1 : 0;
                         addr += x;
-                        temp = readmem(addr);
-                        readmem(addr);
+                        temp = readmem_fast(addr);
+                        readmem_fast(addr);
                         p.c = temp & 0x80;
                         temp <<= 1;
                         takeint = (interrupt && !p.i);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         setzn(temp);
                         polltime(6 + tempw);
                         break;
@@ -4000,19 +4059,19 @@ void m65c02_exec()
                         break;
 
                 case 0x21:      /*AND (,x) */
-                        temp = readmem(pc) + x;
+                        temp = readmem_fast(pc) + x;
                         pc++;
                         addr = read_zp_indirect(temp);
-                        a &= readmem(addr);
+                        a &= readmem_fast(addr);
                         setzn(a);
                         polltime(6);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x24:      /*BIT zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         p.z = !(a & temp);
                         p.v = temp & 0x40;
                         p.n = temp & 0x80;
@@ -4021,25 +4080,25 @@ void m65c02_exec()
                         break;
 
                 case 0x25:      /*AND zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        a &= readmem(addr);
+                        a &= readmem_fast(addr);
                         setzn(a);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x26:      /*ROL zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         tempi = p.c;
                         p.c = temp & 0x80;
                         temp <<= 1;
                         if (tempi)
                                 temp |= 1;
                         setzn(temp);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
@@ -4052,7 +4111,7 @@ void m65c02_exec()
                         break;
 
                 case 0x29:
-                        /*AND*/ a &= readmem(pc);
+                        /*AND*/ a &= readmem_fast(pc);
                         pc++;
                         setzn(a);
                         polltime(2);
@@ -4075,7 +4134,7 @@ void m65c02_exec()
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         polltime(1);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         p.z = !(a & temp);
                         p.v = temp & 0x40;
                         p.n = temp & 0x80;
@@ -4085,16 +4144,16 @@ void m65c02_exec()
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        a &= readmem(addr);
+                        a &= readmem_fast(addr);
                         setzn(a);
                         break;
 
                 case 0x2E:      /*ROL abs */
                         addr = getw();
                         polltime(4);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         polltime(1);
-                        readmem(addr);
+                        readmem_fast(addr);
                         tempi = p.c;
                         p.c = temp & 0x80;
                         temp <<= 1;
@@ -4102,12 +4161,12 @@ void m65c02_exec()
                                 temp |= 1;
                         polltime(1);
                         takeint = (interrupt && !p.i);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         setzn(temp);
                         break;
 
                 case 0x30:
-                        /*BMI*/ offset = (int8_t) readmem(pc);
+                        /*BMI*/ offset = (int8_t) readmem_fast(pc);
                         pc++;
                         temp = 2;
                         if (p.n) {
@@ -4120,30 +4179,30 @@ void m65c02_exec()
                         break;
 
                 case 0x31:      /*AND (),y */
-                        temp = readmem(pc);
+                        temp = readmem_fast(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        a &= readmem(addr + y);
+                        a &= readmem_fast(addr + y);
                         setzn(a);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x32:      /*AND () */
-                        temp = readmem(pc);
+                        temp = readmem_fast(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
-                        a &= readmem(addr);
+                        a &= readmem_fast(addr);
                         setzn(a);
                         polltime(5);
                         break;
 
                 case 0x34:      /*BIT zp,x */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        temp = readmem((addr + x) & 0xFF);
+                        temp = readmem_fast((addr + x) & 0xFF);
                         p.z = !(a & temp);
                         p.v = temp & 0x40;
                         p.n = temp & 0x80;
@@ -4151,27 +4210,27 @@ void m65c02_exec()
                         break;
 
                 case 0x35:      /*AND zp,x */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        a &= readmem((addr + x) & 0xFF);
+                        a &= readmem_fast((addr + x) & 0xFF);
                         setzn(a);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x36:      /*ROL zp,x */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
                         addr += x;
                         addr &= 0xFF;
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         tempi = p.c;
                         p.c = temp & 0x80;
                         temp <<= 1;
                         if (tempi)
                                 temp |= 1;
                         setzn(temp);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
@@ -4186,7 +4245,7 @@ void m65c02_exec()
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        a &= readmem(addr + y);
+                        a &= readmem_fast(addr + y);
                         setzn(a);
                         polltime(4);
                         takeint = (interrupt && !p.i);
@@ -4201,7 +4260,7 @@ void m65c02_exec()
                 case 0x3C:      /*BIT abs,x */
                         addr = getw();
                         addr += x;
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         p.z = !(a & temp);
                         p.v = temp & 0x40;
                         p.n = temp & 0x80;
@@ -4213,7 +4272,7 @@ void m65c02_exec()
                         if ((addr & 0xFF00) ^ ((addr + x) & 0xFF00))
                                 polltime(1);
                         addr += x;
-                        a &= readmem(addr);
+                        a &= readmem_fast(addr);
                         setzn(a);
                         polltime(4);
                         takeint = (interrupt && !p.i);
@@ -4221,18 +4280,18 @@ void m65c02_exec()
 
                 case 0x3E:      /*ROL abs,x */
                         addr = getw();
-                        readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
+                        readmem_fast((addr & 0xFF00) | ((addr + x) & 0xFF));
                         tempw =
                             ((addr & 0xFF00) ^ ((addr + x) & 0xFF00)) ? 1 : 0;
                         addr += x;
-                        temp = readmem(addr);
-                        readmem(addr);
+                        temp = readmem_fast(addr);
+                        readmem_fast(addr);
                         tempi = p.c;
                         p.c = temp & 0x80;
                         temp <<= 1;
                         if (tempi)
                                 temp |= 1;
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         setzn(temp);
                         polltime(6 + tempw);
                         takeint = (interrupt && !p.i);
@@ -4248,32 +4307,32 @@ void m65c02_exec()
                         break;
 
                 case 0x41:      /*EOR (,x) */
-                        temp = readmem(pc) + x;
+                        temp = readmem_fast(pc) + x;
                         pc++;
                         addr = read_zp_indirect(temp);
-                        a ^= readmem(addr);
+                        a ^= readmem_fast(addr);
                         setzn(a);
                         polltime(6);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x45:      /*EOR zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        a ^= readmem(addr);
+                        a ^= readmem_fast(addr);
                         setzn(a);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x46:      /*LSR zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         p.c = temp & 1;
                         temp >>= 1;
                         setzn(temp);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
@@ -4285,7 +4344,7 @@ void m65c02_exec()
                         break;
 
                 case 0x49:      /*EOR imm */
-                        a ^= readmem(pc);
+                        a ^= readmem_fast(pc);
                         pc++;
                         setzn(a);
                         polltime(2);
@@ -4311,26 +4370,26 @@ void m65c02_exec()
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        a ^= readmem(addr);
+                        a ^= readmem_fast(addr);
                         setzn(a);
                         break;
 
                 case 0x4E:      /*LSR abs */
                         addr = getw();
                         polltime(4);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         polltime(1);
-                        readmem(addr);
+                        readmem_fast(addr);
                         polltime(1);
                         p.c = temp & 1;
                         temp >>= 1;
                         setzn(temp);
                         takeint = (interrupt && !p.i);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         break;
 
                 case 0x50:
-                        /*BVC*/ offset = (int8_t) readmem(pc);
+                        /*BVC*/ offset = (int8_t) readmem_fast(pc);
                         pc++;
                         temp = 2;
                         if (!p.v) {
@@ -4343,43 +4402,43 @@ void m65c02_exec()
                         break;
 
                 case 0x51:      /*EOR (),y */
-                        temp = readmem(pc);
+                        temp = readmem_fast(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        a ^= readmem(addr + y);
+                        a ^= readmem_fast(addr + y);
                         setzn(a);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x52:      /*EOR () */
-                        temp = readmem(pc);
+                        temp = readmem_fast(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
-                        a ^= readmem(addr);
+                        a ^= readmem_fast(addr);
                         setzn(a);
                         polltime(5);
                         break;
 
                 case 0x55:      /*EOR zp,x */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        a ^= readmem((addr + x) & 0xFF);
+                        a ^= readmem_fast((addr + x) & 0xFF);
                         setzn(a);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x56:      /*LSR zp,x */
-                        addr = (readmem(pc) + x) & 0xFF;
+                        addr = (readmem_fast(pc) + x) & 0xFF;
                         pc++;
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         p.c = temp & 1;
                         temp >>= 1;
                         setzn(temp);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
@@ -4394,7 +4453,7 @@ void m65c02_exec()
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        a ^= readmem(addr + y);
+                        a ^= readmem_fast(addr + y);
                         setzn(a);
                         polltime(4);
                         takeint = (interrupt && !p.i);
@@ -4409,26 +4468,26 @@ void m65c02_exec()
                         addr = getw();
                         polltime(4);
                         if ((addr & 0xFF00) ^ ((addr + x) & 0xFF00)) {
-                                readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
+                                readmem_fast((addr & 0xFF00) | ((addr + x) & 0xFF));
                                 polltime(1);
                         }
                         addr += x;
-                        a ^= readmem(addr);
+                        a ^= readmem_fast(addr);
                         setzn(a);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x5E:      /*LSR abs,x */
                         addr = getw();
-                        readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
+                        readmem_fast((addr & 0xFF00) | ((addr + x) & 0xFF));
                         tempw =
                             ((addr & 0xFF00) ^ ((addr + x) & 0xFF00)) ? 1 : 0;
                         addr += x;
-                        temp = readmem(addr);
-                        readmem(addr);
+                        temp = readmem_fast(addr);
+                        readmem_fast(addr);
                         p.c = temp & 1;
                         temp >>= 1;
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         setzn(temp);
                         polltime(6 + tempw);
                         takeint = (interrupt && !p.i);
@@ -4444,42 +4503,42 @@ void m65c02_exec()
                         break;
 
                 case 0x61:      /*ADC (,x) */
-                        temp = readmem(pc) + x;
+                        temp = readmem_fast(pc) + x;
                         pc++;
                         addr = read_zp_indirect(temp);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         adc_cmos(temp);
                         polltime(6);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x64:      /*STZ zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        writemem(addr, 0);
+                        writemem_fast(addr, 0);
                         polltime(3);
                         break;
 
                 case 0x65:      /*ADC zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         adc_cmos(temp);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x66:      /*ROR zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         tempi = p.c;
                         p.c = temp & 1;
                         temp >>= 1;
                         if (tempi)
                                 temp |= 0x80;
                         setzn(temp);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
@@ -4492,7 +4551,7 @@ void m65c02_exec()
                         break;
 
                 case 0x69:      /*ADC imm */
-                        temp = readmem(pc);
+                        temp = readmem_fast(pc);
                         pc++;
                         adc_cmos(temp);
                         polltime(2);
@@ -4512,7 +4571,7 @@ void m65c02_exec()
 
                 case 0x6C:      /*JMP () */
                         addr = getw();
-                        pc = readmem(addr) | (readmem(addr + 1) << 8);
+                        pc = readmem_fast(addr) | (readmem_fast(addr + 1) << 8);
                         polltime(6);
                         takeint = (interrupt && !p.i);
                         break;
@@ -4521,17 +4580,17 @@ void m65c02_exec()
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         adc_cmos(temp);
                         break;
 
                 case 0x6E:      /*ROR abs */
                         addr = getw();
                         polltime(4);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         polltime(1);
                         takeint = (interrupt && !p.i);
-                        readmem(addr);
+                        readmem_fast(addr);
                         if ((interrupt & 128) && !p.i)
                                 takeint = 1;
                         polltime(1);
@@ -4543,11 +4602,11 @@ void m65c02_exec()
                         if (tempi)
                                 temp |= 0x80;
                         setzn(temp);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         break;
 
                 case 0x70:
-                        /*BVS*/ offset = (int8_t) readmem(pc);
+                        /*BVS*/ offset = (int8_t) readmem_fast(pc);
                         pc++;
                         temp = 2;
                         if (p.v) {
@@ -4560,55 +4619,55 @@ void m65c02_exec()
                         break;
 
                 case 0x71:      /*ADC (),y */
-                        temp = readmem(pc);
+                        temp = readmem_fast(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        temp = readmem(addr + y);
+                        temp = readmem_fast(addr + y);
                         adc_cmos(temp);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x72:      /*ADC () */
-                        temp = readmem(pc);
+                        temp = readmem_fast(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         adc_cmos(temp);
                         polltime(5);
                         break;
 
                 case 0x74:      /*STZ zp,x */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        writemem((addr + x) & 0xFF, 0);
+                        writemem_fast((addr + x) & 0xFF, 0);
                         polltime(3);
                         break;
 
                 case 0x75:      /*ADC zp,x */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        temp = readmem((addr + x) & 0xFF);
+                        temp = readmem_fast((addr + x) & 0xFF);
                         adc_cmos(temp);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x76:      /*ROR zp,x */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
                         addr += x;
                         addr &= 0xFF;
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         tempi = p.c;
                         p.c = temp & 1;
                         temp >>= 1;
                         if (tempi)
                                 temp |= 0x80;
                         setzn(temp);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
@@ -4623,7 +4682,7 @@ void m65c02_exec()
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        temp = readmem(addr + y);
+                        temp = readmem_fast(addr + y);
                         adc_cmos(temp);
                         polltime(4);
                         takeint = (interrupt && !p.i);
@@ -4638,7 +4697,7 @@ void m65c02_exec()
                 case 0x7C:      /*JMP (,x) */
                         addr = getw();
                         addr += x;
-                        pc = readmem(addr) | (readmem(addr + 1) << 8);
+                        pc = readmem_fast(addr) | (readmem_fast(addr + 1) << 8);
                         polltime(6);
                         break;
 
@@ -4647,7 +4706,7 @@ void m65c02_exec()
                         if ((addr & 0xFF00) ^ ((addr + x) & 0xFF00))
                                 polltime(1);
                         addr += x;
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         adc_cmos(temp);
                         polltime(4);
                         takeint = (interrupt && !p.i);
@@ -4655,25 +4714,25 @@ void m65c02_exec()
 
                 case 0x7E:      /*ROR abs,x */
                         addr = getw();
-                        readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
+                        readmem_fast((addr & 0xFF00) | ((addr + x) & 0xFF));
                         tempw =
                             ((addr & 0xFF00) ^ ((addr + x) & 0xFF00)) ? 1 : 0;
                         addr += x;
-                        temp = readmem(addr);
-                        readmem(addr);
+                        temp = readmem_fast(addr);
+                        readmem_fast(addr);
                         tempi = p.c;
                         p.c = temp & 1;
                         temp >>= 1;
                         if (tempi)
                                 temp |= 0x80;
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         setzn(temp);
                         polltime(6 + tempw);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x80:
-                        /*BRA*/ offset = (int8_t) readmem(pc);
+                        /*BRA*/ offset = (int8_t) readmem_fast(pc);
                         pc++;
                         temp = 3;
                         if ((pc & 0xFF00) ^ ((pc + offset) & 0xFF00))
@@ -4683,34 +4742,34 @@ void m65c02_exec()
                         break;
 
                 case 0x81:      /*STA (,x) */
-                        temp = readmem(pc) + x;
+                        temp = readmem_fast(pc) + x;
                         pc++;
                         addr = read_zp_indirect(temp);
-                        writemem(addr, a);
+                        writemem_fast(addr, a);
                         polltime(6);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x84:      /*STY zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        writemem(addr, y);
+                        writemem_fast(addr, y);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x85:      /*STA zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        writemem(addr, a);
+                        writemem_fast(addr, a);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x86:      /*STX zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        writemem(addr, x);
+                        writemem_fast(addr, x);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
@@ -4723,7 +4782,7 @@ void m65c02_exec()
                         break;
 
                 case 0x89:      /*BIT imm */
-                        temp = readmem(pc);
+                        temp = readmem_fast(pc);
                         pc++;
                         p.z = !(a & temp);
                         polltime(2);
@@ -4740,7 +4799,7 @@ void m65c02_exec()
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        writemem(addr, y);
+                        writemem_fast(addr, y);
                         break;
 
                 case 0x8D:      /*STA abs */
@@ -4748,18 +4807,18 @@ void m65c02_exec()
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         polltime(1);
-                        writemem(addr, a);
+                        writemem_fast(addr, a);
                         break;
 
                 case 0x8E:      /*STX abs */
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        writemem(addr, x);
+                        writemem_fast(addr, x);
                         break;
 
                 case 0x90:
-                        /*BCC*/ offset = (int8_t) readmem(pc);
+                        /*BCC*/ offset = (int8_t) readmem_fast(pc);
                         pc++;
                         temp = 2;
                         if (!p.c) {
@@ -4772,42 +4831,42 @@ void m65c02_exec()
                         break;
 
                 case 0x91:      /*STA (),y */
-                        temp = readmem(pc);
+                        temp = readmem_fast(pc);
                         pc++;
                         addr = read_zp_indirect(temp) + y;
-                        writemem(addr, a);
+                        writemem_fast(addr, a);
                         polltime(6);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x92:      /*STA () */
-                        temp = readmem(pc);
+                        temp = readmem_fast(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
-                        writemem(addr, a);
+                        writemem_fast(addr, a);
                         polltime(6);
                         break;
 
                 case 0x94:      /*STY zp,x */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        writemem((addr + x) & 0xFF, y);
+                        writemem_fast((addr + x) & 0xFF, y);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x95:      /*STA zp,x */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        writemem((addr + x) & 0xFF, a);
+                        writemem_fast((addr + x) & 0xFF, a);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0x96:      /*STX zp,y */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        writemem((addr + y) & 0xFF, x);
+                        writemem_fast((addr + y) & 0xFF, x);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
@@ -4822,10 +4881,10 @@ void m65c02_exec()
                 case 0x99:      /*STA abs,y */
                         addr = getw();
                         polltime(4);
-                        readmem((addr & 0xFF00) | ((addr + y) & 0xFF));
+                        readmem_fast((addr & 0xFF00) | ((addr + y) & 0xFF));
                         polltime(1);
                         takeint = (interrupt && !p.i);
-                        writemem(addr + y, a);
+                        writemem_fast(addr + y, a);
                         break;
 
                 case 0x9A:
@@ -4838,28 +4897,28 @@ void m65c02_exec()
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        writemem(addr, 0);
+                        writemem_fast(addr, 0);
                         break;
 
                 case 0x9D:      /*STA abs,x */
                         addr = getw();
                         polltime(4);
-                        readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
+                        readmem_fast((addr & 0xFF00) | ((addr + x) & 0xFF));
                         polltime(1);
                         takeint = (interrupt && !p.i);
-                        writemem(addr + x, a);
+                        writemem_fast(addr + x, a);
                         break;
 
                 case 0x9E:      /*STZ abs,x */
                         addr = getw();
                         addr += x;
                         polltime(4);
-                        writemem(addr, 0);
+                        writemem_fast(addr, 0);
                         polltime(1);
                         break;
 
                 case 0xA0:      /*LDY imm */
-                        y = readmem(pc);
+                        y = readmem_fast(pc);
                         pc++;
                         setzn(y);
                         polltime(2);
@@ -4867,17 +4926,17 @@ void m65c02_exec()
                         break;
 
                 case 0xA1:      /*LDA (,x) */
-                        temp = readmem(pc) + x;
+                        temp = readmem_fast(pc) + x;
                         pc++;
                         addr = read_zp_indirect(temp);
-                        a = readmem(addr);
+                        a = readmem_fast(addr);
                         setzn(a);
                         polltime(6);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xA2:      /*LDX imm */
-                        x = readmem(pc);
+                        x = readmem_fast(pc);
                         pc++;
                         setzn(x);
                         polltime(2);
@@ -4885,27 +4944,27 @@ void m65c02_exec()
                         break;
 
                 case 0xA4:      /*LDY zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        y = readmem(addr);
+                        y = readmem_fast(addr);
                         setzn(y);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xA5:      /*LDA zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        a = readmem(addr);
+                        a = readmem_fast(addr);
                         setzn(a);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xA6:      /*LDX zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        x = readmem(addr);
+                        x = readmem_fast(addr);
                         setzn(x);
                         polltime(3);
                         takeint = (interrupt && !p.i);
@@ -4919,7 +4978,7 @@ void m65c02_exec()
                         break;
 
                 case 0xA9:      /*LDA imm */
-                        a = readmem(pc);
+                        a = readmem_fast(pc);
                         pc++;
                         setzn(a);
                         polltime(1);
@@ -4938,7 +4997,7 @@ void m65c02_exec()
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        y = readmem(addr);
+                        y = readmem_fast(addr);
                         setzn(y);
                         break;
 
@@ -4946,7 +5005,7 @@ void m65c02_exec()
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        a = readmem(addr);
+                        a = readmem_fast(addr);
                         setzn(a);
                         break;
 
@@ -4954,12 +5013,12 @@ void m65c02_exec()
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        x = readmem(addr);
+                        x = readmem_fast(addr);
                         setzn(x);
                         break;
 
                 case 0xB0:
-                        /*BCS*/ offset = (int8_t) readmem(pc);
+                        /*BCS*/ offset = (int8_t) readmem_fast(pc);
                         pc++;
                         temp = 2;
                         if (p.c) {
@@ -4972,48 +5031,48 @@ void m65c02_exec()
                         break;
 
                 case 0xB1:      /*LDA (),y */
-                        temp = readmem(pc);
+                        temp = readmem_fast(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        a = readmem(addr + y);
+                        a = readmem_fast(addr + y);
                         setzn(a);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xB2:      /*LDA () */
-                        temp = readmem(pc);
+                        temp = readmem_fast(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
-                        a = readmem(addr);
+                        a = readmem_fast(addr);
                         setzn(a);
                         polltime(5);
                         break;
 
                 case 0xB4:      /*LDY zp,x */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        y = readmem((addr + x) & 0xFF);
+                        y = readmem_fast((addr + x) & 0xFF);
                         setzn(y);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xB5:      /*LDA zp,x */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        a = readmem((addr + x) & 0xFF);
+                        a = readmem_fast((addr + x) & 0xFF);
                         setzn(a);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xB6:      /*LDX zp,y */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        x = readmem((addr + y) & 0xFF);
+                        x = readmem_fast((addr + y) & 0xFF);
                         setzn(x);
                         polltime(3);
                         takeint = (interrupt && !p.i);
@@ -5030,7 +5089,7 @@ void m65c02_exec()
                         polltime(3);
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        a = readmem(addr + y);
+                        a = readmem_fast(addr + y);
                         setzn(a);
                         polltime(1);
                         takeint = (interrupt && !p.i);
@@ -5047,7 +5106,7 @@ void m65c02_exec()
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + x) & 0xFF00))
                                 polltime(1);
-                        y = readmem(addr + x);
+                        y = readmem_fast(addr + x);
                         setzn(y);
                         polltime(4);
                         takeint = (interrupt && !p.i);
@@ -5057,7 +5116,7 @@ void m65c02_exec()
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + x) & 0xFF00))
                                 polltime(1);
-                        a = readmem(addr + x);
+                        a = readmem_fast(addr + x);
                         setzn(a);
                         polltime(4);
                         takeint = (interrupt && !p.i);
@@ -5067,14 +5126,14 @@ void m65c02_exec()
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        x = readmem(addr + y);
+                        x = readmem_fast(addr + y);
                         setzn(x);
                         polltime(4);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xC0:      /*CPY imm */
-                        temp = readmem(pc);
+                        temp = readmem_fast(pc);
                         pc++;
                         setzn(y - temp);
                         p.c = (y >= temp);
@@ -5083,10 +5142,10 @@ void m65c02_exec()
                         break;
 
                 case 0xC1:      /*CMP (,x) */
-                        temp = readmem(pc) + x;
+                        temp = readmem_fast(pc) + x;
                         pc++;
                         addr = read_zp_indirect(temp);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         setzn(a - temp);
                         p.c = (a >= temp);
                         polltime(6);
@@ -5094,9 +5153,9 @@ void m65c02_exec()
                         break;
 
                 case 0xC4:      /*CPY zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         setzn(y - temp);
                         p.c = (y >= temp);
                         polltime(3);
@@ -5104,9 +5163,9 @@ void m65c02_exec()
                         break;
 
                 case 0xC5:      /*CMP zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         setzn(a - temp);
                         p.c = (a >= temp);
                         polltime(3);
@@ -5114,10 +5173,10 @@ void m65c02_exec()
                         break;
 
                 case 0xC6:      /*DEC zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        temp = readmem(addr) - 1;
-                        writemem(addr, temp);
+                        temp = readmem_fast(addr) - 1;
+                        writemem_fast(addr, temp);
                         setzn(temp);
                         polltime(5);
                         takeint = (interrupt && !p.i);
@@ -5131,7 +5190,7 @@ void m65c02_exec()
                         break;
 
                 case 0xC9:      /*CMP imm */
-                        temp = readmem(pc);
+                        temp = readmem_fast(pc);
                         pc++;
                         setzn(a - temp);
                         p.c = (a >= temp);
@@ -5158,7 +5217,7 @@ void m65c02_exec()
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         setzn(y - temp);
                         p.c = (y >= temp);
                         break;
@@ -5167,7 +5226,7 @@ void m65c02_exec()
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         setzn(a - temp);
                         p.c = (a >= temp);
                         break;
@@ -5175,20 +5234,20 @@ void m65c02_exec()
                 case 0xCE:      /*DEC abs */
                         addr = getw();
                         polltime(4);
-                        temp = readmem(addr) - 1;
+                        temp = readmem_fast(addr) - 1;
                         polltime(1);
 //                                takeint=(interrupt && !p.i);
-                        readmem(addr);
+                        readmem_fast(addr);
                         takeint = ((interrupt & 128) && !p.i);  // takeint=1;
                         polltime(1);
                         if (!takeint)
                                 takeint = (interrupt && !p.i);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         setzn(temp);
                         break;
 
                 case 0xD0:
-                        /*BNE*/ offset = (int8_t) readmem(pc);
+                        /*BNE*/ offset = (int8_t) readmem_fast(pc);
                         pc++;
                         temp = 2;
                         if (!p.z) {
@@ -5201,12 +5260,12 @@ void m65c02_exec()
                         break;
 
                 case 0xD1:      /*CMP (),y */
-                        temp = readmem(pc);
+                        temp = readmem_fast(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        temp = readmem(addr + y);
+                        temp = readmem_fast(addr + y);
                         setzn(a - temp);
                         p.c = (a >= temp);
                         polltime(5);
@@ -5214,19 +5273,19 @@ void m65c02_exec()
                         break;
 
                 case 0xD2:      /*CMP () */
-                        temp = readmem(pc);
+                        temp = readmem_fast(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         setzn(a - temp);
                         p.c = (a >= temp);
                         polltime(5);
                         break;
 
                 case 0xD5:      /*CMP zp,x */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        temp = readmem((addr + x) & 0xFF);
+                        temp = readmem_fast((addr + x) & 0xFF);
                         setzn(a - temp);
                         p.c = (a >= temp);
                         polltime(3);
@@ -5234,10 +5293,10 @@ void m65c02_exec()
                         break;
 
                 case 0xD6:      /*DEC zp,x */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        temp = readmem((addr + x) & 0xFF) - 1;
-                        writemem((addr + x) & 0xFF, temp);
+                        temp = readmem_fast((addr + x) & 0xFF) - 1;
+                        writemem_fast((addr + x) & 0xFF, temp);
                         setzn(temp);
                         polltime(5);
                         takeint = (interrupt && !p.i);
@@ -5253,7 +5312,7 @@ void m65c02_exec()
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        temp = readmem(addr + y);
+                        temp = readmem_fast(addr + y);
                         setzn(a - temp);
                         p.c = (a >= temp);
                         polltime(4);
@@ -5269,7 +5328,7 @@ void m65c02_exec()
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + x) & 0xFF00))
                                 polltime(1);
-                        temp = readmem(addr + x);
+                        temp = readmem_fast(addr + x);
                         setzn(a - temp);
                         p.c = (a >= temp);
                         polltime(4);
@@ -5278,18 +5337,18 @@ void m65c02_exec()
 
                 case 0xDE:      /*DEC abs,x */
                         addr = getw();
-                        readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
+                        readmem_fast((addr & 0xFF00) | ((addr + x) & 0xFF));
                         addr += x;
-                        temp = readmem(addr) - 1;
-                        readmem(addr);
-                        writemem(addr, temp);
+                        temp = readmem_fast(addr) - 1;
+                        readmem_fast(addr);
+                        writemem_fast(addr, temp);
                         setzn(temp);
                         polltime(7);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xE0:      /*CPX imm */
-                        temp = readmem(pc);
+                        temp = readmem_fast(pc);
                         pc++;
                         setzn(x - temp);
                         p.c = (x >= temp);
@@ -5298,19 +5357,19 @@ void m65c02_exec()
                         break;
 
                 case 0xE1:      /*SBC (,x) */
-                        temp = readmem(pc) + x;
+                        temp = readmem_fast(pc) + x;
                         pc++;
                         addr = read_zp_indirect(temp);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         sbc_cmos(temp);
                         polltime(6);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xE4:      /*CPX zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         setzn(x - temp);
                         p.c = (x >= temp);
                         polltime(3);
@@ -5318,19 +5377,19 @@ void m65c02_exec()
                         break;
 
                 case 0xE5:      /*SBC zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         sbc_cmos(temp);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xE6:      /*INC zp */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        temp = readmem(addr) + 1;
-                        writemem(addr, temp);
+                        temp = readmem_fast(addr) + 1;
+                        writemem_fast(addr, temp);
                         setzn(temp);
                         polltime(5);
                         takeint = (interrupt && !p.i);
@@ -5344,7 +5403,7 @@ void m65c02_exec()
                         break;
 
                 case 0xE9:      /*SBC imm */
-                        temp = readmem(pc);
+                        temp = readmem_fast(pc);
                         pc++;
                         sbc_cmos(temp);
                         polltime(2);
@@ -5360,7 +5419,7 @@ void m65c02_exec()
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         setzn(x - temp);
                         p.c = (x >= temp);
                         break;
@@ -5369,24 +5428,24 @@ void m65c02_exec()
                         addr = getw();
                         polltime(4);
                         takeint = (interrupt && !p.i);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         sbc_cmos(temp);
                         break;
 
                 case 0xEE:      /*INC abs */
                         addr = getw();
                         polltime(4);
-                        temp = readmem(addr) + 1;
+                        temp = readmem_fast(addr) + 1;
                         polltime(1);
-                        readmem(addr);
+                        readmem_fast(addr);
                         polltime(1);
                         takeint = (interrupt && !p.i);
-                        writemem(addr, temp);
+                        writemem_fast(addr, temp);
                         setzn(temp);
                         break;
 
                 case 0xF0:
-                        /*BEQ*/ offset = (int8_t) readmem(pc);
+                        /*BEQ*/ offset = (int8_t) readmem_fast(pc);
                         pc++;
                         temp = 2;
                         if (p.z) {
@@ -5400,40 +5459,40 @@ void m65c02_exec()
                         break;
 
                 case 0xF1:      /*SBC (),y */
-                        temp = readmem(pc);
+                        temp = readmem_fast(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        temp = readmem(addr + y);
+                        temp = readmem_fast(addr + y);
                         sbc_cmos(temp);
                         polltime(5);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xF2:      /*SBC () */
-                        temp = readmem(pc);
+                        temp = readmem_fast(pc);
                         pc++;
                         addr = read_zp_indirect(temp);
-                        temp = readmem(addr);
+                        temp = readmem_fast(addr);
                         sbc_cmos(temp);
                         polltime(5);
                         break;
 
                 case 0xF5:      /*SBC zp,x */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        temp = readmem((addr + x) & 0xFF);
+                        temp = readmem_fast((addr + x) & 0xFF);
                         sbc_cmos(temp);
                         polltime(3);
                         takeint = (interrupt && !p.i);
                         break;
 
                 case 0xF6:      /*INC zp,x */
-                        addr = readmem(pc);
+                        addr = readmem_fast(pc);
                         pc++;
-                        temp = readmem((addr + x) & 0xFF) + 1;
-                        writemem((addr + x) & 0xFF, temp);
+                        temp = readmem_fast((addr + x) & 0xFF) + 1;
+                        writemem_fast((addr + x) & 0xFF, temp);
                         setzn(temp);
                         polltime(5);
                         takeint = (interrupt && !p.i);
@@ -5449,7 +5508,7 @@ void m65c02_exec()
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + y) & 0xFF00))
                                 polltime(1);
-                        temp = readmem(addr + y);
+                        temp = readmem_fast(addr + y);
                         sbc_cmos(temp);
                         polltime(4);
                         takeint = (interrupt && !p.i);
@@ -5465,7 +5524,7 @@ void m65c02_exec()
                         addr = getw();
                         if ((addr & 0xFF00) ^ ((addr + x) & 0xFF00))
                                 polltime(1);
-                        temp = readmem(addr + x);
+                        temp = readmem_fast(addr + x);
                         sbc_cmos(temp);
                         polltime(4);
                         takeint = (interrupt && !p.i);
@@ -5473,11 +5532,11 @@ void m65c02_exec()
 
                 case 0xFE:      /*INC abs,x */
                         addr = getw();
-                        readmem((addr & 0xFF00) | ((addr + x) & 0xFF));
+                        readmem_fast((addr & 0xFF00) | ((addr + x) & 0xFF));
                         addr += x;
-                        temp = readmem(addr) + 1;
-                        readmem(addr);
-                        writemem(addr, temp);
+                        temp = readmem_fast(addr) + 1;
+                        readmem_fast(addr);
+                        writemem_fast(addr, temp);
                         setzn(temp);
                         polltime(7);
                         takeint = (interrupt && !p.i);
@@ -5524,64 +5583,7 @@ void m65c02_exec()
                 {
                         log_debug("A=%02X X=%02X Y=%02X S=%02X PC=%04X %c%c%c%c%c%c op=%02X %02X%02X %02X%02X %02X  %08X\n",a,x,y,s,pc,(p.n)?'N':' ',(p.v)?'V':' ',(p.d)?'D':' ',(p.i)?'I':' ',(p.z)?'Z':' ',(p.c)?'C':' ',opcode,ram[0x21],ram[0x20],ram[0x7F],ram[0x7E],ram[0x7D],memlook[pc>>8]);
                 }*/
-/*                if (timetolive)
-                {
-                        timetolive--;
-                        if (!timetolive) output=0;
-                }*/
-                if (takeint) {
-                        interrupt &= ~128;
-                        takeint = 0;
-//                        skipint=0;
-                        push(pc >> 8);
-                        push(pc & 0xFF);
-                        temp = 0x20;
-                        if (p.c)
-                                temp |= 1;
-                        if (p.z)
-                                temp |= 2;
-                        if (p.i)
-                                temp |= 4;
-                        if (p.d)
-                                temp |= 8;
-                        if (p.v)
-                                temp |= 0x40;
-                        if (p.n)
-                                temp |= 0x80;
-                        push(temp);
-                        pc = readmem(0xFFFE) | (readmem(0xFFFF) << 8);
-                        p.i = 1;
-                        p.d = 0;
-                        polltime(7);
-//                        log_debug("INT\n");
-//                        printf("Interrupt - %02X %02X\n",sysvia.ifr&sysvia.ier,uservia.ifr&uservia.ier);
-//                        printf("INT\n");
-                }
-                interrupt &= ~128;
-                if (tube_exec && tubecycle) {
-//                        log_debug("tubeexec %i %i %i\n",tubecycles,tubecycle,tube_shift);
-                        tubecycles += (tubecycle * tube_multipler) >> 1;
-                        if (tubecycles > 3)
-                                tube_exec();
-                        tubecycle = 0;
-                }
-
-                if (otherstuffcount <= 0)
-                    otherstuff_poll();
-                if (nmi && !oldnmi) {
-                        push(pc >> 8);
-                        push(pc & 0xFF);
-                        temp = pack_flags(0x20);
-                        push(temp);
-                        pc = readmem(0xFFFA) | (readmem(0xFFFB) << 8);
-                        p.i = 1;
-                        polltime(7);
-                        nmi = 0;
-                        p.d = 0;
-//                        log_debug("NMI\n");
-//                        printf("NMI\n");
-                }
-                oldnmi = nmi;
+                end_instruction(true);
         }
 }
 
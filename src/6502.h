@@ -14,6 +14,7 @@ extern int interrupt;
 extern int nmi;
 
 extern uint8_t opcode;
+extern int m6502_slice;
 
 void m6502_reset(void);
 void m6502_exec(void);
@@ -14,10 +14,8 @@
 #include "defs.h"
 #include "Trap.h"
 #include "Decode.h"
-
-#ifdef PROFILING
+#include "Timing.h"
 #include "Profile.h"
-#endif
 
 #ifdef INCLUDE_DEBUGGER
 #include "32016_debug.h"
@@ -100,9 +98,95 @@ const uint32_t OpSizeLookup[6] =
    (sz64 << 8) | sz64                // Floating Point Double Precision
 };
 
+#ifdef NS_DECODE_CACHE
+// Decoded instruction cache
+//
+// The first phase of decoding (the function, operand sizes and
+// addressing modes, including any index bytes) depends only on the
+// instruction bytes, so it is kept for each instruction executed,
+// indexed by its address.  The second phase, which reads displacements
+// and immediates and resolves the addresses from the registers, is
+// done every time.
+//
+// Any store to a page of RAM holding a cached instruction discards the
+// entries for instructions that could overlap it.
+
+#define DECODE_CACHE_SIZE  4096
+#define DECODE_CACHE_SPAN  8                                            // Opcode read plus any index bytes
+
+typedef struct
+{
+   uint32_t PC;                                                         // DECODE_CACHE_EMPTY when unused
+   uint32_t NextPC;
+   uint32_t Function;
+   uint32_t OpSize;
+   uint16_t Regs[2];
+   uint32_t WriteIndex;
+   uint32_t Cycles;
+} DecodeCacheEntry;
+
+#define DECODE_CACHE_EMPTY 0xFFFFFFFF
+
+static DecodeCacheEntry DecodeCache[DECODE_CACHE_SIZE];
+uint8_t DecodeCachePages[RAM_SIZE >> 8];
+
+static void DecodeCacheFlush(void)
+{
+   for (int i = 0; i < DECODE_CACHE_SIZE; i++)
+   {
+      DecodeCache[i].PC = DECODE_CACHE_EMPTY;
+   }
+
+   memset(DecodeCachePages, 0, sizeof(DecodeCachePages));
+}
+
+static void DecodeCacheAdd(DecodeCacheEntry* pEntry, uint32_t Function, uint32_t WriteIndex, uint32_t Cycles)
+{
+   pEntry->PC         = startpc;
+   pEntry->NextPC     = pc;
+   pEntry->Function   = Function;
+   pEntry->OpSize     = OpSize.Whole;
+   pEntry->Regs[0]    = Regs[0].Whole;
+   pEntry->Regs[1]    = Regs[1].Whole;
+   pEntry->WriteIndex = WriteIndex;
+   pEntry->Cycles     = Cycles;
+
+   uint32_t addr = startpc & 0xFFFFFF;
+   if (addr < RAM_SIZE)
+   {
+      DecodeCachePages[addr >> 8] = 1;
+      if ((addr + DECODE_CACHE_SPAN - 1) < RAM_SIZE)
+      {
+         DecodeCachePages[(addr + DECODE_CACHE_SPAN - 1) >> 8] = 1;
+      }
+   }
+}
+
+void DecodeCacheWrite(uint32_t addr, uint32_t Size)
+{
+   uint32_t Start = addr - (DECODE_CACHE_SPAN - 1);
+   uint32_t End   = addr + Size;
+
+   for (addr = Start; addr != End; addr++)
+   {
+      DecodeCacheEntry* pEntry = &DecodeCache[addr & (DECODE_CACHE_SIZE - 1)];
+      if ((pEntry->PC & 0xFFFFFF) == (addr & 0xFFFFFF))
+      {
+         pEntry->PC = DECODE_CACHE_EMPTY;
+      }
+   }
+}
+#endif
+
 void n32016_init()
 {
    init_ram();
+#ifdef NS_DECODE_CACHE
+   DecodeCacheFlush();
+#endif
+#ifdef PROFILING
+   ProfileStart(1);
+#endif
 }
 
 void n32016_close()
@@ -125,6 +209,10 @@ void n32016_reset_addr(uint32_t StartAddress)
 
    //PR.BPC = 0x20F; //Example Breakpoint
    PR.BPC = 0xFFFFFFFF;
+
+#ifdef NS_DECODE_CACHE
+   DecodeCacheFlush();
+#endif
 }
 
 uint32_t n32016_get_pc()
@@ -933,6 +1021,7 @@ void TakeInterrupt(uint32_t IntBase)
    uint32_t temp = psr;
    uint32_t temp2, temp3;
 
+   tubecycles -= TRAP_CYCLES;
    psr &= ~0xF00;
    pushd((temp << 16) | mod);
 
@@ -991,7 +1080,7 @@ void n32016_exec()
    uint32_t opcode, WriteIndex;
    uint32_t temp, temp2, temp3;
    Temp64Type temp64;
-   uint32_t Function;
+   uint32_t Function, Cycles;
 
    // Avoid a "might be uninitialized" warning
    temp = 0;
@@ -1011,8 +1100,6 @@ void n32016_exec()
 
    while (tubecycles > 0)
    {
-      tubecycles -= 8;
-
       CLEAR_TRAP();
 
       WriteSize      = szVaries;                                            // The size a result may be written as
@@ -1044,6 +1131,25 @@ void n32016_exec()
       Function = FunctionLookup[opcode & 0xFF];
       uint32_t Format   = Function >> 4;
 
+#ifdef NS_DECODE_CACHE
+      DecodeCacheEntry* pCached = &DecodeCache[startpc & (DECODE_CACHE_SIZE - 1)];
+#ifdef INCLUDE_DEBUGGER
+      if (pCached->PC == startpc && !n32016_debug_enabled)
+#else
+      if (pCached->PC == startpc)
+#endif
+      {
+         pc             = pCached->NextPC;
+         Function       = pCached->Function;
+         OpSize.Whole   = pCached->OpSize;
+         Regs[0].Whole  = pCached->Regs[0];
+         Regs[1].Whole  = pCached->Regs[1];
+         WriteIndex     = pCached->WriteIndex;
+         Cycles         = pCached->Cycles;
+         goto Decoded;
+      }
+#endif
+
       if (Format < (FormatCount + 1))
       {
          pc += FormatSizes[Format];                                        // Add the basic number of bytes for a particular instruction
@@ -1291,6 +1397,19 @@ void n32016_exec()
          break;
       }
 
+      Cycles = InstructionCycles(Function, OpSize.Whole, Regs[0].Whole, Regs[1].Whole);
+
+#ifdef NS_DECODE_CACHE
+      if (!TrapFlags)
+      {
+         DecodeCacheAdd(pCached, Function, WriteIndex, Cycles);
+      }
+
+      Decoded:
+#endif
+
+      tubecycles -= Cycles;
+
 #ifdef PC_SIMULATION
       uint32_t Temp = pc;
       n32016_show_instruction(startpc, &Temp, opcode, Function, &OpSize);
@@ -1307,6 +1426,7 @@ void n32016_exec()
       if (TrapFlags)
       {
          DoTrap:
+         tubecycles -= TRAP_CYCLES;
          HandleTrap();
          continue;
       }
@@ -1315,9 +1435,10 @@ void n32016_exec()
       IP[startpc]++;
 #endif
 
-#ifdef PROFILING
-      ProfileAdd(Function, Regs[0].Whole, Regs[1].Whole);
-#endif
+      if (ProfileCountdown && !--ProfileCountdown)
+      {
+         ProfileAdd(startpc, Function, Regs[0].Whole, Regs[1].Whole);
+      }
 
       switch (Function)
       {
@@ -1941,6 +2062,9 @@ void n32016_exec()
             }
 
             nscfg.lsb = (opcode >> 15);                                  // Only sets the bottom 8 bits of which the lower 4 are used!
+#ifdef NS_DECODE_CACHE
+            DecodeCacheFlush();                                          // Decoding of floating point instructions depends on the FPU flag
+#endif
             continue;
          }
          // No break due to continue
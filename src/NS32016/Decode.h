@@ -170,6 +170,8 @@ enum Functions
    BAD = 0xFF
 };
 
+extern const char InstuctionText[InstructionCount][8];
+
 // See Table 4-1 page 4-5 in the manual
 enum OperandFlags
 {
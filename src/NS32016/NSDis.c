@@ -116,7 +116,7 @@ static void AddCfgFLags(uint32_t opcode)
    StringAppend("]");
 }
 
-static const char InstuctionText[InstructionCount][8] =
+const char InstuctionText[InstructionCount][8] =
 {
    // FORMAT 0
    "BEQ", "BNE", "BCS", "BCC", "BH", "BLS", "BGT", "BLE", "BFS", "BFC", "BLO", "BHS", "BLT", "BGE", "BR", "BN",
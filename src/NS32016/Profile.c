@@ -9,14 +9,64 @@
 #include "defs.h"
 #include "Profile.h"
 
-#ifdef PROFILING
+// Classify an operand by addressing mode, as used by both the profiler and
+// the instruction timing
+uint16_t processOperand(uint16_t operand)
+{
+   // Bits 7..5 carry the register type of floating point operands and
+   // bits 15..11 carry the base mode in indexed modes
+   uint16_t mode = operand & 0x1F;
 
-#define NUM_OPERAND_TYPES 80
+   if (operand == 0xFFFF)
+   {
+      return 0; // --none--
+   }
+   else if (            mode <= 7)
+   {
+      return 2; // RN
+   }
+   else if (mode >= 8 && mode <= 15)
+   {
+      return 3; // disp(RN)
+   }
+   else if (mode >= 16 && mode <= 27)
+   {
+      return mode - 12; // everything else
+   }
+   else
+   {
+      return 16 + (mode - 27) * 16 + processOperand(operand >> 11) ; // scaled indexed
+   }
+}
+
+// Instruction profiling
+//
+// Every Interval'th instruction executed is sampled, counting the function,
+// its pair of operand classes and its address. The tables are only
+// allocated once profiling is first started so that the emulator pays
+// nothing but a test of ProfileCountdown per instruction when it is off.
 
-uint32_t Frequencies[InstructionCount][NUM_OPERAND_TYPES][NUM_OPERAND_TYPES];
+#define NUM_OPERAND_TYPES 96
+#define NUM_HOT_SPOTS     65536                                         // Must be a power of two
+#define HOT_SPOT_EMPTY    0xFFFFFFFF
 
+typedef struct
+{
+   uint32_t pc;
+   uint32_t Count;
+} HotSpot;
+
+uint32_t ProfileCountdown;
 
-const char operandStrings[NUM_OPERAND_TYPES][20] =
+static uint32_t ProfileInterval;
+static uint64_t Samples;
+static uint64_t FunctionCounts[InstructionCount];
+static uint32_t (*Frequencies)[NUM_OPERAND_TYPES][NUM_OPERAND_TYPES];
+static HotSpot *HotSpots;
+static uint32_t HotSpotsUsed;
+static uint64_t HotSpotsDropped;
+
+const char operandStrings[16][20] =
 {
    "--none--"        ,  //  0
    "--error--"       ,  //  1
@@ -38,98 +88,272 @@ const char operandStrings[NUM_OPERAND_TYPES][20] =
 
 void ProfileInit(void)
 {
-   memset(Frequencies, 0, sizeof(Frequencies));
-}
+   uint32_t Index;
 
-uint16_t processOperand(uint16_t operand)
-{
-   // Mask off bits 15..8 which carry the base mode in indexed modes
-   if (operand == 0xFFFF)
+   Samples = 0;
+   memset(FunctionCounts, 0, sizeof(FunctionCounts));
+
+   if (Frequencies)
    {
-      return 0; // --none--
+      memset(Frequencies, 0, sizeof(*Frequencies) * InstructionCount);
    }
-   else if (                operand <= 7)
+
+   if (HotSpots)
    {
-      return 2; // RN
+      for (Index = 0; Index < NUM_HOT_SPOTS; Index++)
+      {
+         HotSpots[Index].pc    = HOT_SPOT_EMPTY;
+         HotSpots[Index].Count = 0;
+      }
    }
-   else if (operand >= 8 && operand <= 15)
+
+   HotSpotsUsed    = 0;
+   HotSpotsDropped = 0;
+}
+
+int ProfileStart(uint32_t Interval)
+{
+   if (!Frequencies)
    {
-      return 3; // disp(RN)
+      Frequencies = calloc(InstructionCount, sizeof(*Frequencies));
+      HotSpots    = malloc(NUM_HOT_SPOTS * sizeof(HotSpot));
+
+      if (!Frequencies || !HotSpots)
+      {
+         free(Frequencies);
+         free(HotSpots);
+         Frequencies = NULL;
+         HotSpots    = NULL;
+         return 0;
+      }
+
+      ProfileInit();
    }
-   else if (operand >= 16 && operand <= 27)
+
+   ProfileInterval  = Interval ? Interval : 1;
+   ProfileCountdown = ProfileInterval;
+   return 1;
+}
+
+void ProfileStop(void)
+{
+   ProfileCountdown = 0;
+}
+
+static void HotSpotAdd(uint32_t pc)
+{
+   uint32_t Index = (pc * 0x9E3779B1) >> 16;
+
+   for (;;)
    {
-      return operand - 12; // everything else
+      HotSpot* pSpot = &HotSpots[Index & (NUM_HOT_SPOTS - 1)];
+
+      if (pSpot->pc == pc)
+      {
+         pSpot->Count++;
+         return;
+      }
+
+      if (pSpot->pc == HOT_SPOT_EMPTY)
+      {
+         // Keep the table no more than three quarters full so searches stay short
+         if (HotSpotsUsed >= (NUM_HOT_SPOTS / 4) * 3)
+         {
+            HotSpotsDropped++;
+            return;
+         }
+
+         HotSpotsUsed++;
+         pSpot->pc    = pc;
+         pSpot->Count = 1;
+         return;
+      }
+
+      Index++;
    }
-   else if ((operand & 0xff) >= 28 && (operand & 0xff) <= 31)
+}
+
+void ProfileAdd(uint32_t pc, uint32_t Function, uint16_t Regs0, uint16_t Regs1)
+{
+   ProfileCountdown = ProfileInterval;
+
+   if (Function < InstructionCount)
    {
-      return 16 + ((operand & 0xff) - 27) * 16 + processOperand(operand >> 11) ; // scaled indexed
+      Samples++;
+      FunctionCounts[Function]++;
+      Frequencies[Function][processOperand(Regs0)][processOperand(Regs1)]++;
+      HotSpotAdd(pc & 0xFFFFFF);
    }
-   else
+}
+
+static const char *operandText(uint16_t Reg)
+{
+   static char result[80];
+   static const char mode[] = "BWDQ";
+   if (Reg < 16)
    {
-      return 1; // --error--
+      return operandStrings[Reg];
    }
+   snprintf(result, sizeof(result), "%s[Rn:%c]", operandStrings[Reg & 15], mode[(Reg >> 4) - 2]);
+   return result;
 }
 
-void ProfileAdd(uint32_t Function, uint16_t Regs0, uint16_t Regs1)
+static int CompareHotSpots(const void *a, const void *b)
 {
-   if (Function < InstructionCount)
+   const HotSpot *pA = a;
+   const HotSpot *pB = b;
+
+   if (pA->Count != pB->Count)
    {
-      Regs0 = processOperand(Regs0);
-      Regs1 = processOperand(Regs1);
-      Frequencies[Function][Regs0][Regs1]++;
+      return (pA->Count < pB->Count) ? 1 : -1;
    }
+
+   return (pA->pc > pB->pc) - (pA->pc < pB->pc);
 }
 
-char *operandText(uint16_t Reg)
+// Returns the used hot spots sorted by descending count, for the caller to free
+
+static HotSpot *SortedHotSpots(uint32_t *pCount)
 {
-   static char result[80];
-   static char mode[4] = "BWDQ";
-   if (Reg < 16)
+   HotSpot *pSorted;
+   uint32_t Index, Count = 0;
+
+   *pCount = 0;
+   if (!HotSpots || !(pSorted = malloc((HotSpotsUsed + 1) * sizeof(HotSpot))))
    {
-      sprintf(result, "%s", operandStrings[Reg]);
+      return NULL;
    }
-   else
+
+   for (Index = 0; Index < NUM_HOT_SPOTS; Index++)
    {
-      sprintf(result, "%s[Rn:%c]", operandStrings[Reg & 15], mode[(Reg >> 4) - 1]);
+      if (HotSpots[Index].pc != HOT_SPOT_EMPTY)
+      {
+         pSorted[Count++] = HotSpots[Index];
+      }
    }
-   return result;
+
+   qsort(pSorted, Count, sizeof(HotSpot), CompareHotSpots);
+   *pCount = Count;
+   return pSorted;
 }
 
-void ProfileDump(void)
+static int SkipFunction(uint32_t Function)
+{
+   // Skip the TRAP instruction as it's not real
+   return !FunctionCounts[Function] || strcmp(InstuctionText[Function], "TRAP") == 0;
+}
+
+void ProfileWriteCSV(FILE *pFile)
 {
-   uint32_t Function;
+   uint32_t Function, Index, Count;
    uint16_t Regs0;
    uint16_t Regs1;
-   uint32_t total;
+   HotSpot *pSorted;
 
-   printf("\"Function\", \"Name\", \"Operand 0\", \"Operand 1\", \"Frequency\"\n");
+   fprintf(pFile, "\"Function\", \"Name\", \"Operand 0\", \"Operand 1\", \"Frequency\"\n");
 
    for (Function = 0; Function < InstructionCount; Function++)
    {
+      if (SkipFunction(Function))
+         continue;
 
-      // Skip the TRAP instruction as it's not real
-      if (strcmp(InstuctionText[Function], "TRAP") == 0)
+      // Break down of addressing modes
+      for (Regs0 = 0; Regs0 < NUM_OPERAND_TYPES; Regs0++)
+         for (Regs1 = 0; Regs1 < NUM_OPERAND_TYPES; Regs1++)
+            if (Frequencies[Function][Regs0][Regs1])
+            {
+               fprintf(pFile, "%02" PRIX32 ", ", Function);
+               fprintf(pFile, "%-8s, ", InstuctionText[Function]);
+               fprintf(pFile, "%-24s, ", operandText(Regs0));
+               fprintf(pFile, "%-24s, ", operandText(Regs1));
+               fprintf(pFile, "%9" PRIu32 "\n", Frequencies[Function][Regs0][Regs1]);
+            }
+      fprintf(pFile, "\n");
+   }
+
+   if ((pSorted = SortedHotSpots(&Count)))
+   {
+      fprintf(pFile, "\"PC\", \"Frequency\"\n");
+      for (Index = 0; Index < Count; Index++)
+      {
+         fprintf(pFile, "%06" PRIX32 ", %9" PRIu32 "\n", pSorted[Index].pc, pSorted[Index].Count);
+      }
+      free(pSorted);
+   }
+}
+
+void ProfileWriteJSON(FILE *pFile)
+{
+   uint32_t Function, Index, Count;
+   uint16_t Regs0;
+   uint16_t Regs1;
+   HotSpot *pSorted;
+   const char *pSep = "";
+
+   fprintf(pFile, "{\n  \"interval\": %" PRIu32 ",\n  \"samples\": %" PRIu64 ",\n  \"instructions\": [", ProfileInterval, Samples);
+
+   for (Function = 0; Function < InstructionCount; Function++)
+   {
+      const char *pOpSep = "";
+
+      if (SkipFunction(Function))
          continue;
 
-      total = 0;
+      fprintf(pFile, "%s\n    { \"function\": %" PRIu32 ", \"name\": \"%s\", \"count\": %" PRIu64 ", \"operands\": [",
+              pSep, Function, InstuctionText[Function], FunctionCounts[Function]);
+
       for (Regs0 = 0; Regs0 < NUM_OPERAND_TYPES; Regs0++)
          for (Regs1 = 0; Regs1 < NUM_OPERAND_TYPES; Regs1++)
             if (Frequencies[Function][Regs0][Regs1])
-               total++;
-      if (total) {
-         // Break down of addressing modes
-         for (Regs0 = 0; Regs0 < NUM_OPERAND_TYPES; Regs0++)
-            for (Regs1 = 0; Regs1 < NUM_OPERAND_TYPES; Regs1++)
-               if (Frequencies[Function][Regs0][Regs1])
-               {
-                  printf("%02" PRIX32 ", ", Function);
-                  printf("%-8s, ", InstuctionText[Function]);
-                  printf("%-24s, ", operandText(Regs1));
-                  printf("%-24s, ", operandText(Regs0));
-                  printf("%9" PRIu32 "\n", Frequencies[Function][Regs0][Regs1]);
-               }
-         printf("\n");
+            {
+               fprintf(pFile, "%s\n        { \"operand0\": \"%s\"", pOpSep, operandText(Regs0));
+               fprintf(pFile, ", \"operand1\": \"%s\", \"count\": %" PRIu32 " }", operandText(Regs1), Frequencies[Function][Regs0][Regs1]);
+               pOpSep = ",";
+            }
+
+      fprintf(pFile, "\n      ] }");
+      pSep = ",";
+   }
+
+   fprintf(pFile, "\n  ],\n  \"hotspots_dropped\": %" PRIu64 ",\n  \"hotspots\": [", HotSpotsDropped);
+
+   if ((pSorted = SortedHotSpots(&Count)))
+   {
+      for (Index = 0; Index < Count; Index++)
+      {
+         fprintf(pFile, "%s\n    { \"pc\": \"%06" PRIX32 "\", \"count\": %" PRIu32 " }", Index ? "," : "", pSorted[Index].pc, pSorted[Index].Count);
       }
+      free(pSorted);
    }
+
+   fprintf(pFile, "\n  ]\n}\n");
+}
+
+size_t ProfileFormat(char *buf, size_t size, uint32_t Top)
+{
+   uint32_t Index, Count;
+   HotSpot *pSorted;
+   size_t len;
+
+   len = snprintf(buf, size, "    32016 profiling %s, every %" PRIu32 " instructions, %" PRIu64 " samples\n",
+                  ProfileCountdown ? "on" : "off", ProfileInterval, Samples);
+
+   if ((pSorted = SortedHotSpots(&Count)))
+   {
+      for (Index = 0; Index < Count && Index < Top && len < size; Index++)
+      {
+         len += snprintf(buf + len, size - len, "    %06" PRIX32 " %9" PRIu32 " %5.1f%%\n", pSorted[Index].pc, pSorted[Index].Count,
+                         (100.0 * pSorted[Index].Count) / Samples);
+      }
+      free(pSorted);
+   }
+
+   return len < size ? len : size - 1;
+}
+
+#ifdef PROFILING
+void ProfileDump(void)
+{
+   ProfileWriteCSV(stdout);
 }
 #endif
@@ -1,13 +1,21 @@
-#ifdef PROFILING
+extern uint16_t processOperand(uint16_t operand);
+
+extern uint32_t ProfileCountdown;                                      // Instructions until the next sample, 0 when stopped
 
+extern int ProfileStart(uint32_t Interval);
+extern void ProfileStop(void);
 extern void ProfileInit(void);
-extern void ProfileAdd(uint32_t Function, uint16_t Regs0, uint16_t Regs1);
+extern void ProfileAdd(uint32_t pc, uint32_t Function, uint16_t Regs0, uint16_t Regs1);
+extern void ProfileWriteCSV(FILE *pFile);
+extern void ProfileWriteJSON(FILE *pFile);
+extern size_t ProfileFormat(char *buf, size_t size, uint32_t Top);
+
+#ifdef PROFILING
+
 extern void ProfileDump(void);
 
 #else
 
-#define ProfileInit()
-#define ProfileAdd(a)
 #define ProfileDump()
 
 #endif
@@ -0,0 +1,115 @@
+#include <stdint.h>
+#include <stdio.h>
+#include "32016.h"
+#include "Decode.h"
+#include "Profile.h"
+#include "Timing.h"
+
+// Execution times are taken from the NS32016 data sheet, rounded, for the
+// register forms of each instruction with no bus wait states. Time spent
+// moving operands to and from the NS32081 FPU is folded into the floating
+// point figures. String and block instructions are charged per element as
+// they are re-executed once per element.
+
+static const uint8_t FunctionCycles[InstructionCount] =
+{
+   // Format 0
+   [BEQ] = 7, [BNE] = 7, [BCS] = 7, [BCC] = 7, [BH] = 7, [BLS] = 7, [BGT] = 7, [BLE] = 7,
+   [BFS] = 7, [BFC] = 7, [BLO] = 7, [BHS] = 7, [BLT] = 7, [BGE] = 7, [BR] = 7, [BN] = 6,
+
+   // Format 1
+   [BSR] = 13, [RET] = 12, [CXP] = 28, [RXP] = 21, [RETT] = 29, [RETI] = 33, [SAVE] = 13, [RESTORE] = 12,
+   [ENTER] = 18, [EXIT] = 17, [NOP] = 3, [WAIT] = 6, [DIA] = 3, [FLAG] = 6, [SVC] = 6, [BPT] = 6,
+
+   // Format 2
+   [ADDQ] = 4, [CMPQ] = 3, [SPR] = 21, [Scond] = 10, [ACB] = 18, [MOVQ] = 3, [LPR] = 19,
+
+   // Format 3
+   [CXPD] = 30, [BICPSR] = 18, [JUMP] = 3, [BISPSR] = 18, [ADJSP] = 6, [JSR] = 5, [CASE] = 7,
+
+   // Format 4
+   [ADD] = 3, [CMP] = 3, [BIC] = 4, [ADDC] = 4, [MOV] = 3, [OR] = 3, [SUB] = 4, [ADDR] = 4,
+   [AND] = 3, [SUBC] = 4, [TBIT] = 4, [XOR] = 3,
+
+   // Format 5
+   [MOVS] = 13, [CMPS] = 20, [SETCFG] = 15, [SKPS] = 18,
+
+   // Format 6
+   [ROT] = 14, [ASH] = 14, [CBIT] = 7, [CBITI] = 7, [LSH] = 14, [SBIT] = 7, [SBITI] = 7, [NEG] = 5,
+   [NOT] = 5, [SUBP] = 16, [ABS] = 5, [COM] = 5, [IBIT] = 8, [ADDP] = 16,
+
+   // Format 7
+   [MOVM] = 20, [CMPM] = 20, [INSS] = 30, [EXTS] = 25, [MOVXiW] = 6, [MOVZiW] = 5, [MOVZiD] = 5, [MOVXiD] = 6,
+   [MUL] = 40, [MEI] = 68, [DEI] = 90, [QUO] = 80, [REM] = 80, [MOD] = 90, [DIV] = 95,
+
+   // Format 8
+   [EXT] = 17, [CVTP] = 10, [INS] = 28, [CHECK] = 10, [INDEX] = 40, [FFS] = 20, [MOVUS] = 28, [MOVSU] = 28,
+
+   // Format 9
+   [MOVif] = 54, [LFSR] = 20, [MOVLF] = 28, [MOVFL] = 28, [ROUND] = 60, [TRUNC] = 60, [SFSR] = 20, [FLOOR] = 60,
+
+   // Format 11
+   [ADDf] = 70, [MOVf] = 25, [CMPf] = 45, [SUBf] = 70, [NEGf] = 25, [DIVf] = 100, [MULf] = 70, [ABSf] = 25,
+
+   // Format 14
+   [RDVAL] = 20, [WRVAL] = 20, [LMR] = 30, [SMR] = 25, [CINV] = 20
+};
+
+// Effective address calculation time for each operand class returned by
+// processOperand(), before any memory transfer
+
+static const uint8_t AddressingCycles[16] =
+{
+   0,                                                                   // --none--
+   0,                                                                   // --error--
+   0,                                                                   // RN
+   5,                                                                   // disp(RN)
+   12, 12, 12,                                                          // disp2(disp1(FP/SP/SB))
+   0,                                                                   // --illegal--
+   2,                                                                   // value
+   5,                                                                   // @disp
+   19,                                                                  // EXT(disp1)+disp2
+   2,                                                                   // TOS
+   5, 5, 5,                                                             // disp(FP/SP/SB)
+   5                                                                    // *+disp
+};
+
+#define SCALED_INDEX_CYCLES   6
+#define BUS_CYCLES            4                                         // One 16 bit transfer
+
+static uint32_t OperandCycles(uint16_t Reg, uint8_t Size)
+{
+   uint16_t Class = processOperand(Reg);
+   uint32_t Cycles = AddressingCycles[Class & 15];
+
+   if (Class >= 16)
+   {
+      Cycles += SCALED_INDEX_CYCLES;
+   }
+
+   // Register and immediate operands need no data transfer
+   if ((Class & 15) > 2 && (Class & 15) != 8)
+   {
+      Cycles += BUS_CYCLES * ((Size + 1) >> 1);
+   }
+
+   return Cycles;
+}
+
+uint32_t InstructionCycles(uint32_t Function, uint32_t OpSizeWhole, uint16_t Regs0, uint16_t Regs1)
+{
+   OperandSizeType Size;
+   uint32_t Cycles = 0;
+
+   Size.Whole = OpSizeWhole;
+
+   if (Function < InstructionCount)
+   {
+      Cycles = FunctionCycles[Function];
+   }
+
+   Cycles += OperandCycles(Regs0, Size.Op[0]);
+   Cycles += OperandCycles(Regs1, Size.Op[1]);
+
+   return (Cycles > 0) ? Cycles : 1;
+}
@@ -0,0 +1,5 @@
+// Approximate NS32016 execution times, in CPU clock cycles
+
+#define TRAP_CYCLES 40                                                  // Trap or interrupt entry via the dispatch table
+
+extern uint32_t InstructionCycles(uint32_t Function, uint32_t OpSizeWhole, uint16_t Regs0, uint16_t Regs1);
@@ -222,6 +222,9 @@ void write_x8_internal(uint32_t addr, uint8_t val)
       ns32016ram[addr] = val;
 #else
       *(unsigned char *)(addr) = val;
+#endif
+#ifdef NS_DECODE_CACHE
+      DecodeCacheCheck(addr, sizeof(uint8_t));
 #endif
       return;
    }
@@ -268,6 +271,9 @@ void write_x16(uint32_t addr, uint16_t val)
       *((uint16_t*) (ns32016ram + addr)) = val;
 #else
       *((uint16_t*) (addr)) = val;
+#endif
+#ifdef NS_DECODE_CACHE
+      DecodeCacheCheck(addr, sizeof(uint16_t));
 #endif
       return;
    }
@@ -294,6 +300,9 @@ void write_x32(uint32_t addr, uint32_t val)
       *((uint32_t*) (ns32016ram + addr)) = val;
 #else
       *((uint32_t*) (addr)) = val;
+#endif
+#ifdef NS_DECODE_CACHE
+      DecodeCacheCheck(addr, sizeof(uint32_t));
 #endif
       return;
    }
@@ -343,6 +352,12 @@ void write_Arbitary(uint32_t addr, void* pData, uint32_t Size)
 #endif
    {
       memcpy(ns32016ram + addr, pData, Size);
+#ifdef NS_DECODE_CACHE
+      if (Size)
+      {
+         DecodeCacheCheck(addr, Size);
+      }
+#endif
       return;
    }
 #endif
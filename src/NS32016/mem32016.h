@@ -10,6 +10,7 @@
 
 //#define PANDORA_ROM_PAGE_OUT
 #define NS_FAST_RAM
+#define NS_DECODE_CACHE
 
 void init_ram(void);
 
@@ -32,3 +33,18 @@ void     write_x16(uint32_t addr, uint16_t val);
 void     write_x32(uint32_t addr, uint32_t val);
 void     write_x64(uint32_t addr, uint64_t val);
 void     write_Arbitary(uint32_t addr, void* pData, uint32_t Size);
+
+#ifdef NS_DECODE_CACHE
+// Non-zero for each page of RAM holding instructions in the decode cache
+extern uint8_t DecodeCachePages[RAM_SIZE >> 8];
+
+void DecodeCacheWrite(uint32_t addr, uint32_t Size);
+
+static inline void DecodeCacheCheck(uint32_t addr, uint32_t Size)
+{
+   if (DecodeCachePages[addr >> 8] | DecodeCachePages[(addr + Size - 1) >> 8])
+   {
+      DecodeCacheWrite(addr, Size);
+   }
+}
+#endif
@@ -5,9 +5,14 @@
 #include "adc.h"
 #include "via.h"
 #include "sysvia.h"
+#include "sched.h"
+
+/* Conversion time, kept in 128 cycle ticks in savestates */
+#define ADC_TICK 128
+#define ADC_CONVERT_TIME (60 * ADC_TICK)
 
 static uint8_t adc_status,adc_high,adc_low,adc_latch;
-int adc_time;
+static sched_event_t adc_event = SCHED_EVENT("adc", adc_poll);
 
 uint8_t adc_read(uint16_t addr)
 {
@@ -31,7 +36,7 @@ void adc_write(uint16_t addr, uint8_t val)
         if (!(addr & 3))
         {
                 adc_latch  = val;
-                adc_time   = 60;
+                sched_add(&adc_event, ADC_CONVERT_TIME);
                 adc_status = (val & 0xF) | 0x80; /*Busy, converting*/
                 sysvia_set_cb1(1);
 //                printf("ADC conversion - %02X\n",val);
@@ -54,7 +59,7 @@ void adc_init()
 {
         adc_status = 0x40;            /*Not busy, conversion complete*/
         adc_high = adc_low = adc_latch = 0;
-        adc_time = 0;
+        sched_cancel(&adc_event);
         al_install_joystick();
 }
 
@@ -64,14 +69,20 @@ void adc_savestate(FILE *f)
         putc(adc_low,f);
         putc(adc_high,f);
         putc(adc_latch,f);
-        putc(adc_time,f);
+        putc((sched_remaining(&adc_event) + ADC_TICK - 1) / ADC_TICK,f);
 }
 
 void adc_loadstate(FILE *f)
 {
+        int adc_time;
+
         adc_status = getc(f);
         adc_low    = getc(f);
         adc_high   = getc(f);
         adc_latch  = getc(f);
         adc_time   = getc(f);
+        if (adc_time)
+                sched_add(&adc_event, adc_time * ADC_TICK);
+        else
+                sched_cancel(&adc_event);
 }
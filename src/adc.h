@@ -9,6 +9,4 @@ void adc_write(uint16_t addr, uint8_t val);
 void adc_savestate(FILE *f);
 void adc_loadstate(FILE *f);
 
-extern int adc_time;
-
 #endif
@@ -345,6 +345,20 @@ static uint32_t readarml(uint32_t a)
     return v;
 }
 
+/*
+ * Instruction fetch.  Code runs from RAM or ROM, both of which are in
+ * armread, so fetches go straight to the word unless the debugger
+ * wants to see them.
+ */
+static inline uint32_t fetcharml(uint32_t a)
+{
+    const uint32_t *page = armread[(a>>20)&63];
+
+    if (page && !arm_debug_enabled)
+        return page[(a&0xFFFFF)>>2];
+    return readarml(a);
+}
+
 static inline uint8_t do_readarmb(uint32_t addr)
 {
         if (addr<0x400000) return armramb[addr];
@@ -882,14 +896,14 @@ static int ldrlookup[4]={0,8,16,24};
 
 static void refillpipeline()
 {
-        opcode2=readarml(PC-4);
-        opcode3=readarml(PC);
+        opcode2=fetcharml(PC-4);
+        opcode3=fetcharml(PC);
 }
 
 static void refillpipeline2()
 {
-        opcode2=readarml(PC-8);
-        opcode3=readarml(PC-4);
+        opcode2=fetcharml(PC-8);
+        opcode3=fetcharml(PC-4);
 }
 
 int accc=0;
@@ -901,7 +915,7 @@ void arm_exec()
         {
                 opcode=opcode2;
                 opcode2=opcode3;
-                opcode3=readarml(PC);
+                opcode3=fetcharml(PC);
                 if (arm_debug_enabled)
                     debug_preexec(&tubearm_cpu_debug, PC);
                 if (flaglookup[opcode>>28][armregs[15]>>28])
@@ -7,8 +7,10 @@
 #include "ddnoise.h"
 #include "disc.h"
 #include "keyboard.h"
+#include "main.h"
 #include "model.h"
 #include "mouse.h"
+#include "perf.h"
 #include "ide.h"
 #include "midi.h"
 #include "scsi.h"
@@ -119,6 +121,7 @@ void config_load(void)
     curmodel         = get_config_int(NULL, "model",         3);
     selecttube       = get_config_int(NULL, "tube",         -1);
     tube_speed_num   = get_config_int(NULL, "tubespeed",     0);
+    headless         = get_config_bool(NULL, "headless",     false);
 
     sound_internal   = get_config_bool("sound", "sndinternal",   true);
     sound_beebsid    = get_config_bool("sound", "sndbeebsid",    true);
@@ -129,6 +132,9 @@ void config_load(void)
     sound_filter     = get_config_bool("sound", "soundfilter",   true);
 
     curwave          = get_config_int("sound", "soundwave",     0);
+    sn_quality       = get_config_int("sound", "soundquality",  SN_QUALITY_NORMAL);
+    if (sn_quality < SN_QUALITY_FAST || sn_quality > SN_QUALITY_HIGH)
+        sn_quality = SN_QUALITY_NORMAL;
     sidmethod        = get_config_int("sound", "sidmethod",     0);
     cursid           = get_config_int("sound", "cursid",        2);
 
@@ -155,6 +161,10 @@ void config_load(void)
 
     buflen_m5        = get_config_int("sound", "buflen_music5000", BUFLEN_M5);
 
+    perf_timing       = get_config_bool("perf", "timing",       false);
+    perf_title        = get_config_bool("perf", "title",        false);
+    perf_log_interval = get_config_int("perf", "log_interval",  0);
+
     for (c = 0; c < ALLEGRO_KEY_MAX; c++) {
         sprintf(s, "key_define_%03i", c);
         keylookup[c] = get_config_int("user_keyboard", s, c);
@@ -228,6 +238,7 @@ void config_save(void)
         set_config_bool("sound", "soundfilter", sound_filter);
 
         set_config_int("sound", "soundwave", curwave);
+        set_config_int("sound", "soundquality", sn_quality);
         set_config_int("sound", "sidmethod", sidmethod);
         set_config_int("sound", "cursid", cursid);
         set_config_int("sound", "buflen_music5000", buflen_m5);
@@ -248,6 +259,10 @@ void config_save(void)
 
         set_config_bool(NULL, "mouse_amx", mouse_amx);
 
+        set_config_bool("perf", "timing", perf_timing);
+        set_config_bool("perf", "title", perf_title);
+        set_config_int("perf", "log_interval", perf_log_interval);
+
         for (c = 0; c < 128; c++) {
             snprintf(t, sizeof t, "key_define_%03i", c);
             if (keylookup[c] == c)
@@ -5,42 +5,141 @@
 #include "b-em.h"
 #include "disc.h"
 #include "ddnoise.h"
+#include "perf.h"
+#include "sched.h"
 #include "sound.h"
+#include "soundfeed.h"
 #include "tapenoise.h"
 
 int ddnoise_vol=3;
 int ddnoise_type=0;
 int ddnoise_ticks = 0;
 
-static ALLEGRO_SAMPLE *seeksmp[4][2];
-static ALLEGRO_SAMPLE *motorsmp[3];
+/*
+ * The samples are converted to mono at FREQ_DD when loaded and played
+ * here, rather than by Allegro, so they can be mixed with the rest of
+ * the sound.  Each voice plays one sample at a time, a new one cutting
+ * off the old, and they are rendered a block at a time as the 2MHz
+ * clock passes.
+ */
+struct ddnoise_sample {
+    float *data;
+    unsigned len;
+};
 
-static ALLEGRO_SAMPLE_ID seek_smp_id;
-static ALLEGRO_SAMPLE_ID motor_smp_id;
+enum {
+    VOICE_SEEK,
+    VOICE_MOTOR,
+    VOICE_HEAD,
+    VOICE_TAPE,
+    VOICE_MAX
+};
 
-ALLEGRO_SAMPLE *find_load_wav(ALLEGRO_PATH *dir, const char *name)
+static struct {
+    const ddnoise_sample_t *smp;
+    unsigned pos;
+    bool loop;
+} voices[VOICE_MAX];
+
+static ddnoise_sample_t *seeksmp[4][2];
+static ddnoise_sample_t *motorsmp[3];
+
+static soundfeed_t *feed;
+static bool playing;
+
+#define DDNOISE_BLOCK_CYCLES 20000  // BUFLEN_DD samples at 2MHz.
+
+static void ddnoise_block(void);
+static sched_event_t ddnoise_event = SCHED_EVENT("ddnoise", ddnoise_block);
+
+static float sample_value(const void *data, ALLEGRO_AUDIO_DEPTH depth, unsigned n)
+{
+    switch(depth) {
+        case ALLEGRO_AUDIO_DEPTH_INT8:
+            return ((const int8_t *)data)[n] / 128.0f;
+        case ALLEGRO_AUDIO_DEPTH_UINT8:
+            return (((const uint8_t *)data)[n] - 128) / 128.0f;
+        case ALLEGRO_AUDIO_DEPTH_INT16:
+            return ((const int16_t *)data)[n] / 32768.0f;
+        case ALLEGRO_AUDIO_DEPTH_UINT16:
+            return (((const uint16_t *)data)[n] - 32768) / 32768.0f;
+        case ALLEGRO_AUDIO_DEPTH_FLOAT32:
+            return ((const float *)data)[n];
+        default:
+            return 0.0f;
+    }
+}
+
+/* Mix down to mono and convert to FREQ_DD by linear interpolation. */
+static ddnoise_sample_t *convert_wav(ALLEGRO_SAMPLE *smp)
+{
+    ddnoise_sample_t *dsmp;
+    const void *data = al_get_sample_data(smp);
+    ALLEGRO_AUDIO_DEPTH depth = al_get_sample_depth(smp);
+    unsigned chans = al_get_channel_count(al_get_sample_channels(smp));
+    unsigned inlen = al_get_sample_length(smp);
+    double step = (double)al_get_sample_frequency(smp) / FREQ_DD, pos;
+    float a, b, f;
+    unsigned n, c, i;
+
+    if (!inlen)
+        return NULL;
+    if (!(dsmp = malloc(sizeof(ddnoise_sample_t))))
+        return NULL;
+    dsmp->len = inlen / step;
+    if (!(dsmp->data = malloc(dsmp->len * sizeof(float)))) {
+        free(dsmp);
+        return NULL;
+    }
+    for (n = 0; n < dsmp->len; n++) {
+        pos = n * step;
+        i = (unsigned)pos;
+        f = pos - i;
+        a = b = 0.0f;
+        for (c = 0; c < chans; c++) {
+            a += sample_value(data, depth, i * chans + c);
+            if (i + 1 < inlen)
+                b += sample_value(data, depth, (i + 1) * chans + c);
+        }
+        dsmp->data[n] = (a + (b - a) * f) / chans;
+    }
+    return dsmp;
+}
+
+ddnoise_sample_t *find_load_wav(ALLEGRO_PATH *dir, const char *name)
 {
     ALLEGRO_PATH *path;
     ALLEGRO_SAMPLE *smp;
+    ddnoise_sample_t *dsmp = NULL;
     const char *cpath;
 
     if ((path = find_dat_file(dir, name, ".wav"))) {
         cpath = al_path_cstr(path, ALLEGRO_NATIVE_PATH_SEP);
         if ((smp = al_load_sample(cpath))) {
-            log_debug("ddnoise: loaded %s from %s", name, cpath);
-            return smp;
+            if ((dsmp = convert_wav(smp)))
+                log_debug("ddnoise: loaded %s from %s", name, cpath);
+            else
+                log_error("ddnoise: unable to convert %s from %s", name, cpath);
+            al_destroy_sample(smp);
         }
-        log_error("ddnoise: unable to load %s from %s", name, cpath);
+        else
+            log_error("ddnoise: unable to load %s from %s", name, cpath);
         al_destroy_path(path);
     }
-    return NULL;
+    return dsmp;
+}
+
+void free_wav(ddnoise_sample_t *smp)
+{
+    free(smp->data);
+    free(smp);
 }
 
 void ddnoise_init(void)
 {
     const char *dir;
     ALLEGRO_PATH *subdir;
-    static ALLEGRO_SAMPLE *smp;
+    ddnoise_sample_t *smp;
 
     if (ddnoise_type) dir = "ddnoise/35";
     else              dir = "ddnoise/525";
@@ -72,27 +171,31 @@ void ddnoise_init(void)
     motorsmp[0] = find_load_wav(subdir, "motoron");
     motorsmp[1] = find_load_wav(subdir, "motor");
     motorsmp[2] = find_load_wav(subdir, "motoroff");
+
+    if (!feed && (feed = soundfeed_create("ddnoise", FREQ_DD, 1, BUFLEN_DD * 3)))
+        sched_add(&ddnoise_event, DDNOISE_BLOCK_CYCLES);
 }
 
 void ddnoise_close()
 {
-    ALLEGRO_SAMPLE *smp, *smpo, *smpi;
+    ddnoise_sample_t *smpo, *smpi;
     int c;
 
+    memset(voices, 0, sizeof(voices));
     for (c = 0; c < 4; c++) {
         if ((smpo = seeksmp[c][0])) {
-            al_destroy_sample(smpo);
+            free_wav(smpo);
             seeksmp[c][0] = NULL;
         }
         if ((smpi = seeksmp[c][1])) {
             if (smpi != smpo)
-                al_destroy_sample(smpo);
+                free_wav(smpi);
             seeksmp[c][1] = NULL;
         }
     }
     for (c = 0; c < 3; c++) {
-        if ((smp = motorsmp[c])) {
-            al_destroy_sample(motorsmp[c]);
+        if (motorsmp[c]) {
+            free_wav(motorsmp[c]);
             motorsmp[c] = NULL;
         }
     }
@@ -111,15 +214,69 @@ static float map_ddnoise_vol(void)
     }
 }
 
+static void ddnoise_play(int voice, const ddnoise_sample_t *smp, bool loop)
+{
+    voices[voice].smp = smp;
+    voices[voice].pos = 0;
+    voices[voice].loop = loop;
+}
+
+static void ddnoise_stop(int voice)
+{
+    voices[voice].smp = NULL;
+}
+
+/* The tape motor relays are heard alongside the drives. */
+void ddnoise_play_tape(const ddnoise_sample_t *smp)
+{
+    ddnoise_play(VOICE_TAPE, smp, false);
+}
+
+static void ddnoise_block(void)
+{
+    float buf[BUFLEN_DD];
+    const ddnoise_sample_t *smp;
+    bool active = false;
+    int v, n;
+
+    memset(buf, 0, sizeof(buf));
+    for (v = 0; v < VOICE_MAX; v++) {
+        if ((smp = voices[v].smp)) {
+            active = true;
+            for (n = 0; n < BUFLEN_DD; n++) {
+                if (voices[v].pos >= smp->len) {
+                    if (!voices[v].loop) {
+                        voices[v].smp = NULL;
+                        break;
+                    }
+                    voices[v].pos = 0;
+                }
+                buf[n] += smp->data[voices[v].pos++];
+            }
+        }
+    }
+    if (active) {
+        soundfeed_gain(feed, map_ddnoise_vol());
+        if (soundfeed_write(feed, buf, BUFLEN_DD) < BUFLEN_DD) {
+            log_debug("ddnoise: overrun");
+            perf_count.sound_overruns++;
+        }
+    }
+    else if (playing)
+        soundfeed_end(feed);
+    playing = active;
+    sched_at(&ddnoise_event, ddnoise_event.when + DDNOISE_BLOCK_CYCLES);
+}
+
 void ddnoise_seek(int len)
 {
-    ALLEGRO_SAMPLE *smp;
+    ddnoise_sample_t *smp;
     int ddnoise_sstat = -1;
     int ddnoise_sdir = 0;
+    int seek_time = 200;
 
     log_debug("ddnoise: seek %i tracks", len);
 
-    fdc_time = 200;
     if (sound_ddnoise && len) {
         if (len < 0) {
             ddnoise_sdir = 1;
@@ -134,46 +291,46 @@ void ddnoise_seek(int len)
         else
             ddnoise_sstat = 3;
         if ((smp = seeksmp[ddnoise_sstat][ddnoise_sdir])) {
-            al_stop_sample(&seek_smp_id);
-            al_play_sample(smp, map_ddnoise_vol(), 0.0, 1.0, ALLEGRO_PLAYMODE_ONCE, &seek_smp_id);
-            fdc_time = 64000 * len;
+            ddnoise_play(VOICE_SEEK, smp, false);
+            seek_time = 64000 * len;
         }
     }
-    log_debug("ddnoise: begin seek, fdc_time=%d", fdc_time);
+    fdc_settime(seek_time);
+    log_debug("ddnoise: begin seek, fdc_time=%d", seek_time);
 }
 
 void ddnoise_spinup(void)
 {
-    ALLEGRO_SAMPLE *smp;
+    ddnoise_sample_t *smp;
 
     log_debug("ddnoise: spinup");
     if (sound_ddnoise && (smp = motorsmp[0])) {
-        al_play_sample(smp, map_ddnoise_vol(), 0.0, 1.0, ALLEGRO_PLAYMODE_ONCE, NULL);
-        ddnoise_ticks = (50 * al_get_sample_length(smp)) / al_get_sample_frequency(smp);
+        ddnoise_play(VOICE_HEAD, smp, false);
+        ddnoise_ticks = (50 * smp->len) / FREQ_DD;
         log_debug("ddnoise: head load sample to finish in %d ticks", ddnoise_ticks);
     }
 }
 
 void ddnoise_headdown(void)
 {
-    ALLEGRO_SAMPLE *smp;
+    ddnoise_sample_t *smp;
 
     log_debug("ddnoise: head down");
     if (sound_ddnoise && (smp = motorsmp[1]))
-        al_play_sample(smp, map_ddnoise_vol(), 0.0, 1.0, ALLEGRO_PLAYMODE_LOOP, &motor_smp_id);
+        ddnoise_play(VOICE_MOTOR, smp, true);
 }
 
 void ddnoise_spindown(void)
 {
-    ALLEGRO_SAMPLE *smp;
+    ddnoise_sample_t *smp;
 
     log_debug("ddnoise: spindown");
     if (sound_ddnoise) {
         if ((smp = motorsmp[1])) {
             log_debug("ddnoise: stopping sample");
-            al_stop_sample(&motor_smp_id);
+            ddnoise_stop(VOICE_MOTOR);
         }
         if ((smp = motorsmp[2]))
-            al_play_sample(smp, map_ddnoise_vol(), 0.0, 1.0, ALLEGRO_PLAYMODE_ONCE, NULL);
+            ddnoise_play(VOICE_HEAD, smp, false);
     }
 }
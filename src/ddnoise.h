@@ -2,13 +2,18 @@
 #define __INC_DDNOISE_H
 
 #include <allegro5/allegro_audio.h>
-extern ALLEGRO_SAMPLE *find_load_wav(ALLEGRO_PATH *dir, const char *name);
+
+typedef struct ddnoise_sample ddnoise_sample_t;
+
+extern ddnoise_sample_t *find_load_wav(ALLEGRO_PATH *dir, const char *name);
+void free_wav(ddnoise_sample_t *smp);
 void ddnoise_init(void);
 void ddnoise_close(void);
 void ddnoise_seek(int len);
 void ddnoise_spinup(void);
 void ddnoise_headdown(void);
 void ddnoise_spindown(void);
+void ddnoise_play_tape(const ddnoise_sample_t *smp);
 extern int ddnoise_vol;
 extern int ddnoise_type;
 extern int ddnoise_ticks;
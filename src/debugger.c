@@ -2,6 +2,8 @@
   Debugger*/
 
 #include <ctype.h>
+#include <errno.h>
+#include <inttypes.h>
 #include <stdarg.h>
 #include <stdio.h>
 
@@ -10,6 +12,8 @@
 #include "b-em.h"
 #include "main.h"
 #include "model.h"
+#include "perf.h"
+#include "NS32016/Profile.h"
 #include "6502.h"
 
 #include <allegro5/allegro_primitives.h>
@@ -88,6 +92,7 @@ static void debug_memview_open(void)
     if (!mem_thread) {
         if ((mem_thread = al_create_thread(mem_thread_proc, NULL))) {
             log_debug("debugger: memory view thread created");
+            debug_heatmap |= HEATMAP_VIEW;
             al_start_thread(mem_thread);
         }
         else
@@ -98,11 +103,44 @@ static void debug_memview_open(void)
 static void debug_memview_close(void)
 {
     if (mem_thread) {
+        debug_heatmap &= ~HEATMAP_VIEW;
         al_join_thread(mem_thread, NULL);
         mem_thread = NULL;
     }
 }
 
+static const char *memprof_fn;
+
+void debug_memprofile(const char *fn)
+{
+    memprof_fn = fn;
+    memset(heatmap_pages, 0, sizeof heatmap_pages);
+    debug_heatmap |= HEATMAP_PROFILE;
+}
+
+static void debug_memprofile_save(void)
+{
+    FILE *fp;
+    int page;
+
+    if (!(debug_heatmap & HEATMAP_PROFILE))
+        return;
+    debug_heatmap &= ~HEATMAP_PROFILE;
+    if (!(fp = fopen(memprof_fn, "w"))) {
+        log_error("debugger: unable to open memory profile file '%s': %s", memprof_fn, strerror(errno));
+        return;
+    }
+    fputs("page,fetches,reads,writes\n", fp);
+    for (page = 0; page < 256; page++) {
+        uint64_t *counts = heatmap_pages[page];
+        if (counts[HEATMAP_FETCH] || counts[HEATMAP_READ] || counts[HEATMAP_WRITE])
+            fprintf(fp, "%04X,%" PRIu64 ",%" PRIu64 ",%" PRIu64 "\n", page << 8,
+                    counts[HEATMAP_FETCH], counts[HEATMAP_READ], counts[HEATMAP_WRITE]);
+    }
+    fclose(fp);
+    log_info("debugger: memory profile written to %s", memprof_fn);
+}
+
 #ifdef WIN32
 #include <windows.h>
 #include <wingdi.h>
@@ -205,18 +243,19 @@ static inline void debug_cons_close(void) {}
 
 #endif
 
-#include <errno.h>
 #include "6502.h"
 #include "via.h"
 #include "sysvia.h"
 #include "uservia.h"
 #include "video.h"
 #include "sn76489.h"
+#include "sound.h"
 #include "model.h"
 
 void debug_kill()
 {
     close_trace();
+    debug_memprofile_save();
     debug_memview_close();
     debug_cons_close();
 }
@@ -296,6 +335,8 @@ void debug_toggle_tube(void)
 }
 
 int readc[65536], writec[65536], fetchc[65536];
+int debug_heatmap = 0;
+uint64_t heatmap_pages[256][3];
 
 static uint32_t debug_memaddr=0;
 static uint32_t debug_disaddr=0;
@@ -339,6 +380,13 @@ static const char helptext[] =
     "    d [n]      - disassemble from address n\n"
     "    n          - step, but treat a called subroutine as one step\n"
     "    m [n]      - memory dump from address n\n"
+    "    perf       - print emulation speed and host load counters\n"
+    "    prof       - show the 32016 profiling state and hot spots\n"
+    "    prof on [n] - profile every nth 32016 instruction (default 1)\n"
+    "    prof off   - stop 32016 profiling\n"
+    "    prof reset - clear the 32016 profile counts\n"
+    "    prof csv fn  - write the 32016 profile to a CSV file\n"
+    "    prof json fn - write the 32016 profile to a JSON file\n"
     "    q          - force emulator exit\n"
     "    r          - print 6502 registers\n"
     "    r sysvia   - print System VIA registers\n"
@@ -417,6 +465,54 @@ static void list_points(int *table, const char *desc)
             debug_outf("    %s %i : %04X\n", desc, c, table[c]);
 }
 
+static void debug_profile_save(const char *fn, void (*write)(FILE *fp))
+{
+    FILE *fp;
+
+    if (!*fn)
+        debug_outf("    missing file name\n");
+    else if ((fp = fopen(fn, "w"))) {
+        write(fp);
+        fclose(fp);
+        debug_outf("    32016 profile written to %s\n", fn);
+    } else
+        debug_outf("    unable to open profile file '%s' for writing: %s\n", fn, strerror(errno));
+}
+
+static void debug_profile(char *arg)
+{
+    char *eptr, *fn;
+    unsigned interval = 1;
+    char buf[1024];
+
+    if ((eptr = strchr(arg, '\n')))
+        *eptr = '\0';
+    for (fn = arg; *fn && !isspace(*fn); fn++)
+        ;
+    while (isspace(*fn))
+        fn++;
+
+    if (!strncasecmp(arg, "on", 2)) {
+        if (*fn)
+            sscanf(fn, "%u", &interval);
+        if (ProfileStart(interval))
+            debug_outf("    32016 profiling every %u instructions\n", interval ? interval : 1);
+        else
+            debug_outf("    out of memory for the 32016 profile\n");
+    } else if (!strncasecmp(arg, "off", 3)) {
+        ProfileStop();
+        debug_outf("    32016 profiling stopped\n");
+    } else if (!strncasecmp(arg, "reset", 5)) {
+        ProfileInit();
+        debug_outf("    32016 profile cleared\n");
+    } else if (!strncasecmp(arg, "csv", 3))
+        debug_profile_save(fn, ProfileWriteCSV);
+    else if (!strncasecmp(arg, "json", 4))
+        debug_profile_save(fn, ProfileWriteJSON);
+    else
+        debug_out(buf, ProfileFormat(buf, sizeof buf, 20));
+}
+
 void debugger_do(cpu_debug_t *cpu, uint32_t addr)
 {
     int c, d, e, f;
@@ -547,6 +643,15 @@ void debugger_do(cpu_debug_t *cpu, uint32_t addr)
                 main_resume();
                 return;
 
+            case 'p':
+            case 'P':
+                if (!strcasecmp(cmd, "perf")) {
+                    char perf[512];
+                    debug_out(perf, perf_format(perf, sizeof perf));
+                } else if (!strcasecmp(cmd, "prof"))
+                    debug_profile(iptr);
+                break;
+
             case 'r':
             case 'R':
                 if (!strcasecmp(cmd, "reset")) {
@@ -554,6 +659,7 @@ void debugger_do(cpu_debug_t *cpu, uint32_t addr)
                     debug_outf("Emulator reset\n");
                 } else if (*iptr) {
                     if (!strncasecmp(iptr, "sysvia", 6)) {
+                        via_sync(&sysvia);
                         debug_outf("    System VIA registers :\n");
                         debug_outf("    ORA  %02X ORB  %02X IRA %02X IRB %02X\n", sysvia.ora, sysvia.orb, sysvia.ira, sysvia.irb);
                         debug_outf("    DDRA %02X DDRB %02X ACR %02X PCR %02X\n", sysvia.ddra, sysvia.ddrb, sysvia.acr, sysvia.pcr);
@@ -561,6 +667,7 @@ void debugger_do(cpu_debug_t *cpu, uint32_t addr)
                         debug_outf("    Timer 2 latch %04X   count %04X\n", sysvia.t2l / 2, (sysvia.t2c / 2) & 0xFFFF);
                         debug_outf("    IER %02X IFR %02X\n", sysvia.ier, sysvia.ifr);
                     } else if (!strncasecmp(iptr, "uservia", 7)) {
+                        via_sync(&uservia);
                         debug_outf("    User VIA registers :\n");
                         debug_outf("    ORA  %02X ORB  %02X IRA %02X IRB %02X\n", uservia.ora, uservia.orb, uservia.ira, uservia.irb);
                         debug_outf("    DDRA %02X DDRB %02X ACR %02X PCR %02X\n", uservia.ddra, uservia.ddrb, uservia.acr, uservia.pcr);
@@ -568,6 +675,7 @@ void debugger_do(cpu_debug_t *cpu, uint32_t addr)
                         debug_outf("    Timer 2 latch %04X   count %04X\n", uservia.t2l / 2, (uservia.t2c / 2) & 0xFFFF);
                         debug_outf("    IER %02X IFR %02X\n", uservia.ier, uservia.ifr);
                     } else if (!strncasecmp(iptr, "crtc", 4)) {
+                        video_sync();
                         debug_outf("    CRTC registers :\n");
                         debug_outf("    Index=%i\n", crtc_i);
                         debug_outf("    R0 =%02X  R1 =%02X  R2 =%02X  R3 =%02X  R4 =%02X  R5 =%02X  R6 =%02X  R7 =%02X  R8 =%02X\n", crtc[0], crtc[1], crtc[2], crtc[3], crtc[4], crtc[5], crtc[6], crtc[7], crtc[8]);
@@ -589,6 +697,7 @@ void debugger_do(cpu_debug_t *cpu, uint32_t addr)
                         debug_outf("     Palette Mode=%01X  Horizontal Offset=%01X  Left Blank Size=%01X  Disable=%01X  Attribute Mode=%01X  Attribute Text=%01X\n", nula_palette_mode, nula_horizontal_offset, nula_left_blank, nula_disable, nula_attribute_mode, nula_attribute_text);
                     }
                     if (!strncasecmp(iptr, "sound", 5)) {
+                        sound_sync();
                         debug_outf("    Sound registers :\n");
                         debug_outf("    Voice 0 frequency = %04X   volume = %i  control = %02X\n", sn_latch[0] >> 6, sn_vol[0], sn_noise);
                         debug_outf("    Voice 1 frequency = %04X   volume = %i\n", sn_latch[1] >> 6, sn_vol[1]);
@@ -9,6 +9,31 @@ extern void debug_toggle_tube(void);
 
 extern int readc[65536], writec[65536], fetchc[65536];
 
+/*
+ * The memory access heat map is only recorded while something wants
+ * it: the memory view window, which shows recent accesses, or a
+ * profile of accesses per page to be written out at exit.  While
+ * neither is active the core 6502 skips it altogether.
+ */
+
+#define HEATMAP_VIEW    1
+#define HEATMAP_PROFILE 2
+
+enum { HEATMAP_FETCH, HEATMAP_READ, HEATMAP_WRITE };
+
+extern int debug_heatmap;
+extern uint64_t heatmap_pages[256][3];
+
+extern void debug_memprofile(const char *fn);
+
+static inline void debug_heatmap_access(int *heat, int kind, uint16_t addr)
+{
+    if (debug_heatmap & HEATMAP_VIEW)
+        heat[addr] = 31;
+    if (debug_heatmap & HEATMAP_PROFILE)
+        heatmap_pages[addr >> 8][kind]++;
+}
+
 extern int debug_core,debug_tube,debug_step;
 
 #endif
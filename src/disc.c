@@ -9,6 +9,8 @@
 #include "disc.h"
 
 #include "ddnoise.h"
+#include "perf.h"
+#include "sched.h"
 
 DRIVE drives[2];
 
@@ -18,12 +20,62 @@ ALLEGRO_PATH *discfns[2] = { NULL, NULL };
 int defaultwriteprot = 0;
 int writeprot[NUM_DRIVES], fwriteprot[NUM_DRIVES];
 
-int fdc_time;
-int disc_time;
-
 int motorspin;
 int motoron;
 
+/*
+ * Time for the FDC callback and the disc poll only passes while the
+ * motor is on so, while it is off, the time left on each is parked
+ * in these and the events are taken off the schedule.
+ */
+
+static int fdc_time;
+static int disc_time;
+
+static void fdc_event_cb(void)
+{
+    fdc_callback();
+}
+
+static void disc_event_cb(void);
+
+static sched_event_t fdc_event = SCHED_EVENT("fdc", fdc_event_cb);
+static sched_event_t disc_event = SCHED_EVENT("disc", disc_event_cb);
+
+static void disc_event_cb(void)
+{
+    sched_at(&disc_event, disc_event.when + 16);
+    PERF_TIME(disc_poll, disc_poll());
+}
+
+void fdc_settime(int t)
+{
+    fdc_time = t;
+    if (motoron) {
+        if (t)
+            sched_add(&fdc_event, t);
+        else
+            sched_cancel(&fdc_event);
+    }
+}
+
+void disc_motor(int on)
+{
+    if (on && !motoron) {
+        motoron = 1;
+        if (fdc_time)
+            sched_add(&fdc_event, fdc_time);
+        sched_add(&disc_event, disc_time);
+    }
+    else if (!on && motoron) {
+        motoron = 0;
+        fdc_time = sched_remaining(&fdc_event);
+        disc_time = sched_remaining(&disc_event);
+        sched_cancel(&fdc_event);
+        sched_cancel(&disc_event);
+    }
+}
+
 void (*fdc_callback)();
 void (*fdc_data)(uint8_t dat);
 void (*fdc_spindown)();
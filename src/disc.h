@@ -32,8 +32,6 @@ void disc_format(int drive, int track, int side, int density);
 void disc_abort(int drive);
 int disc_verify(int drive, int track, int density);
 
-extern int disc_time;
-
 extern void (*fdc_callback)(void);
 extern void (*fdc_data)(uint8_t dat);
 extern void (*fdc_spindown)(void);
@@ -43,7 +41,8 @@ extern void (*fdc_datacrcerror)(void);
 extern void (*fdc_headercrcerror)(void);
 extern void (*fdc_writeprotect)(void);
 extern int  (*fdc_getdata)(int last);
-extern int fdc_time;
+void fdc_settime(int t);
+void disc_motor(int on);
 
 extern int motorspin;
 extern int motoron;
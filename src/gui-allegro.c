@@ -15,11 +15,13 @@
 #include "model.h"
 #include "mouse.h"
 #include "music5000.h"
+#include "perf.h"
 #include "savestate.h"
 #include "sid_b-em.h"
 #include "scsi.h"
 #include "sdf.h"
 #include "sound.h"
+#include "soundfeed.h"
 #include "sn76489.h"
 #include "tape.h"
 #include "tapecat-allegro.h"
@@ -107,6 +109,7 @@ static ALLEGRO_MENU *create_file_menu(void)
     al_append_menu_item(menu, "Save Screenshot...", IDM_FILE_SCREEN_SHOT, 0, NULL, NULL);
     add_checkbox_item(menu, "Print to file", IDM_FILE_PRINT, prt_fp);
     add_checkbox_item(menu, "Record Hybrid Music System to file", IDM_FILE_M5000, music5000_fp);
+    add_checkbox_item(menu, "Record sound to file", IDM_FILE_SOUND, soundfeed_fp);
     al_append_menu_item(menu, "Exit", IDM_FILE_EXIT, 0, NULL, NULL);
     return menu;
 }
@@ -323,6 +326,7 @@ static ALLEGRO_MENU *create_sid_menu(void)
 }
 
 static const char *wave_names[] = { "Square", "Saw", "Sine", "Triangle", "SID", NULL };
+static const char *quality_names[] = { "Fast", "Normal", "High", NULL };
 static const char *dd_type_names[] = { "5.25\"", "3.5\"", NULL };
 static const char *dd_noise_vols[] = { "33%", "66%", "100%", NULL };
 
@@ -340,6 +344,9 @@ static ALLEGRO_MENU *create_sound_menu(void)
     sub = al_create_menu();
     add_radio_set(sub, wave_names, IDM_WAVE, curwave);
     al_append_menu_item(menu, "Internal waveform", 0, 0, NULL, sub);
+    sub = al_create_menu();
+    add_radio_set(sub, quality_names, IDM_SOUND_QUALITY, sn_quality);
+    al_append_menu_item(menu, "Internal sound quality", 0, 0, NULL, sub);
     al_append_menu_item(menu, "reSID configuration", 0, 0, NULL, create_sid_menu());
     sub = al_create_menu();
     add_radio_set(sub, dd_type_names, IDM_DISC_TYPE, ddnoise_type);
@@ -447,6 +454,9 @@ static ALLEGRO_MENU *create_debug_menu(void)
     add_checkbox_item(menu, "Debugger", IDM_DEBUGGER, debug_core);
     add_checkbox_item(menu, "Debug Tube", IDM_DEBUG_TUBE, debug_tube);
     al_append_menu_item(menu, "Break", IDM_DEBUG_BREAK, 0, NULL, NULL);
+    al_append_menu_item(menu, "Performance counters...", IDM_PERF_SHOW, 0, NULL, NULL);
+    add_checkbox_item(menu, "Show speed in title", IDM_PERF_TITLE, perf_title);
+    add_checkbox_item(menu, "Time emulator functions", IDM_PERF_TIMING, perf_timing);
     return menu;
 }
 
@@ -563,6 +573,25 @@ static void m5000_rec(ALLEGRO_EVENT *event)
     }
 }
 
+static void sound_rec(ALLEGRO_EVENT *event)
+{
+    ALLEGRO_FILECHOOSER *chooser;
+    ALLEGRO_DISPLAY *display;
+
+    if (soundfeed_fp)
+        soundfeed_rec_stop();
+    else if ((chooser = al_create_native_file_dialog(savestate_name, "Record sound to file", "*.wav", ALLEGRO_FILECHOOSER_SAVE))) {
+        display = (ALLEGRO_DISPLAY *)(event->user.data2);
+        while (al_show_native_file_dialog(display, chooser)) {
+            if (al_get_native_file_dialog_count(chooser) <= 0)
+                break;
+            if (soundfeed_rec_start(al_get_native_file_dialog_path(chooser, 0)))
+                break;
+        }
+        al_destroy_native_file_dialog(chooser);
+    }
+}
+
 static void edit_print_clip(ALLEGRO_EVENT *event)
 {
     ALLEGRO_DISPLAY *display;
@@ -904,6 +933,15 @@ static void change_ddnoise_dtype(ALLEGRO_EVENT *event)
     ddnoise_init();
 }
 
+static void perf_show(ALLEGRO_EVENT *event)
+{
+    ALLEGRO_DISPLAY *display = (ALLEGRO_DISPLAY *)(event->user.data2);
+    char text[512];
+
+    perf_format(text, sizeof text);
+    al_show_native_message_box(display, "B-Em", "Performance counters", text, NULL, 0);
+}
+
 static const char all_dext[] = "*.ssd;*.dsd;*.img;*.adf;*.ads;*.adm;*.adl;*.sdd;*.ddd;*.fdi";
 
 void gui_allegro_event(ALLEGRO_EVENT *event)
@@ -930,6 +968,9 @@ void gui_allegro_event(ALLEGRO_EVENT *event)
         case IDM_FILE_M5000:
             m5000_rec(event);
             break;
+        case IDM_FILE_SOUND:
+            sound_rec(event);
+            break;
         case IDM_FILE_EXIT:
             quitting = true;
             break;
@@ -1072,6 +1113,9 @@ void gui_allegro_event(ALLEGRO_EVENT *event)
         case IDM_WAVE:
             curwave = radio_event_simple(event, curwave);
             break;
+        case IDM_SOUND_QUALITY:
+            sn_quality = radio_event_simple(event, sn_quality);
+            break;
         case IDM_SID_TYPE:
             set_sid_type(event);
             break;
@@ -1136,6 +1180,15 @@ void gui_allegro_event(ALLEGRO_EVENT *event)
         case IDM_DEBUG_BREAK:
             debug_step = 1;
             break;
+        case IDM_PERF_SHOW:
+            perf_show(event);
+            break;
+        case IDM_PERF_TITLE:
+            perf_title = !perf_title;
+            break;
+        case IDM_PERF_TIMING:
+            perf_timing = !perf_timing;
+            break;
         case IDM_KEY_REDEFINE:
             gui_keydefine_open();
             break;
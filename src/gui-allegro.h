@@ -9,6 +9,7 @@ typedef enum {
     IDM_FILE_SCREEN_SHOT,
     IDM_FILE_PRINT,
     IDM_FILE_M5000,
+    IDM_FILE_SOUND,
     IDM_FILE_EXIT,
     IDM_EDIT_PASTE,
     IDM_EDIT_COPY,
@@ -59,6 +60,7 @@ typedef enum {
     IDM_SOUND_TAPE,
     IDM_SOUND_FILTER,
     IDM_WAVE,
+    IDM_SOUND_QUALITY,
     IDM_SID_TYPE,
     IDM_SID_METHOD,
     IDM_DISC_TYPE,
@@ -86,7 +88,10 @@ typedef enum {
     IDM_SPEED,
     IDM_DEBUGGER,
     IDM_DEBUG_TUBE,
-    IDM_DEBUG_BREAK
+    IDM_DEBUG_BREAK,
+    IDM_PERF_SHOW,
+    IDM_PERF_TITLE,
+    IDM_PERF_TIMING
 } menu_id_t;
 
 extern void gui_allegro_init(ALLEGRO_EVENT_QUEUE *queue, ALLEGRO_DISPLAY *display);
@@ -63,7 +63,7 @@ void i8271_reset()
         i8271.paramnum = i8271.paramreq = 0;
         i8271.status = 0;
 //        printf("Reset 8271\n");
-        fdc_time = 0;
+        fdc_settime(0);
         i8271.curtrack[0] = i8271.curtrack[1] = 0;
         i8271.command = 0xFF;
         i8271.realtrack[0] = i8271.realtrack[1] = 0;
@@ -83,7 +83,7 @@ static void i8271_NMI()
 void i8271_spinup()
 {
     if (!motoron) {
-        motoron = 1;
+        disc_motor(1);
         motorspin = 0;
         ddnoise_spinup();
     }
@@ -92,7 +92,7 @@ void i8271_spinup()
 void i8271_spindown()
 {
     if (motoron) {
-        motoron = 0;
+        disc_motor(0);
         ddnoise_spindown();
     }
     i8271.drvout &= ~DRIVESEL;
@@ -106,7 +106,7 @@ void i8271_setspindown()
 static void short_spindown(void)
 {
     motorspin = 15000;
-    fdc_time = 0;
+    fdc_settime(0);
 }
 
 int params[][2]=
@@ -199,7 +199,7 @@ void i8271_write(uint16_t addr, uint8_t val)
                                 i8271.result = 0x18;
                                 i8271.status = 0x18;
                                 i8271_NMI();
-                                fdc_time = 0;
+                                fdc_settime(0);
                                 break;
 //                                printf("Unknown 8271 command %02X 3\n",i8271.command);
 //                                dumpregs();
@@ -221,7 +221,7 @@ void i8271_write(uint16_t addr, uint8_t val)
                                 i8271_spinup();
                                 i8271.phase = 0;
                                 if (i8271.curtrack[curdrive] != i8271.params[0]) i8271_seek();
-                                else                                             fdc_time = 200;
+                                else                                             fdc_settime(200);
                                 break;
                             case 0x13: /*Read sector*/
                                 i8271.sectorsleft = i8271.params[2] & 31;
@@ -229,7 +229,7 @@ void i8271_write(uint16_t addr, uint8_t val)
                                 i8271_spinup();
                                 i8271.phase = 0;
                                 if (i8271.curtrack[curdrive] != i8271.params[0]) i8271_seek();
-                                else                                             fdc_time = 200;
+                                else                                             fdc_settime(200);
                                 break;
                             case 0x1F: /*Verify sector*/
                                 i8271.sectorsleft = i8271.params[2] & 31;
@@ -237,7 +237,7 @@ void i8271_write(uint16_t addr, uint8_t val)
                                 i8271_spinup();
                                 i8271.phase = 0;
                                 if (i8271.curtrack[curdrive] != i8271.params[0]) i8271_seek();
-                                else                                             fdc_time = 200;
+                                else                                             fdc_settime(200);
                                 i8271_verify = 1;
                                 break;
                             case 0x1B: /*Read ID*/
@@ -246,13 +246,13 @@ void i8271_write(uint16_t addr, uint8_t val)
                                 i8271_spinup();
                                 i8271.phase = 0;
                                 if (i8271.curtrack[curdrive] != i8271.params[0]) i8271_seek();
-                                else                                             fdc_time = 200;
+                                else                                             fdc_settime(200);
                                 break;
                             case 0x23: /*Format track*/
                                 i8271_spinup();
                                 i8271.phase = 0;
                                 if (i8271.curtrack[curdrive] != i8271.params[0]) i8271_seek();
-                                else                                             fdc_time = 200;
+                                else                                             fdc_settime(200);
                                 break;
                                 break;
                             case 0x29: /*Seek*/
@@ -276,7 +276,7 @@ void i8271_write(uint16_t addr, uint8_t val)
                                         i8271.result = 0x18;
                                         i8271.status = 0x18;
                                         i8271_NMI();
-                                        fdc_time = 0;
+                                        fdc_settime(0);
                                         break;
 //                                        default:
 //                                        printf("8271 Write bad special register %02X\n",i8271.params[0]);
@@ -297,7 +297,7 @@ void i8271_write(uint16_t addr, uint8_t val)
                                         i8271.result = 0x18;
                                         i8271.status = 0x18;
                                         i8271_NMI();
-                                        fdc_time = 0;
+                                        fdc_settime(0);
                                         break;
 //                                        default:
 //                                        printf("8271 Read bad special register %02X\n",i8271.params[0]);
@@ -310,7 +310,7 @@ void i8271_write(uint16_t addr, uint8_t val)
                                 i8271.result = 0x18;
                                 i8271.status = 0x18;
                                 i8271_NMI();
-                                fdc_time = 0;
+                                fdc_settime(0);
                                 break;
 //                                printf("Unknown 8271 command %02X 2\n",i8271.command);
 //                                dumpregs();
@@ -334,7 +334,7 @@ void i8271_write(uint16_t addr, uint8_t val)
 
 void i8271_callback()
 {
-        fdc_time = 0;
+        fdc_settime(0);
 //        printf("Callback 8271 - command %02X\n",i8271.command);
         switch (i8271.command)
         {
@@ -481,7 +481,7 @@ void i8271_data(uint8_t dat)
 
 void i8271_finishread()
 {
-        fdc_time = 200;
+        fdc_settime(200);
 }
 
 void i8271_notfound()
@@ -3,9 +3,11 @@
 #include <stdio.h>
 #include "b-em.h"
 #include "ide.h"
+#include "sched.h"
 
 bool ide_enable;
-int ide_count;
+
+static sched_event_t ide_event = SCHED_EVENT("ide", ide_callback);
 
 static struct
 {
@@ -57,7 +59,7 @@ void ide_init(void)
 {
         ide.pos2 = 1;
         ide.atastat = 0x40;
-        ide_count = 0;
+        sched_cancel(&ide_event);
 
         ide_open_hd(0, "hd4");
         ide_open_hd(1, "hd5");
@@ -88,7 +90,7 @@ void ide_write(uint16_t addr, uint8_t val)
                 {
                         ide.pos = 0;
                         ide.atastat  = 0x80;
-                        ide_count = 1000;
+                        sched_add(&ide_event, 640);
                 }
                 return;
             case 0x8:
@@ -122,11 +124,11 @@ void ide_write(uint16_t addr, uint8_t val)
                     case 0x10: /*Restore*/
                     case 0x70: /*Seek*/
                         ide.atastat  = 0x40;
-                        ide_count = 100;
+                        sched_add(&ide_event, 128);
                         return;
                     case 0x20: /*Read sector*/
                         ide.atastat  = 0x80;
-                        ide_count = 200;
+                        sched_add(&ide_event, 128);
                         autoboot = 0;
                         return;
                     case 0x30: /*Write sector*/
@@ -135,7 +137,7 @@ void ide_write(uint16_t addr, uint8_t val)
                         return;
                     case 0x40: /*Read verify*/
                         ide.atastat  = 0x80;
-                        ide_count = 200;
+                        sched_add(&ide_event, 128);
                         return;
                     case 0x50: /*Format track*/
                         ide.atastat = 0x08;
@@ -143,16 +145,16 @@ void ide_write(uint16_t addr, uint8_t val)
                         return;
                     case 0x91: /*Set parameters*/
                         ide.atastat  = 0x80;
-                        ide_count = 200;
+                        sched_add(&ide_event, 128);
                         return;
                     case 0xA1: /*Identify packet device*/
                     case 0xE3: /*Idle*/
                         ide.atastat  = 0x80;
-                        ide_count = 200;
+                        sched_add(&ide_event, 128);
                         return;
                     case 0xEC: /*Identify device*/
                         ide.atastat  = 0x80;
-                        ide_count = 200;
+                        sched_add(&ide_event, 128);
                         return;
                 }
                 log_debug("Bad IDE command %02X\n", val);
@@ -197,7 +199,7 @@ uint8_t ide_read(uint16_t addr)
                                                 }
                                         }
                                         ide.atastat  = 0x80;
-                                        ide_count = 200;
+                                        sched_add(&ide_event, 128);
                                 }
                         }
                 }
@@ -2,7 +2,6 @@
 #define __INC_IDE_H
 
 extern bool ide_enable;
-extern int ide_count;
 
 void ide_init(void);
 void ide_close(void);
@@ -2,6 +2,7 @@
 
 #include "b-em.h"
 #include "config.h"
+#include "main.h"
 
 #include <allegro5/allegro_native_dialog.h>
 #include <errno.h>
@@ -106,6 +107,8 @@ static void log_format(const log_level_t *ll, const char *fmt, va_list ap)
 
     if ((opt = log_options & ll->mask)) {
         dest = opt >> ll->shift;
+        if (headless && (dest & LOG_DEST_MSGBOX))
+            dest = (dest & ~LOG_DEST_MSGBOX) | LOG_DEST_STDERR;
         va_copy(apc, ap);
         len = vsnprintf(abuf, sizeof abuf, fmt, ap);
         if (len < sizeof abuf)
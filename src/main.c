@@ -6,6 +6,8 @@
 #include <allegro5/allegro_acodec.h>
 #include <allegro5/allegro_image.h>
 #include <allegro5/allegro_native_dialog.h>
+#include <inttypes.h>
+#include <signal.h>
 
 #include "6502.h"
 #include "adc.h"
@@ -30,12 +32,14 @@
 #include "music4000.h"
 #include "music5000.h"
 #include "pal.h"
+#include "perf.h"
 #include "savestate.h"
 #include "scsi.h"
 #include "serial.h"
 #include "sid_b-em.h"
 #include "sn76489.h"
 #include "sound.h"
+#include "soundfeed.h"
 #include "sysacia.h"
 #include "tape.h"
 #include "tapecat-allegro.h"
@@ -61,6 +65,7 @@
 #undef printf
 
 bool quitting = false;
+bool headless = false;
 int autoboot=0;
 int joybutton[2];
 float joyaxes[4];
@@ -77,6 +82,11 @@ typedef enum {
 } fspeed_type_t;
 
 static double time_limit;
+static uint64_t run_frames, run_cycles;
+static int bench_nula;
+static const char *m5_trace_fn, *m5_verify_fn;
+static const char *dump_ram_fn, *dump_screen_fn, *dump_state_fn;
+static int exit_status = 0;
 static int fcount = 0;
 static fspeed_type_t fullspeed = FSPEED_NONE;
 static bool bempause  = false;
@@ -131,7 +141,24 @@ static const char helptext[] =
     "-s              - scanlines display mode\n"
     "-i              - interlace display mode\n"
     "-debug          - start debugger\n"
-    "-debugtube      - start debugging tube processor\n\n";
+    "-debugtube      - start debugging tube processor\n"
+    "-headless       - run without display, sound or keyboard\n"
+    "-run-frames n   - run n frames as fast as possible then exit\n"
+    "-run-cycles n   - run n 2MHz cycles as fast as possible then exit\n"
+    "-bench-nula n   - time rendering n NULA attribute mode frames then exit\n"
+    "-m5-trace f     - record Music 5000 register writes to file f\n"
+    "-m5-verify f    - check the Music 5000 synth against trace file f then exit\n"
+    "-dump-ram f     - write main RAM to file f on exit\n"
+    "-dump-screen f  - write a screenshot to file f on exit\n"
+    "-dump-state f   - write a savestate to file f on exit\n"
+    "-mem-profile f  - write 6502 accesses per memory page to file f on exit\n\n";
+
+static volatile sig_atomic_t quit_signal = 0;
+
+static void main_sigquit(int sig)
+{
+    quit_signal = 1;
+}
 
 void main_init(int argc, char *argv[])
 {
@@ -168,6 +195,12 @@ void main_init(int argc, char *argv[])
             discnext = 1;
         else if (!strcasecmp(argv[c], "-disc1"))
             discnext = 2;
+        else if (!strcasecmp(argv[c], "-mem-profile") && c+1 < argc)
+            debug_memprofile(argv[++c]);
+        else if (!strcasecmp(argv[c], "-m5-trace") && c+1 < argc)
+            m5_trace_fn = argv[++c];
+        else if (!strcasecmp(argv[c], "-m5-verify") && c+1 < argc)
+            m5_verify_fn = argv[++c];
         else if (argv[c][0] == '-' && (argv[c][1] == 'm' || argv[c][1] == 'M'))
             sscanf(&argv[c][2], "%i", &curmodel);
         else if (argv[c][0] == '-' && (argv[c][1] == 't' || argv[c][1] == 'T'))
@@ -187,6 +220,20 @@ void main_init(int argc, char *argv[])
             debug_core = 1;
         else if (!strcasecmp(argv[c], "-debugtube"))
             debug_tube = 1;
+        else if (!strcasecmp(argv[c], "-headless"))
+            headless = true;
+        else if (!strcasecmp(argv[c], "-run-frames") && c+1 < argc)
+            run_frames = strtoull(argv[++c], NULL, 0);
+        else if (!strcasecmp(argv[c], "-run-cycles") && c+1 < argc)
+            run_cycles = strtoull(argv[++c], NULL, 0);
+        else if (!strcasecmp(argv[c], "-bench-nula") && c+1 < argc)
+            bench_nula = atoi(argv[++c]);
+        else if (!strcasecmp(argv[c], "-dump-ram") && c+1 < argc)
+            dump_ram_fn = argv[++c];
+        else if (!strcasecmp(argv[c], "-dump-screen") && c+1 < argc)
+            dump_screen_fn = argv[++c];
+        else if (!strcasecmp(argv[c], "-dump-state") && c+1 < argc)
+            dump_state_fn = argv[++c];
         else if (argv[c][0] == '-' && (argv[c][1] == 'i' || argv[c][1] == 'I')) {
             vid_interlace = 1;
             vid_linedbl = vid_scanlines = 0;
@@ -230,31 +277,34 @@ void main_init(int argc, char *argv[])
 
     mem_init();
 
-    if (!(queue = al_create_event_queue())) {
-        log_fatal("main: unable to create event queue");
-        exit(1);
-    }
-    al_register_event_source(queue, al_get_display_event_source(display));
+    if (!headless) {
+        if (!(queue = al_create_event_queue())) {
+            log_fatal("main: unable to create event queue");
+            exit(1);
+        }
+        al_register_event_source(queue, al_get_display_event_source(display));
 
-    if (!al_install_audio()) {
-        log_fatal("main: unable to initialise audio");
-        exit(1);
-    }
-    if (!al_reserve_samples(3)) {
-        log_fatal("main: unable to reserve audio samples");
-        exit(1);
-    }
-    if (!al_init_acodec_addon()) {
-        log_fatal("main: unable to initialise audio codecs");
-        exit(1);
-    }
+        if (!al_install_audio()) {
+            log_fatal("main: unable to initialise audio");
+            exit(1);
+        }
+        if (!al_init_acodec_addon()) {
+            log_fatal("main: unable to initialise audio codecs");
+            exit(1);
+        }
 
-    sound_init();
+        soundfeed_init();
+        sound_init();
+    }
     sid_init();
     sid_settype(sidmethod, cursid);
-    music5000_init(queue);
-    ddnoise_init();
-    tapenoise_init(queue);
+    if (!headless) {
+        music5000_init();
+        if (m5_trace_fn)
+            music5000_trace_start(m5_trace_fn);
+        ddnoise_init();
+        tapenoise_init(queue);
+    }
 
     adc_init();
 #ifdef WIN32
@@ -272,30 +322,36 @@ void main_init(int argc, char *argv[])
     midi_init();
     main_reset();
 
-    joystick_init(queue);
+    if (headless) {
+        signal(SIGINT, main_sigquit);
+        signal(SIGTERM, main_sigquit);
+    }
+    else {
+        joystick_init(queue);
 
-    gui_allegro_init(queue, display);
+        gui_allegro_init(queue, display);
 
-    time_limit = 2.0 / 50.0;
-    if (!(timer = al_create_timer(1.0 / 50.0))) {
-        log_fatal("main: unable to create timer");
-        exit(1);
-    }
-    al_register_event_source(queue, al_get_timer_event_source(timer));
-    al_init_user_event_source(&evsrc);
-    al_register_event_source(queue, &evsrc);
+        time_limit = 2.0 / 50.0;
+        if (!(timer = al_create_timer(1.0 / 50.0))) {
+            log_fatal("main: unable to create timer");
+            exit(1);
+        }
+        al_register_event_source(queue, al_get_timer_event_source(timer));
+        al_init_user_event_source(&evsrc);
+        al_register_event_source(queue, &evsrc);
 
-    if (!al_install_keyboard()) {
-        log_fatal("main: umable to install keyboard");
-        exit(1);
+        if (!al_install_keyboard()) {
+            log_fatal("main: umable to install keyboard");
+            exit(1);
+        }
+        al_register_event_source(queue, al_get_keyboard_event_source());
+
+        al_install_mouse();
+        al_register_event_source(queue, al_get_mouse_event_source());
     }
-    al_register_event_source(queue, al_get_keyboard_event_source());
 
     oldmodel = curmodel;
 
-    al_install_mouse();
-    al_register_event_source(queue, al_get_mouse_event_source());
-
     disc_load(0, discfns[0]);
     disc_load(1, discfns[1]);
     tape_load(tape_fn);
@@ -303,6 +359,7 @@ void main_init(int argc, char *argv[])
         writeprot[0] = writeprot[1] = 1;
 
     debug_start();
+    perf_reset();
 }
 
 void main_restart()
@@ -417,35 +474,118 @@ static void main_key_up(ALLEGRO_EVENT *event)
     key_up(code);
 }
 
+static void main_frame(void)
+{
+    if (autoboot)
+        autoboot--;
+    framesrun++;
+
+    if (x65c02)
+        m65c02_exec();
+    else
+        m6502_exec();
+    video_sync();
+    perf_frame(m6502_slice);
+
+    if (ddnoise_ticks > 0 && --ddnoise_ticks == 0)
+        ddnoise_headdown();
+
+    if (savestate_wantload)
+        savestate_doload();
+    if (savestate_wantsave)
+        savestate_dosave();
+}
+
 static void main_timer(ALLEGRO_EVENT *event)
 {
     double delay = al_get_time() - event->any.timestamp;
     if (delay < time_limit) {
-        if (autoboot)
-            autoboot--;
-        framesrun++;
+        main_frame();
+        if (fullspeed == FSPEED_RUNNING)
+            al_emit_user_event(&evsrc, event, NULL);
+    }
+}
 
-        if (x65c02)
-            m65c02_exec();
+static void main_dump(void)
+{
+    if (dump_ram_fn && !mem_dump_ram(dump_ram_fn))
+        exit_status = 1;
+    if (dump_screen_fn && !video_dump_screen(dump_screen_fn))
+        exit_status = 1;
+    if (dump_state_fn) {
+        savestate_save(dump_state_fn);
+        if (savestate_wantsave)
+            savestate_dosave();
         else
-            m6502_exec();
+            exit_status = 1;
+    }
+}
 
-        if (ddnoise_ticks > 0 && --ddnoise_ticks == 0)
-            ddnoise_headdown();
+static void main_run_batch(void)
+{
+    int slice = m6502_slice;
+    uint64_t frames = 0, cycles = 0;
 
-        if (savestate_wantload)
-            savestate_doload();
-        if (savestate_wantsave)
-            savestate_dosave();
-        if (fullspeed == FSPEED_RUNNING)
-            al_emit_user_event(&evsrc, event, NULL);
+    log_debug("main: entering batch loop");
+    while (!quitting && !quit_signal) {
+        if (run_frames && frames >= run_frames)
+            break;
+        if (run_cycles) {
+            if (cycles >= run_cycles)
+                break;
+            if (run_cycles - cycles < slice)
+                m6502_slice = run_cycles - cycles;
+        }
+        main_frame();
+        frames++;
+        cycles += m6502_slice;
+    }
+    m6502_slice = slice;
+    if (quit_signal)
+        quitting = true;
+    log_info("main: batch run ended after %" PRIu64 " frames, %" PRIu64 " cycles", frames, cycles);
+    if (quitting && (run_frames || run_cycles)) {
+        log_warn("main: batch run stopped before reaching its limit");
+        exit_status = 2;
+    }
+    main_dump();
+}
+
+static void main_bench_nula(void)
+{
+    static const struct {
+        int mode;
+        bool text;
+    } runs[] = { { 0, false }, { 0, true }, { 1, false }, { 4, false }, { 4, true } };
+    double t;
+    int c;
+
+    for (c = 0; c < sizeof(runs) / sizeof(runs[0]); c++) {
+        t = video_bench_nula(bench_nula, runs[c].mode, runs[c].text);
+        printf("bench-nula: MODE %d%s, %d frames in %.3fs, %.1fus per frame\n", runs[c].mode,
+               runs[c].text ? " text" : "", bench_nula, t, t * 1e6 / bench_nula);
     }
+    main_dump();
 }
 
 void main_run()
 {
     ALLEGRO_EVENT event;
 
+    if (bench_nula > 0) {
+        main_bench_nula();
+        return;
+    }
+    if (m5_verify_fn) {
+        if (!music5000_verify(m5_verify_fn))
+            exit_status = 1;
+        return;
+    }
+    if (headless || run_frames || run_cycles) {
+        main_run_batch();
+        return;
+    }
+
     log_debug("main: about to start timer");
     al_start_timer(timer);
 
@@ -491,9 +631,6 @@ void main_run()
                 gui_allegro_event(&event);
                 main_resume();
                 break;
-            case ALLEGRO_EVENT_AUDIO_STREAM_FRAGMENT:
-                music5000_streamfrag();
-                break;
             case ALLEGRO_EVENT_DISPLAY_RESIZE:
                 video_update_window_size(&event);
                 break;
@@ -508,8 +645,10 @@ void main_close()
     gui_keydefine_close();
 
     debug_kill();
+    soundfeed_close();
 
-    config_save();
+    if (!headless)
+        config_save();
     cmos_save(models[curmodel]);
 
     midi_close();
@@ -538,6 +677,8 @@ void main_close()
 void main_setspeed(int speed)
 {
     log_debug("main: setspeed %d", speed);
+    if (headless)
+        return;
     if (speed == EMU_SPEED_FULL)
         main_start_fullspeed();
     else {
@@ -560,12 +701,13 @@ void main_setspeed(int speed)
 
 void main_pause(void)
 {
-    al_stop_timer(timer);
+    if (!headless)
+        al_stop_timer(timer);
 }
 
 void main_resume(void)
 {
-    if (emuspeed != EMU_SPEED_PAUSED && emuspeed != EMU_SPEED_FULL)
+    if (!headless && emuspeed != EMU_SPEED_PAUSED && emuspeed != EMU_SPEED_FULL)
         al_start_timer(timer);
 }
 
@@ -579,5 +721,5 @@ int main(int argc, char **argv)
     main_init(argc, argv);
     main_run();
     main_close();
-    return 0;
+    return exit_status;
 }
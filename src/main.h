@@ -15,6 +15,7 @@ extern const emu_speed_t emu_speeds[NUM_EMU_SPEEDS];
 extern int emuspeed;
 
 extern bool quitting;
+extern bool headless;
 
 void main_init(int argc, char *argv[]);
 void main_softreset(void);
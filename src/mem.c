@@ -52,14 +52,20 @@ void mem_close() {
     if (os)  free(os);
 }
 
-static void dump_mem(void *start, size_t size, const char *which, const char *file) {
+static bool dump_mem(void *start, size_t size, const char *which, const char *file) {
     FILE *f;
+    bool ok;
 
     if ((f = fopen(file, "wb"))) {
-        fwrite(start, size, 1, f);
-        fclose(f);
-    } else
-        log_error("mem: unable to open %s dump file %s: %s", which, file, strerror(errno));
+        ok = fwrite(start, size, 1, f) == 1;
+        if (fclose(f))
+            ok = false;
+        if (!ok)
+            log_error("mem: error writing %s dump file %s: %s", which, file, strerror(errno));
+        return ok;
+    }
+    log_error("mem: unable to open %s dump file %s: %s", which, file, strerror(errno));
+    return false;
 }
 
 void mem_dump(void) {
@@ -67,6 +73,10 @@ void mem_dump(void) {
     dump_mem(rom, ROM_NSLOT*ROM_SIZE, "ROM", "rom.dmp");
 }
 
+bool mem_dump_ram(const char *file) {
+    return dump_mem(ram, RAM_SIZE, "RAM", file);
+}
+
 static void load_os_rom(const char *sect) {
     const char *osname, *cpath;
     FILE *f;
@@ -40,6 +40,7 @@ void mem_loadzlib(ZFILE *zfp);
 void mem_loadstate(FILE *f);
 
 void mem_dump(void);
+bool mem_dump_ram(const char *file);
 
 extern uint8_t ram_fe30, ram_fe34;
 extern uint8_t *ram, *rom, *os;
@@ -57,7 +57,7 @@ TUBE tubes[NUM_TUBES]=
     {"Z80",            tube_z80_init,   z80_reset,       &tubez80_cpu_debug,   "Z80_120",          6 },
     {"80186",          tube_x86_init,   x86_reset,       &tubex86_cpu_debug,   "BIOS",             8 },
     {"65816",          tube_65816_init, w65816_reset,    &tube65816_cpu_debug, "ReCo6502ROM_816", 16 },
-    {"32016",          tube_32016_init, n32016_reset,    &n32016_cpu_debug,    "",                 8 },
+    {"32016",          tube_32016_init, n32016_reset,    &n32016_cpu_debug,    "",                 6 },
     {"6502 External",  tube_6502_init,  tube_6502_reset, &tube6502_cpu_debug,  "6502Tube",         3 }
 };
 
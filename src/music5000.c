@@ -27,9 +27,11 @@
 #include <string.h>
 
 #include "b-em.h"
-#include <allegro5/allegro_audio.h>
 #include "sound.h"
 #include "savestate.h"
+#include "perf.h"
+#include "sched.h"
+#include "soundfeed.h"
 
 #define I_WAVEFORM(n) ((n)*128)
 #define I_WFTOP (14*128)
@@ -68,13 +70,24 @@ static struct synth m5000, m3000;
 size_t buflen_m5 = BUFLEN_M5;
 FILE *music5000_fp;
 
-static ALLEGRO_VOICE *voice;
-static ALLEGRO_MIXER *mixer;
-static ALLEGRO_AUDIO_STREAM *stream;
+static soundfeed_t *feed;
 static bool rec_started;
 
+static FILE *trace_fp;
+static unsigned long trace_sample;
+
+// The synth is run a block at a time as the 2MHz clock passes, at three
+// samples for each 128 cycles.
+#define M5_BLOCK        384
+#define M5_BLOCK_CYCLES (M5_BLOCK * 128 / 3)
+
+static void music5000_block(void);
+static sched_event_t music5000_event = SCHED_EVENT("music5000", music5000_block);
+
 static ushort antilogtable[128];
 
+static void update_6MHz(struct synth *s);
+
 static void synth_reset(struct synth *s)
 {
     memset(s->ram, 0, 2048);
@@ -96,8 +109,8 @@ void music5000_reset(void)
 
 static void synth_loadstate(struct synth *s, FILE *f, int pc)
 {
-    s->pc = pc;
-    s->channel = savestate_load_var(f);
+    s->pc = pc & 7;
+    s->channel = savestate_load_var(f) & 15;
     s->modulate = savestate_load_var(f);
     s->disable = savestate_load_var(f);
     s->sam = savestate_load_var(f);
@@ -105,6 +118,13 @@ static void synth_loadstate(struct synth *s, FILE *f, int pc)
     fread(s->phaseRAM, sizeof s->phaseRAM, 1, f);
     fread(s->sleft, sizeof s->sleft, 1, f);
     fread(s->sright, sizeof s->sright, 1, f);
+
+    // The synth is only ever saved between samples, at channel 0 step 0,
+    // which is where update_sample expects to start.  Should a state
+    // have been saved part way through a sample, finish that sample off a
+    // step at a time so there is only the one way of running it after.
+    while (s->channel || s->pc)
+        update_6MHz(s);
 }
 
 void music5000_loadstate(FILE *f) {
@@ -154,32 +174,23 @@ void music5000_savestate(FILE *f) {
         putc('m', f);
 }
 
-void music5000_init(ALLEGRO_EVENT_QUEUE *queue)
+static void music5000_maketables(void)
 {
     int n;
 
-    if ((voice = al_create_voice(FREQ_M5, ALLEGRO_AUDIO_DEPTH_INT16, ALLEGRO_CHANNEL_CONF_2))) {
-        if ((mixer = al_create_mixer(FREQ_M5, ALLEGRO_AUDIO_DEPTH_INT16, ALLEGRO_CHANNEL_CONF_2))) {
-            if (al_attach_mixer_to_voice(mixer, voice)) {
-                if ((stream = al_create_audio_stream(4, BUFLEN_M5, FREQ_M5, ALLEGRO_AUDIO_DEPTH_INT16, ALLEGRO_CHANNEL_CONF_2))) {
-                    if (al_attach_audio_stream_to_mixer(stream, mixer)) {
-                        al_register_event_source(queue, al_get_audio_stream_event_source(stream));
-                        for (n = 0; n < 128; n++) {
-                            //12-bit antilog as per AM6070 datasheet
-                            int S = n & 15, C = n >> 4;
-                            antilogtable[n] = (ushort)(2 * (pow(2.0, C)*(S + 16.5) - 16.5));
-                        }
-                        music5000_reset();
-                    } else
-                        log_error("sound: unable to attach stream to mixer for Music 5000");
-                } else
-                    log_error("sound: unable to create stream for Music 5000");
-            } else
-                log_error("sound: unable to attach mixer to voice for Music 5000");
-        } else
-            log_error("sound: unable to create mixer for Music 5000");
-    } else
-        log_error("sound: unable to create voice for Music 5000");
+    for (n = 0; n < 128; n++) {
+        //12-bit antilog as per AM6070 datasheet
+        int S = n & 15, C = n >> 4;
+        antilogtable[n] = (ushort)(2 * (pow(2.0, C)*(S + 16.5) - 16.5));
+    }
+}
+
+void music5000_init(void)
+{
+    if ((feed = soundfeed_create("music5000", FREQ_M5, 2, M5_BLOCK * 6)))
+        sched_add(&music5000_event, M5_BLOCK_CYCLES);
+    music5000_maketables();
+    music5000_reset();
 }
 
 FILE *music5000_rec_start(const char *filename)
@@ -233,10 +244,30 @@ void music5000_rec_stop(void)
     music5000_fp = NULL;
 }
 
+/*
+ * Record every write to the synth registers to a text file, one per
+ * line as the number of samples generated before it, the address and
+ * the value, all but the first in hex, for replaying with
+ * music5000_verify.
+ */
+bool music5000_trace_start(const char *filename)
+{
+    if (!(trace_fp = fopen(filename, "w"))) {
+        log_error("music5000: unable to open trace file %s for writing: %s", filename, strerror(errno));
+        return false;
+    }
+    trace_sample = 0;
+    return true;
+}
+
 void music5000_close(void)
 {
     if (music5000_fp)
         music5000_rec_stop();
+    if (trace_fp) {
+        fclose(trace_fp);
+        trace_fp = NULL;
+    }
 }
 
 static uint8_t page = 0;
@@ -262,6 +293,8 @@ static void ram_write(struct synth *s, uint16_t addr, uint8_t val)
 
 void music5000_write(uint16_t addr, uint8_t val)
 {
+    if (trace_fp)
+        fprintf(trace_fp, "%lu %04X %02X\n", trace_sample, addr, val);
     if (addr == 0xfcff)
         page = val;
     else {
@@ -380,6 +413,143 @@ static void update_6MHz(struct synth *s)
     }
 }
 
+/*
+ * Run all 16 channels for one sample, i.e. the same 128 steps as calling
+ * update_6MHz 128 times from channel 0, step 0, but a stage at a time
+ * across the channels rather than a channel at a time.
+ *
+ * Which of a channel's two sets of registers is used depends on whether
+ * the previous channel asked to modulate it, so the phase and waveform
+ * stages are done for both sets of every channel, as loops over
+ * consecutive registers, and only the choice and the remaining stages
+ * go channel by channel.  music5000_verify checks the two give
+ * identical results.
+ */
+static const byte pantable[16] = { 0, 0, 0, 0, 0, 0, 0, 0, 6, 6, 6, 5, 4, 3, 2, 1 };
+
+static void update_sample(struct synth *s)
+{
+    int phase[2][16], c4d[2][16], wave[2][16], modnext[2][16];
+    const byte *regs[2], *r;
+    int set, ch, mod, disable, sum, sam, sign, pan;
+
+    // The registers for one set of all 16 channels are consecutive.
+    regs[0] = s->ram + I_CHAN(0);
+    regs[1] = s->ram + I_CHAN(1);
+
+    // Phase accumulator and waveform lookup for both register sets.
+    for (set = 0; set < 2; set++) {
+        r = regs[set];
+        for (ch = 0; ch < 16; ch++) {
+            sum = s->phaseRAM[ch] + ((r[ch + 0x20] << 16) | (r[ch + 0x10] << 8) | (r[ch] & 0x7e));
+            phase[set][ch] = (r[ch] & 1) ? 0 : sum & 0xffffff;
+            c4d[set][ch] = (r[ch] & 1) ? 0 : sum >> 24;
+        }
+        for (ch = 0; ch < 16; ch++) {
+            wave[set][ch] = s->ram[I_WAVEFORM(r[ch + 0x50] >> 4) + (phase[set][ch] >> 17)];
+            modnext[set][ch] = (r[ch + 0x70] & 0x20) && ((wave[set][ch] & 0x80) || c4d[set][ch]);
+        }
+    }
+
+    // Follow the modulation from channel to channel and finish off each
+    // channel with the register set chosen, as in steps 6 and 7.
+    mod = s->modulate;
+    for (ch = 0; ch < 16; ch++) {
+        set = mod;
+        r = regs[set];
+        mod = modnext[set][ch];
+        s->phaseRAM[ch] = phase[set][ch];
+        sign = wave[set][ch] & 0x80;
+        sam = wave[set][ch] + r[ch + 0x60];
+        if ((sign ^ sam) & 0x80)
+            sam &= 0x7f;
+        else
+            sam = 0;
+        if (r[ch + 0x70] & 0x10)
+            sign ^= 0x80;
+        sam = sign ? antilogtable[sam] : -antilogtable[sam];
+        disable = r[ch] & 1;
+        if (disable)
+            s->sleft[ch] = s->sright[ch] = 0;
+        else {
+            pan = pantable[r[ch + 0x70] & 0xf];
+            s->sleft[ch] = (sam * pan) / 6;
+            s->sright[ch] = (sam * (6 - pan)) / 6;
+        }
+    }
+    s->modulate = mod;
+
+    // Leave what the last step would have left behind.
+    s->disable = disable;
+    s->c4d = c4d[set][15];
+    s->sign = sign;
+    s->sam = sam;
+}
+
+static bool synth_matches(const struct synth *a, const struct synth *b)
+{
+    return a->modulate == b->modulate
+        && !memcmp(a->sleft, b->sleft, sizeof a->sleft)
+        && !memcmp(a->sright, b->sright, sizeof a->sright)
+        && !memcmp(a->phaseRAM, b->phaseRAM, sizeof a->phaseRAM);
+}
+
+/*
+ * Replay a trace written by music5000_trace_start from a reset synth,
+ * running each sample both with update_sample and as 128 calls of
+ * update_6MHz on a copy, and compare the two after every sample.  The
+ * replay carries on for a second after the last write so the final
+ * notes play out.
+ */
+bool music5000_verify(const char *filename)
+{
+    struct synth step5000, step3000;
+    unsigned long sample = 0, end, at, differ = 0;
+    unsigned addr, val;
+    int got, i;
+    bool ok = true;
+    FILE *fp;
+
+    if (!(fp = fopen(filename, "r"))) {
+        log_error("music5000: unable to open trace file %s: %s", filename, strerror(errno));
+        return false;
+    }
+    music5000_maketables();
+    music5000_reset();
+    page = 0;
+    step5000 = m5000;
+    step3000 = m3000;
+    do {
+        got = fscanf(fp, "%lu %x %x", &at, &addr, &val);
+        end = (got == 3) ? at : sample + FREQ_M5;
+        for (; sample < end; sample++) {
+            update_sample(&m5000);
+            update_sample(&m3000);
+            for (i = 0; i < 128; i++) {
+                update_6MHz(&step5000);
+                update_6MHz(&step3000);
+            }
+            if (!synth_matches(&m5000, &step5000) || !synth_matches(&m3000, &step3000)) {
+                if (!differ)
+                    printf("m5-verify: first difference at sample %lu\n", sample);
+                differ++;
+            }
+        }
+        if (got == 3) {
+            music5000_write(addr, val);
+            memcpy(step5000.ram, m5000.ram, sizeof step5000.ram);
+            memcpy(step3000.ram, m3000.ram, sizeof step3000.ram);
+        }
+    } while (got == 3);
+    if (got != EOF) {
+        log_error("music5000: trace file %s is not in the expected format", filename);
+        ok = false;
+    }
+    fclose(fp);
+    printf("m5-verify: %lu samples, %lu differed\n", sample, differ);
+    return ok && !differ;
+}
+
 static void fput_samples(FILE *fp, int sl, int sr)
 {
     if (fp && (rec_started || sl || sr)) {
@@ -492,33 +662,33 @@ static void music5000_get_sample(int16_t *left, int16_t *right)
 
 // Music 5000 runs at a sample rate of 6MHz / 128 = 46875
 static void music5000_fillbuf(int16_t *buffer, int len) {
-    int i;
     int sample;
     int16_t *bufptr = buffer;
     for (sample = 0; sample < len; sample++) {
-        for (i = 0; i < 128; i++) {
-            update_6MHz(&m5000);
-            update_6MHz(&m3000);
-        }
+        update_sample(&m5000);
+        update_sample(&m3000);
         music5000_get_sample(bufptr, bufptr + 1);
         bufptr += 2;
     }
+    trace_sample += len;
 }
 
-void music5000_streamfrag(void)
+static void music5000_block(void)
 {
-    int16_t *buf;
-
-    // This function is called when a audio stream fragment available
-    // event is received in the main event handling loop but the event
-    // does not specify for which stream a new fragment has become
-    // available so we need to check if it is this one!
+    int16_t buf[M5_BLOCK * 2];
+    float samples[M5_BLOCK * 2];
+    int n;
 
     if (sound_music5000) {
-        if ((buf = al_get_audio_stream_fragment(stream))) {
-            music5000_fillbuf(buf, BUFLEN_M5);
-            al_set_audio_stream_fragment(stream, buf);
-            al_set_audio_stream_playing(stream, true);
+        music5000_fillbuf(buf, M5_BLOCK);
+        for (n = 0; n < M5_BLOCK * 2; n++)
+            samples[n] = buf[n] / 32768.0f;
+        if (soundfeed_write(feed, samples, M5_BLOCK) < M5_BLOCK) {
+            log_debug("music5000: overrun");
+            perf_count.sound_overruns++;
         }
     }
+    else
+        soundfeed_end(feed);
+    sched_at(&music5000_event, music5000_event.when + M5_BLOCK_CYCLES);
 }
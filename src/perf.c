@@ -0,0 +1,127 @@
+/*
+ * B-Em Performance Counters
+ *
+ * Keeps track of how fast the emulated machine is running compared
+ * to a real one and, optionally, where the host time is going.  The
+ * counters are sampled about once a second of wall-clock time.
+ */
+
+#include "b-em.h"
+#include "main.h"
+#include "model.h"
+#include "perf.h"
+#include "soundfeed.h"
+
+perf_count_t perf_count;
+perf_sample_t perf_last;
+unsigned perf_total_overruns;
+unsigned perf_total_underruns;
+
+bool perf_timing = false;
+bool perf_title = false;
+int perf_log_interval = 0;
+
+static double sample_start, last_log;
+
+void perf_reset(void)
+{
+    memset(&perf_count, 0, sizeof perf_count);
+    memset(&perf_last, 0, sizeof perf_last);
+    perf_total_overruns = 0;
+    sample_start = last_log = al_get_time();
+}
+
+static void perf_sample(double elapsed)
+{
+    double video_poll;
+
+    perf_last.elapsed          = elapsed;
+    perf_last.core_hz          = perf_count.core_cycles / elapsed;
+    perf_last.tube_hz          = perf_count.tube_cycles / elapsed;
+    perf_last.speed            = perf_last.core_hz / 20000.0;
+    perf_last.fps              = perf_count.frames / elapsed;
+    // video_doblit is called from within the timed video_poll so take
+    // it off to leave the time spent emulating the video alone.
+    video_poll = perf_count.video_poll - perf_count.video_doblit;
+    if (video_poll < 0)
+        video_poll = 0;
+    perf_last.video_poll       = video_poll * 100.0 / elapsed;
+    perf_last.sound_poll       = perf_count.sound_poll * 100.0 / elapsed;
+    perf_last.disc_poll        = perf_count.disc_poll * 100.0 / elapsed;
+    perf_last.video_doblit     = perf_count.video_doblit * 100.0 / elapsed;
+    perf_last.frames_skipped   = perf_count.frames_skipped;
+    perf_last.frames_unchanged = perf_count.frames_unchanged;
+    perf_last.sound_overruns   = perf_count.sound_overruns;
+    perf_total_overruns += perf_count.sound_overruns;
+    perf_last.sound_underruns  = soundfeed_underruns() - perf_total_underruns;
+    perf_total_underruns += perf_last.sound_underruns;
+    memset(&perf_count, 0, sizeof perf_count);
+}
+
+static void perf_set_title(void)
+{
+    ALLEGRO_DISPLAY *display;
+    char title[80];
+
+    if ((display = al_get_current_display())) {
+        if (perf_title)
+            snprintf(title, sizeof title, "%s - %.0f%%", VERSION_STR, perf_last.speed);
+        else
+            snprintf(title, sizeof title, "%s", VERSION_STR);
+        al_set_window_title(display, title);
+    }
+}
+
+void perf_frame(int cycles)
+{
+    double now, elapsed;
+
+    perf_count.core_cycles += cycles;
+    perf_count.frames++;
+    now = al_get_time();
+    elapsed = now - sample_start;
+    if (elapsed >= 1.0) {
+        perf_sample(elapsed);
+        sample_start = now;
+        if (perf_log_interval > 0 && (now - last_log) >= perf_log_interval) {
+            log_info("perf: core_hz=%.0f tube_hz=%.0f speed=%.1f fps=%.1f video_poll=%.2f sound_poll=%.2f disc_poll=%.2f video_doblit=%.2f skipped=%u unchanged=%u overruns=%u underruns=%u",
+                     perf_last.core_hz, perf_last.tube_hz, perf_last.speed, perf_last.fps,
+                     perf_last.video_poll, perf_last.sound_poll, perf_last.disc_poll, perf_last.video_doblit,
+                     perf_last.frames_skipped, perf_last.frames_unchanged, perf_last.sound_overruns, perf_last.sound_underruns);
+            last_log = now;
+        }
+        if (!headless)
+            perf_set_title();
+    }
+}
+
+size_t perf_format(char *buf, size_t size)
+{
+    size_t len;
+
+    len = snprintf(buf, size,
+        "Speed           %.1f%% (%.2f frames/s)\n"
+        "Core 6502       %.0f cycles/s\n",
+        perf_last.speed, perf_last.fps, perf_last.core_hz);
+    if (len < size && curtube != -1)
+        len += snprintf(buf + len, size - len, "Tube %-10s %.0f cycles/s\n", tubes[curtube].name, perf_last.tube_hz);
+    if (len < size) {
+        if (perf_timing)
+            len += snprintf(buf + len, size - len,
+                "video_poll      %.2f%% of host time\n"
+                "sound_poll      %.2f%% of host time\n"
+                "disc_poll       %.2f%% of host time\n"
+                "video_doblit    %.2f%% of host time\n",
+                perf_last.video_poll, perf_last.sound_poll, perf_last.disc_poll, perf_last.video_doblit);
+        else
+            len += snprintf(buf + len, size - len, "Function timing is off\n");
+    }
+    if (len < size)
+        len += snprintf(buf + len, size - len,
+            "Frames skipped  %u (%u unchanged)\n"
+            "Sound overruns  %u (%u total)\n"
+            "Sound underruns %u (%u total)\n",
+            perf_last.frames_skipped, perf_last.frames_unchanged, perf_last.sound_overruns, perf_total_overruns,
+            perf_last.sound_underruns, perf_total_underruns);
+    return len < size ? len : size - 1;
+}
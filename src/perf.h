@@ -0,0 +1,61 @@
+#ifndef __INC_PERF_H
+#define __INC_PERF_H
+
+/* Counters accumulated since the start of the current sample period */
+
+typedef struct {
+    uint64_t core_cycles;    // 2MHz cycles run by the main 6502
+    uint64_t tube_cycles;    // cycles given to the tube processor
+    double   video_poll;     // host seconds spent in each function,
+    double   sound_poll;     // only collected when perf_timing is set.
+    double   disc_poll;
+    double   video_doblit;
+    unsigned frames;
+    unsigned frames_skipped; // frames not drawn due to vid_fskipmax
+    unsigned frames_unchanged; // frames not drawn as nothing changed
+    unsigned sound_overruns;
+} perf_count_t;
+
+/* Rates and proportions from the last complete sample period */
+
+typedef struct {
+    double   elapsed;        // length of sample period in seconds
+    double   core_hz;
+    double   tube_hz;
+    double   speed;          // percentage of a real BBC
+    double   fps;
+    double   video_poll;     // percentage of host time, excluding
+                             // the video_doblit it calls.
+    double   sound_poll;
+    double   disc_poll;
+    double   video_doblit;
+    unsigned frames_skipped;
+    unsigned frames_unchanged;
+    unsigned sound_overruns;
+    unsigned sound_underruns; // sound feeds that ran dry.
+} perf_sample_t;
+
+extern perf_count_t perf_count;
+extern perf_sample_t perf_last;
+extern unsigned perf_total_overruns;
+extern unsigned perf_total_underruns;
+
+extern bool perf_timing;     // time the functions listed above.
+extern bool perf_title;      // show speed in the window title.
+extern int perf_log_interval; // seconds between log lines, 0=none.
+
+#define PERF_TIME(counter, call) \
+    do { \
+        if (perf_timing) { \
+            double perf_start = al_get_time(); \
+            call; \
+            perf_count.counter += al_get_time() - perf_start; \
+        } else \
+            call; \
+    } while (0)
+
+void perf_reset(void);
+void perf_frame(int cycles);
+size_t perf_format(char *buf, size_t size);
+
+#endif
@@ -152,7 +152,11 @@ static void fillbuf2(int& count, int16_t *buf, int len)
 }
 void sid_fillbuf(int16_t *buf, int len)
 {
-        int x=64;
-        
-        fillbuf2(x,buf,len);
+        int x;
+
+        // 64 cycles at 1MHz for each pair of samples.
+        for (; len > 0; len -= 2, buf += 2) {
+                x=64;
+                fillbuf2(x,buf,2);
+        }
 }
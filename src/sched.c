@@ -0,0 +1,112 @@
+/*
+ * B-Em Device Event Scheduler
+ *
+ * Keeps the pending device events in a binary heap ordered by the
+ * absolute cycle at which they are due so the CPU core only has to
+ * compare the cycle count against the earliest one as time passes.
+ */
+
+#include "b-em.h"
+#include "sched.h"
+
+#define SCHED_MAX 32
+
+uint64_t sched_now;
+uint64_t sched_next = UINT64_MAX;
+
+static sched_event_t *heap[SCHED_MAX];
+static int heap_size;
+
+static inline void heap_set(int slot, sched_event_t *ev)
+{
+    heap[slot] = ev;
+    ev->slot = slot;
+}
+
+static void heap_up(int slot)
+{
+    sched_event_t *ev = heap[slot];
+
+    while (slot > 0) {
+        int parent = (slot - 1) / 2;
+        if (heap[parent]->when <= ev->when)
+            break;
+        heap_set(slot, heap[parent]);
+        slot = parent;
+    }
+    heap_set(slot, ev);
+}
+
+static void heap_down(int slot)
+{
+    sched_event_t *ev = heap[slot];
+
+    for (;;) {
+        int child = slot * 2 + 1;
+        if (child >= heap_size)
+            break;
+        if (child + 1 < heap_size && heap[child + 1]->when < heap[child]->when)
+            child++;
+        if (ev->when <= heap[child]->when)
+            break;
+        heap_set(slot, heap[child]);
+        slot = child;
+    }
+    heap_set(slot, ev);
+}
+
+static inline void heap_update_next(void)
+{
+    sched_next = heap_size ? heap[0]->when : UINT64_MAX;
+}
+
+void sched_cancel(sched_event_t *ev)
+{
+    int slot = ev->slot;
+
+    if (slot >= 0) {
+        ev->slot = -1;
+        if (--heap_size != slot) {
+            sched_event_t *moved = heap[heap_size];
+            heap_set(slot, moved);
+            heap_up(slot);
+            heap_down(moved->slot);
+        }
+        heap_update_next();
+    }
+}
+
+void sched_at(sched_event_t *ev, uint64_t when)
+{
+    if (ev->slot >= 0)
+        sched_cancel(ev);
+    if (heap_size >= SCHED_MAX) {
+        log_fatal("sched: too many events queued adding %s", ev->name);
+        exit(1);
+    }
+    ev->when = when;
+    heap_set(heap_size, ev);
+    heap_up(heap_size++);
+    heap_update_next();
+}
+
+void sched_add(sched_event_t *ev, int delay)
+{
+    sched_at(ev, sched_now + delay);
+}
+
+int sched_remaining(const sched_event_t *ev)
+{
+    if (ev->slot < 0)
+        return 0;
+    return (int)(ev->when - sched_now);
+}
+
+void sched_dispatch(void)
+{
+    while (heap_size && heap[0]->when <= sched_now) {
+        sched_event_t *ev = heap[0];
+        sched_cancel(ev);
+        ev->callback();
+    }
+}
@@ -0,0 +1,42 @@
+#ifndef __INC_SCHED_H
+#define __INC_SCHED_H
+
+/*
+ * Device event scheduler.
+ *
+ * Devices that need attention at some point in the future register
+ * an event to be called back when the 2MHz cycle count reaches that
+ * point rather than counting down on every instruction.
+ */
+
+typedef struct sched_event {
+    const char *name;
+    void (*callback)(void);
+    uint64_t when;          // absolute cycle the event is due.
+    int slot;               // position in the queue, -1 if not queued.
+} sched_event_t;
+
+#define SCHED_EVENT(name, callback) { name, callback, 0, -1 }
+
+extern uint64_t sched_now;  // 2MHz cycles run since start-up.
+extern uint64_t sched_next; // when the earliest queued event is due.
+
+void sched_add(sched_event_t *ev, int delay);
+void sched_at(sched_event_t *ev, uint64_t when);
+void sched_cancel(sched_event_t *ev);
+int sched_remaining(const sched_event_t *ev);
+void sched_dispatch(void);
+
+static inline bool sched_pending(const sched_event_t *ev)
+{
+    return ev->slot >= 0;
+}
+
+static inline void sched_advance(int c)
+{
+    sched_now += c;
+    if (sched_now >= sched_next)
+        sched_dispatch();
+}
+
+#endif
@@ -1,6 +1,7 @@
 /*B-em v2.2 by Tom Walker
   Internal SN sound chip emulation*/
 
+#include <math.h>
 #include "b-em.h"
 #include "sid_b-em.h"
 #include "sn76489.h"
@@ -19,6 +20,7 @@ uint32_t sn_latch[4];
 static int sn_rect_pos = 0,sn_rect_dir = 0;
 
 int curwave = 0;
+int sn_quality = SN_QUALITY_NORMAL;
 
 static float volslog[16] =
 {
@@ -65,63 +67,438 @@ static void sn_updaterectwave(int d)
 
 
 
-void sn_fillbuf(int16_t *buffer, int len)
+/*
+ * Register writes are not applied as they happen but queued along with
+ * the sample they take effect from so that a whole block of sound can be
+ * rendered at once.  Within each run of samples with no writes and no
+ * change to the rectangular wave the channels are rendered one at a time
+ * using tables of the output level for each step of the waveform.
+ */
+
+#define SN_QUEUE_LEN 1024
+
+static struct {
+        int pos;
+        uint8_t data;
+} sn_queue[SN_QUEUE_LEN];
+static int sn_queued;
+
+static int sn_rect_count = 0;
+
+static void sn_apply(uint8_t data);
+
+/*
+ * Band-limited rendering.  Rather than sampling each channel, every
+ * change in a channel's output level is added to a ring of differences
+ * as a band-limited step placed at the fraction of a sample where it
+ * happens, and the ring is summed to give the output.  Channels only cost
+ * anything when their level changes, and the steps are precise enough
+ * that high notes no longer alias.  The steps are windowed sinc
+ * integrals, delayed by half their width so that nothing is needed from
+ * before the change.
+ */
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define SN_BLEP_BITS   12                /* fixed point scale of the steps */
+#define SN_BLEP_PHASES 64                /* fractional positions per sample */
+#define SN_BLEP_MAXTAPS 33
+#define SN_BLEP_RING   4096              /* > BUFLEN_SO + SN_BLEP_MAXTAPS */
+
+static int sn_blep_kernel[SN_BLEP_PHASES][SN_BLEP_MAXTAPS];
+static int sn_blep_ring[SN_BLEP_RING];
+static int sn_blep_taps, sn_blep_quality = -1;
+static unsigned sn_blep_pos;
+static int sn_blep_sum, sn_blep_level[4];
+
+static double sn_blep_impulse(double u, int width, double cutoff)
 {
-        int c, d;
-        static int sidcount = 0;
+        double x = 2.0 * cutoff * u, w;
 
-        for (d = 0; d < len; d++)
+        w = 0.42 + 0.5 * cos(2.0 * M_PI * u / width) + 0.08 * cos(4.0 * M_PI * u / width);
+        if (x == 0.0)
+           return 2.0 * cutoff * w;
+        return 2.0 * cutoff * w * sin(M_PI * x) / (M_PI * x);
+}
+
+/*Integrate the windowed sinc over one sample either side of each tap.*/
+static void sn_blep_setup(int quality)
+{
+        int width, p, k, n, sum, big;
+        double cutoff, f, a, b, h, v[SN_BLEP_MAXTAPS], total;
+
+        memset(sn_blep_ring, 0, sizeof(sn_blep_ring));
+        sn_blep_sum = 0;
+        sn_blep_level[0] = sn_blep_level[1] = sn_blep_level[2] = sn_blep_level[3] = 0;
+        sn_blep_quality = quality;
+        if (quality == SN_QUALITY_FAST)
+           return;
+
+        if (quality == SN_QUALITY_HIGH)
+        {
+                width  = 32;
+                cutoff = 0.45;
+        }
+        else
+        {
+                width  = 8;
+                cutoff = 0.40;
+        }
+        sn_blep_taps = width + 1;
+        for (p = 0; p < SN_BLEP_PHASES; p++)
         {
-                for (c = 0; c < 3; c++)
+                f = (double)p / SN_BLEP_PHASES;
+                total = 0.0;
+                for (k = 0; k <= width; k++)
                 {
-                        c++;
-                        if (sn_latch[c] > 256) buffer[d] += (int16_t) (snwaves[curwave][sn_stat[c]] * volslog[sn_vol[c]]);
-                        else                   buffer[d] += (int16_t) (volslog[sn_vol[c]] * 127);
+                        a = k - f - width / 2;
+                        b = a + 1.0;
+                        if (a < -width / 2) a = -width / 2;
+                        if (b >  width / 2) b =  width / 2;
+                        v[k] = 0.0;
+                        if (b > a)
+                        {
+                                /*Simpson's rule*/
+                                h = (b - a) / 16;
+                                for (n = 0; n <= 16; n++)
+                                    v[k] += sn_blep_impulse(a + n * h, width, cutoff) * h / 3 * ((n == 0 || n == 16) ? 1 : (n & 1) ? 4 : 2);
+                        }
+                        total += v[k];
+                }
+                /*Each step must add up to exactly one so the sum never drifts.*/
+                sum = big = 0;
+                for (k = 0; k <= width; k++)
+                {
+                        sn_blep_kernel[p][k] = (int)lrint(v[k] / total * (1 << SN_BLEP_BITS));
+                        sum += sn_blep_kernel[p][k];
+                        if (sn_blep_kernel[p][k] > sn_blep_kernel[p][big])
+                           big = k;
+                }
+                sn_blep_kernel[p][big] += (1 << SN_BLEP_BITS) - sum;
+        }
+}
+
+/*Add a step of delta starting from sample i+1 of the current run, with
+  the change phase/SN_BLEP_PHASES of the way from sample i to i+1.*/
+static inline void sn_blep_step(int i, int phase, int delta)
+{
+        const int *k = sn_blep_kernel[phase];
+        unsigned pos = sn_blep_pos + i + 1;
+        int n;
+
+        for (n = 0; n < sn_blep_taps; n++)
+            sn_blep_ring[(pos + n) & (SN_BLEP_RING - 1)] += k[n] * delta;
+}
+
+/*Move a channel to a new level from the start of the current run.*/
+static inline void sn_blep_set(int c, int level)
+{
+        if (level != sn_blep_level[c])
+        {
+                sn_blep_step(-1, 0, level - sn_blep_level[c]);
+                sn_blep_level[c] = level;
+        }
+}
+
+static void sn_blep_mix(int16_t *buffer, int len)
+{
+        int d, *r;
+
+        for (d = 0; d < len; d++)
+        {
+                r = &sn_blep_ring[(sn_blep_pos + d) & (SN_BLEP_RING - 1)];
+                sn_blep_sum += *r;
+                *r = 0;
+                buffer[d] += (sn_blep_sum + (1 << (SN_BLEP_BITS - 1))) >> SN_BLEP_BITS;
+        }
+        sn_blep_pos += len;
+}
+
+/*The noise channel is added to the running total in floating point,
+  which truncates towards zero.  Adding whole part and then bumping
+  negative totals back up by one gives the same answer in integers.*/
+typedef struct {
+        int whole;
+        int frac;
+} sn_level_t;
+
+static inline sn_level_t sn_level(float x)
+{
+        sn_level_t l;
+
+        l.whole = (int)x;
+        if (x < l.whole)
+           l.whole--;
+        l.frac = (x != (float)l.whole);
+        return l;
+}
+
+static inline int16_t sn_addlevel(int16_t b, sn_level_t l)
+{
+        int r = b + l.whole;
+
+        if (l.frac && r < 0)
+           r++;
+        return (int16_t)r;
+}
+
+/*Step a tone counter on by len samples without producing any output.*/
+static void sn_skip(int c, int len)
+{
+        int steps;
+
+        sn_count[c] = (int)((uint32_t)sn_count[c] - 8192u * len);
+        if (sn_count[c] < 0 && sn_latch[c])
+        {
+                steps = (-sn_count[c] + sn_latch[c] - 1) / sn_latch[c];
+                sn_count[c] += steps * sn_latch[c];
+                sn_stat[c] = (sn_stat[c] + steps) & 31;
+        }
+}
+
+/*Step a tone channel on by len samples while it makes no sound.*/
+static void sn_advance(int c, int len)
+{
+        int d;
 
+        if (sn_count[c] >= 0 || !sn_latch[c])
+           sn_skip(c, len);
+        else
+        {
+                /*Only after a long spell with a zero period.*/
+                for (d = 0; d < len; d++)
+                {
                         sn_count[c] -= 8192;
-                        while ((int)sn_count[c] < 0  && sn_latch[c])
+                        while (sn_count[c] < 0 && sn_latch[c])
                         {
                                 sn_count[c] += sn_latch[c];
                                 sn_stat[c]++;
                                 sn_stat[c] &= 31;
                         }
-                        c--;
                 }
-                if (!(sn_noise & 4))
+        }
+}
+
+static void sn_tone(int16_t *buffer, int len, int c)
+{
+        int16_t level[32];
+        int d;
+
+        if (sn_latch[c] <= 256)
+        {
+                int16_t dc = (int16_t) (volslog[sn_vol[c]] * 127);
+                for (d = 0; d < len; d++)
+                    buffer[d] += dc;
+        }
+        else if (sn_vol[c])
+        {
+                for (d = 0; d < 32; d++)
+                    level[d] = (int16_t) (snwaves[curwave][d] * volslog[sn_vol[c]]);
+                for (d = 0; d < len; d++)
                 {
-                        if (curwave == 4) buffer[d] += (snwaves[4][sn_stat[0] & 31] * volslog[sn_vol[0]]);
-                        else              buffer[d] += (((sn_shift & 1) ^ 1) * 127 * volslog[sn_vol[0]] * 2);
+                        buffer[d] += level[sn_stat[c]];
+                        sn_count[c] -= 8192;
+                        while (sn_count[c] < 0)
+                        {
+                                sn_count[c] += sn_latch[c];
+                                sn_stat[c] = (sn_stat[c] + 1) & 31;
+                        }
                 }
-                else    buffer[d] += (((sn_shift & 1) ^ 1) * 127 * volslog[sn_vol[0]] * 2);
+                return;
+        }
+        sn_advance(c, len);
+}
+
+static void sn_bleptone(int len, int c)
+{
+        int level[32], d, t, end, cur;
+
+        if (sn_latch[c] <= 256 || !sn_vol[c])
+        {
+                sn_blep_set(c, sn_latch[c] <= 256 ? (int) (volslog[sn_vol[c]] * 127) : 0);
+                sn_advance(c, len);
+                return;
+        }
+        for (d = 0; d < 32; d++)
+            level[d] = (int) (snwaves[curwave][d] * volslog[sn_vol[c]]);
+        sn_blep_set(c, level[sn_stat[c]]);
+        cur = sn_blep_level[c];
+
+        /*t is the time of the next step in 1/8192ths of a sample.*/
+        t = sn_count[c];
+        if (t < 0)
+        {
+                /*Only after a long spell with a zero period.*/
+                t -= 8192;
+                while (t < 0)
+                {
+                        t += sn_latch[c];
+                        sn_stat[c] = (sn_stat[c] + 1) & 31;
+                }
+                if (level[sn_stat[c]] != cur)
+                {
+                        sn_blep_step(0, 0, level[sn_stat[c]] - cur);
+                        cur = level[sn_stat[c]];
+                }
+                t += 8192;
+        }
+        end = len << 13;
+        while (t < end)
+        {
+                sn_stat[c] = (sn_stat[c] + 1) & 31;
+                if (level[sn_stat[c]] != cur)
+                {
+                        sn_blep_step(t >> 13, (t & 8191) >> 7, level[sn_stat[c]] - cur);
+                        cur = level[sn_stat[c]];
+                }
+                t += sn_latch[c];
+        }
+        sn_count[c] = t - end;
+        sn_blep_level[c] = cur;
+}
+
+static inline void sn_noiseshift(int periodic)
+{
+        if (periodic)
+        {
+                if (sn_shift & 1) sn_shift |= 0x8000;
+                sn_shift >>= 1;
+        }
+        else
+        {
+                if ((sn_shift & 1) ^ ((sn_shift >> 1) & 1)) sn_shift |= 0x8000;
+                sn_shift >>= 1;
+        }
+        sn_stat[0]++;
+}
+
+static inline void sn_noisewrap(int periodic)
+{
+        if (periodic)
+        {
+                while (sn_stat[0] >= 30) sn_stat[0] -= 30;
+        }
+        else
+           sn_stat[0] &= 32767;
+}
+
+static void sn_noisechan(int16_t *buffer, int len)
+{
+        sn_level_t level[32], on;
+        int d, periodic = !(sn_noise & 4);
+
+        for (d = 0; d < 32; d++)
+            level[d] = sn_level(snwaves[4][d] * volslog[sn_vol[0]]);
+        on = sn_level(1 * 127 * volslog[sn_vol[0]] * 2);
+
+        for (d = 0; d < len; d++)
+        {
+                if (periodic && curwave == 4)
+                   buffer[d] = sn_addlevel(buffer[d], level[sn_stat[0] & 31]);
+                else if (!(sn_shift & 1))
+                   buffer[d] = sn_addlevel(buffer[d], on);
 
                 sn_count[0] -= 512;
-                while ((int)sn_count[0] < 0 && sn_latch[0])
+                while (sn_count[0] < 0 && sn_latch[0])
                 {
                         sn_count[0] += (sn_latch[0] * 2);
-                        if (!(sn_noise & 4))
-                        {
-                                if (sn_shift & 1) sn_shift |= 0x8000;
-                                sn_shift >>= 1;
-                        }
-                        else
-                        {
-                                if ((sn_shift & 1) ^ ((sn_shift >> 1) & 1)) sn_shift |= 0x8000;
-                                sn_shift >>= 1;
-                        }
-                        sn_stat[0]++;
+                        sn_noiseshift(periodic);
                 }
-                if (!(sn_noise & 4))
+                sn_noisewrap(periodic);
+        }
+}
+
+static void sn_blepnoise(int len)
+{
+        int level[32], on, d, t, end, cur, now, periodic = !(sn_noise & 4);
+
+        for (d = 0; d < 32; d++)
+            level[d] = (int) (snwaves[4][d] * volslog[sn_vol[0]]);
+        on = (int) (127 * volslog[sn_vol[0]] * 2);
+
+#define SN_NOISELEVEL ((periodic && curwave == 4) ? level[sn_stat[0] & 31] : (sn_shift & 1) ? 0 : on)
+        sn_blep_set(0, SN_NOISELEVEL);
+        cur = sn_blep_level[0];
+        end = len << 9;
+        if (!sn_latch[0])
+        {
+                sn_count[0] -= end;
+                return;
+        }
+
+        /*t is the time of the next shift in 1/512ths of a sample.*/
+        t = sn_count[0];
+        if (t < 0)
+        {
+                t -= 512;
+                while (t < 0)
+                {
+                        t += sn_latch[0] * 2;
+                        sn_noiseshift(periodic);
+                        sn_noisewrap(periodic);
+                }
+                if ((now = SN_NOISELEVEL) != cur)
+                {
+                        sn_blep_step(0, 0, now - cur);
+                        cur = now;
+                }
+                t += 512;
+        }
+        while (t < end)
+        {
+                sn_noiseshift(periodic);
+                sn_noisewrap(periodic);
+                if ((now = SN_NOISELEVEL) != cur)
                 {
-                        while (sn_stat[0] >= 30) sn_stat[0] -= 30;
+                        sn_blep_step(t >> 9, (t & 511) >> 3, now - cur);
+                        cur = now;
+                }
+                t += sn_latch[0] * 2;
+        }
+#undef SN_NOISELEVEL
+        sn_count[0] = t - end;
+        sn_blep_level[0] = cur;
+}
+
+/*Render the samples from..to-1 of a fragment, applying the queued writes
+  as their samples are reached.*/
+void sn_fillbuf(int16_t *buffer, int from, int to)
+{
+        int c, end, next = 0;
+
+        if (sn_quality != sn_blep_quality)
+           sn_blep_setup(sn_quality);
+        while (from < to)
+        {
+                while (next < sn_queued && sn_queue[next].pos <= from)
+                      sn_apply(sn_queue[next++].data);
+
+                end = to;
+                if (next < sn_queued && sn_queue[next].pos < end)
+                   end = sn_queue[next].pos;
+                if (from + 624 - sn_rect_count < end)
+                   end = from + 624 - sn_rect_count;
+
+                if (sn_blep_quality == SN_QUALITY_FAST)
+                {
+                        for (c = 1; c < 4; c++)
+                            sn_tone(buffer + from, end - from, c);
+                        sn_noisechan(buffer + from, end - from);
                 }
                 else
-                   sn_stat[0] &= 32767;
-//                buffer[d] += (lpt_dac * 32);
+                {
+                        for (c = 1; c < 4; c++)
+                            sn_bleptone(end - from, c);
+                        sn_blepnoise(end - from);
+                        sn_blep_mix(buffer + from, end - from);
+                }
 
-                sidcount++;
-                if (sidcount == 624)
+                sn_rect_count += end - from;
+                if (sn_rect_count == 624)
                 {
-                        sidcount = 0;
+                        sn_rect_count = 0;
                         if (!sn_rect_dir)
                         {
                                 sn_rect_pos++;
@@ -134,7 +511,21 @@ void sn_fillbuf(int16_t *buffer, int len)
                         }
                         sn_updaterectwave(sn_rect_pos);
                 }
+                from = end;
         }
+        while (next < sn_queued && sn_queue[next].pos <= to)
+              sn_apply(sn_queue[next++].data);
+        sn_queued = 0;
+}
+
+/*Apply any queued writes straight away without producing any sound.*/
+void sn_flush(void)
+{
+        int c;
+
+        for (c = 0; c < sn_queued; c++)
+            sn_apply(sn_queue[c].data);
+        sn_queued = 0;
 }
 
 void sn_init()
@@ -160,7 +551,7 @@ void sn_init()
 }
 
 static uint8_t firstdat;
-void sn_write(uint8_t data)
+static void sn_apply(uint8_t data)
 {
         int freq;
 
@@ -230,9 +621,25 @@ void sn_write(uint8_t data)
 }
 
 
+void sn_write(uint8_t data)
+{
+        int pos;
+
+        if (!sound_internal || (pos = sound_now()) < 0)
+        {
+                sn_flush();
+                sn_apply(data);
+                return;
+        }
+        if (sn_queued == SN_QUEUE_LEN)
+           sound_sync();
+        sn_queue[sn_queued].pos = pos;
+        sn_queue[sn_queued++].data = data;
+}
 
 void sn_savestate(FILE *f)
 {
+        sound_sync();
         fwrite(sn_latch, 16, 1, f);
         fwrite(sn_count, 16, 1, f);
         fwrite(sn_stat,  16, 1, f);
@@ -243,6 +650,7 @@ void sn_savestate(FILE *f)
 
 void sn_loadstate(FILE *f)
 {
+        sound_sync();
         fread(sn_latch, 16, 1, f);
         fread(sn_count, 16, 1, f);
         fread(sn_stat,  16, 1, f);
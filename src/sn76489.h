@@ -2,7 +2,8 @@
 #define __INC_SN74689_H
 
 void sn_init(void);
-void sn_fillbuf(int16_t *buffer, int len);
+void sn_fillbuf(int16_t *buffer, int from, int to);
+void sn_flush(void);
 void sn_write(uint8_t data);
 void sn_savestate(FILE *f);
 void sn_loadstate(FILE *f);
@@ -14,4 +15,11 @@ extern uint32_t sn_latch[4];
 
 extern int curwave;
 
+/* Rendering of the internal sound chip, fast being plain sampling */
+#define SN_QUALITY_FAST   0
+#define SN_QUALITY_NORMAL 1
+#define SN_QUALITY_HIGH   2
+
+extern int sn_quality;
+
 #endif
@@ -2,153 +2,169 @@
   Internal SN sound chip emulation*/
 
 #include "b-em.h"
-#include <allegro5/allegro_audio.h>
 #include "sid_b-em.h"
 #include "sn76489.h"
+#include "perf.h"
 #include "sound.h"
 #include "via.h"
 #include "uservia.h"
 #include "music5000.h"
+#include "sched.h"
+#include "soundfeed.h"
 
 bool sound_internal = false, sound_beebsid = false, sound_dac = false;
 bool sound_ddnoise = false, sound_tape = false;
 bool sound_music5000 = false, sound_filter = false;
 
-static ALLEGRO_VOICE *voice;
-static ALLEGRO_MIXER *mixer;
-static ALLEGRO_AUDIO_STREAM *stream;
+static soundfeed_t *feed;
 
-static int sound_pos = 0;
 static short sound_buffer[BUFLEN_SO];
 
-#define NCoef 4
-static float iir(float NewSample) {
-    float ACoef[NCoef+1] = {
-        0.30631912757971225000,
-        0.00000000000000000000,
-        -0.61263825515942449000,
-        0.00000000000000000000,
-        0.30631912757971225000
-    };
-
-    float BCoef[NCoef+1] = {
-        1.00000000000000000000,
-        -1.86772356053227330000,
-        1.08459167506874430000,
-        -0.37711292573951394000,
-        0.17253125052500490000
-    };
-
-    static float y[NCoef+1]; //output samples
-    static float x[NCoef+1]; //input samples
-    int n;
-
-    //shift the old samples
-    for(n=NCoef; n>0; n--) {
-       x[n] = x[n-1];
-       y[n] = y[n-1];
+/*
+ * The sources are not polled but rendered a block at a time.  The SN
+ * queues its register writes against the sample they take effect from,
+ * the SID is caught up before it is accessed and the DAC records its
+ * level as it changes; everything outstanding is rendered when the
+ * fragment is complete and written to the sound feed.  A pair of
+ * samples is produced for each 128 cycles, as when this was polled, so
+ * the output is unchanged.
+ */
+#define SOUND_FRAG_CYCLES ((BUFLEN_SO / 2) * 128)
+
+static void sound_fragment(void);
+static sched_event_t sound_event = SCHED_EVENT("sound", sound_fragment);
+
+static int sid_pos, sn_pos, dac_pos;
+static uint8_t dac_level[BUFLEN_SO / 2];
+
+/*
+ * The fixed 4th order filter for the internal sound, run over a whole
+ * fragment at a time so the history can be kept in locals rather than
+ * shifted along arrays for every sample.  The odd feed-forward
+ * coefficients are zero.
+ */
+static float iir_x[4], iir_y[4];
+
+static void iir(float *buf, const short *in, int len)
+{
+    const float A0 =  0.30631912757971225000;
+    const float A2 = -0.61263825515942449000;
+    const float A4 =  0.30631912757971225000;
+    const float B1 = -1.86772356053227330000;
+    const float B2 =  1.08459167506874430000;
+    const float B3 = -0.37711292573951394000;
+    const float B4 =  0.17253125052500490000;
+    float x0, x1 = iir_x[0], x2 = iir_x[1], x3 = iir_x[2], x4 = iir_x[3];
+    float y0, y1 = iir_y[0], y2 = iir_y[1], y3 = iir_y[2], y4 = iir_y[3];
+    int c;
+
+    for (c = 0; c < len; c++) {
+        x0 = (float)in[c] / 32767.0;
+        y0 = A0 * x0;
+        y0 -= B1 * y1;
+        y0 += A2 * x2 - B2 * y2;
+        y0 -= B3 * y3;
+        y0 += A4 * x4 - B4 * y4;
+        buf[c] = y0;
+        x4 = x3; x3 = x2; x2 = x1; x1 = x0;
+        y4 = y3; y3 = y2; y2 = y1; y1 = y0;
     }
+    iir_x[0] = x1; iir_x[1] = x2; iir_x[2] = x3; iir_x[3] = x4;
+    iir_y[0] = y1; iir_y[1] = y2; iir_y[2] = y3; iir_y[3] = y4;
+}
 
-    //Calculate the new output
-    x[0] = NewSample;
-    y[0] = ACoef[0] * x[0];
-    for(n=1; n<=NCoef; n++)
-        y[0] += ACoef[n] * x[n] - BCoef[n] * y[n];
+/*
+ * Returns the sample within the current fragment that the emulated sound
+ * has reached, or -1 if nothing is being rendered.
+ */
+int sound_now(void)
+{
+    int pos;
 
-    return y[0];
+    if (!(sound_internal || sound_beebsid) || !feed || !sched_pending(&sound_event))
+        return -1;
+    pos = BUFLEN_SO - ((sched_remaining(&sound_event) + 127) >> 7) * 2;
+    return pos < 0 ? 0 : pos;
 }
 
-void sound_poll(void)
+static void sound_dac_to(int pos)
 {
-    float *buf;
-    int c;
+    for (; dac_pos < pos; dac_pos += 2)
+        dac_level[dac_pos >> 1] = lpt_dac;
+}
 
-    if ((sound_internal || sound_beebsid) && stream) {
+static void sound_render(int pos)
+{
+    if (pos > sid_pos) {
         if (sound_beebsid)
-            sid_fillbuf(sound_buffer + sound_pos, 2);
+            sid_fillbuf(sound_buffer + sid_pos, pos - sid_pos);
+        sid_pos = pos;
+    }
+    if (pos > sn_pos) {
         if (sound_internal)
-            sn_fillbuf(sound_buffer + sound_pos, 2);
-        if (sound_dac) {
-            sound_buffer[sound_pos]     += (((int)lpt_dac - 0x80) * 32);
-            sound_buffer[sound_pos + 1] += (((int)lpt_dac - 0x80) * 32);
-        }
-
-        // skip forward 2 mono samples
-        sound_pos += 2;
-        if (sound_pos == BUFLEN_SO) {
-            if ((buf = al_get_audio_stream_fragment(stream))) {
-                if (sound_filter) {
-                    for (c = 0; c < BUFLEN_SO; c++)
-                        buf[c] = iir((float)sound_buffer[c] / 32767.0);
-                } else {
-                    for (c = 0; c < BUFLEN_SO; c++)
-                        buf[c] = (float)sound_buffer[c] / 32767.0;
-                }
-                al_set_audio_stream_fragment(stream, buf);
-                al_set_audio_stream_playing(stream, true);
-            } else
-                log_debug("sound: overrun");
-            sound_pos = 0;
-            memset(sound_buffer, 0, sizeof(sound_buffer));
-        }
+            sn_fillbuf(sound_buffer, sn_pos, pos);
+        else
+            sn_flush();
+        sn_pos = pos;
     }
+    sound_dac_to(pos);
 }
 
-static ALLEGRO_VOICE *sound_create_voice(void)
+/* Bring the sound up to date, e.g. before the SID is accessed. */
+void sound_sync(void)
 {
-    ALLEGRO_VOICE *voice;
+    int pos = sound_now();
 
-    if ((voice = al_create_voice(FREQ_SO, ALLEGRO_AUDIO_DEPTH_FLOAT32, ALLEGRO_CHANNEL_CONF_1))) {
-        log_debug("sound: created voice with standard sound freq, float depth");
-        return voice;
-    }
-    if ((voice = al_create_voice(FREQ_SO, ALLEGRO_AUDIO_DEPTH_INT24, ALLEGRO_CHANNEL_CONF_1))) {
-        log_debug("sound: created voice with standard sound freq, 24bit depth");
-        return voice;
-    }
-    if ((voice = al_create_voice(FREQ_SO, ALLEGRO_AUDIO_DEPTH_INT16, ALLEGRO_CHANNEL_CONF_1))) {
-        log_debug("sound: created voice with standard sound freq, 16bit depth");
-        return voice;
-    }
-    if ((voice = al_create_voice(FREQ_DD, ALLEGRO_AUDIO_DEPTH_FLOAT32, ALLEGRO_CHANNEL_CONF_1))) {
-        log_debug("sound: created voice with ddnoise freq, float depth");
-        return voice;
-    }
-    if ((voice = al_create_voice(FREQ_DD, ALLEGRO_AUDIO_DEPTH_INT24, ALLEGRO_CHANNEL_CONF_1))) {
-        log_debug("sound: created voice with ddnoise freq, 24bit depth");
-        return voice;
-    }
-    if ((voice = al_create_voice(FREQ_DD, ALLEGRO_AUDIO_DEPTH_INT16, ALLEGRO_CHANNEL_CONF_1))) {
-        log_debug("sound: created voice with ddnoise freq, 16bit depth");
-        return voice;
+    if (pos >= 0)
+        sound_render(pos);
+}
+
+void sound_dac_write(uint8_t val)
+{
+    int pos = sound_now();
+
+    if (pos >= 0)
+        sound_dac_to(pos);
+    lpt_dac = val;
+}
+
+static void sound_output(void)
+{
+    float buf[BUFLEN_SO];
+    int c;
+
+    sound_render(BUFLEN_SO);
+    if ((sound_internal || sound_beebsid) && feed) {
+        if (sound_dac) {
+            for (c = 0; c < BUFLEN_SO; c++)
+                sound_buffer[c] += (((int)dac_level[c >> 1] - 0x80) * 32);
+        }
+        if (sound_filter)
+            iir(buf, sound_buffer, BUFLEN_SO);
+        else {
+            for (c = 0; c < BUFLEN_SO; c++)
+                buf[c] = (float)sound_buffer[c] / 32767.0;
+        }
+        if (soundfeed_write(feed, buf, BUFLEN_SO) < BUFLEN_SO) {
+            log_debug("sound: overrun");
+            perf_count.sound_overruns++;
+        }
     }
-    return NULL;
+    else if (feed)
+        soundfeed_end(feed);
+    sid_pos = sn_pos = dac_pos = 0;
+    memset(sound_buffer, 0, sizeof(sound_buffer));
 }
 
-void sound_init(void)
+static void sound_fragment(void)
 {
-    if ((voice = sound_create_voice())) {
-        if ((mixer = al_create_mixer(FREQ_SO, ALLEGRO_AUDIO_DEPTH_FLOAT32, ALLEGRO_CHANNEL_CONF_1))) {
-            if (al_attach_mixer_to_voice(mixer, voice)) {
-                if ((stream = al_create_audio_stream(4, BUFLEN_SO, FREQ_SO, ALLEGRO_AUDIO_DEPTH_FLOAT32, ALLEGRO_CHANNEL_CONF_1))) {
-                    if (!al_attach_audio_stream_to_mixer(stream, mixer))
-                        log_error("sound: unable to attach stream to mixer for internal/SID/DAC sound");
-                } else
-                    log_error("sound: unable to create stream for internal/SID/DAC sound");
-            } else
-                log_error("sound: unable to attach mixer to voice for internal/SID/DAC sound");
-        } else
-            log_error("sound: unable to create mixer for internal/SID/DAC sound");
-    } else
-        log_error("sound: unable to create voice for internal/SID/DAC sound");
+    PERF_TIME(sound_poll, sound_output());
+    sched_at(&sound_event, sound_event.when + SOUND_FRAG_CYCLES);
 }
 
-void sound_close(void)
+void sound_init(void)
 {
-    if (stream)
-        al_destroy_audio_stream(stream);
-    if (mixer)
-        al_destroy_mixer(mixer);
-    if (voice)
-        al_destroy_voice(voice);
+    // The first pair of samples is taken at cycle 0.
+    if ((feed = soundfeed_create("sound", FREQ_SO, 1, BUFLEN_SO * 3)))
+        sched_add(&sound_event, SOUND_FRAG_CYCLES - 128);
 }
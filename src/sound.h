@@ -6,11 +6,12 @@
 #define FREQ_SO  31250   // normal sound
 #define FREQ_DD  44100   // disc drive noise
 #define FREQ_M5  46875   // music 5000
+#define FREQ_OUT 48000   // mixed output, else FREQ_DD
 
 /* Source buffer lengths in time samples */
 
-#define BUFLEN_SO 2000   //  64ms @ 31.25KHz  (must be multiple of 2)
-#define BUFLEN_DD 4410   // 100ms @ 44.1KHz
+#define BUFLEN_SO 640    //  20.5ms @ 31.25KHz (must be multiple of 2)
+#define BUFLEN_DD 441    //  10ms @ 44.1KHz
 #define BUFLEN_M5 1500   //  64ms @ 46.875KHz (must be multiple of 3)
 
 extern size_t buflen_m5;
@@ -20,6 +21,8 @@ extern bool sound_ddnoise, sound_tape;
 extern bool sound_music5000, sound_filter;
 
 void sound_init(void);
-void sound_poll(void);
+int sound_now(void);
+void sound_sync(void);
+void sound_dac_write(uint8_t val);
 
 #endif
@@ -0,0 +1,451 @@
+/*
+ * B-Em Sound Feeds and Mixer
+ *
+ * Each feed is a ring of samples with a single writer, the emulation
+ * thread, which only moves the head on and a single reader, the feed
+ * thread, which only moves the tail on.  Neither needs a lock; each
+ * only has to see the other's index change after the samples it covers.
+ *
+ * The feed thread fills the one output stream's fragments as they
+ * become free, mixing in every feed that is running.  A feed waits for
+ * its source to write its latency's worth before starting and is then
+ * read at a rate which keeps the ring at about that level.  The rate is
+ * normally exactly the ratio of the source and output sample rates but
+ * if the level wanders by more than half, because the emulated and audio
+ * clocks disagree or the emulation is not running at 100%, it is steered
+ * to bring it back.  The samples are interpolated to the output rate and
+ * scaled by the feed's gain as they are mixed.
+ *
+ * What is mixed can also be recorded to a WAV file.
+ */
+
+#include "b-em.h"
+#include <math.h>
+#include <allegro5/allegro_audio.h>
+#include "sound.h"
+#include "soundfeed.h"
+
+#define SOUNDFEED_MAX 4
+
+#ifdef _MSC_VER
+/* Volatile accesses have acquire/release semantics with MSVC on x86. */
+#define RING_LOAD(v)     (*(volatile unsigned *)&(v))
+#define RING_STORE(v, x) (*(volatile unsigned *)&(v) = (x))
+#else
+#define RING_LOAD(v)     __atomic_load_n(&(v), __ATOMIC_ACQUIRE)
+#define RING_STORE(v, x) __atomic_store_n(&(v), (x), __ATOMIC_RELEASE)
+#endif
+
+struct soundfeed {
+    const char *name;
+    int freq;               // source sample rate.
+    int channels;
+    float gain;             // set by the emulation thread.
+    float *ring;
+    unsigned size;          // ring length in time samples, a power of 2.
+    unsigned head;          // moved on by the emulation thread only.
+    unsigned tail;          // moved on by the feed thread only.
+    unsigned latency;       // level the ring is kept at.
+    unsigned ended;         // source has stopped writing for now.
+    // The rest belongs to the feed thread.
+    bool running;
+    bool locked;            // rate fixed at exactly one.
+    double pos;             // position between the tail and the next sample.
+    double rate, base, level;
+    float last[2];
+};
+
+FILE *soundfeed_fp;
+
+static soundfeed_t *feeds[SOUNDFEED_MAX];
+static unsigned nfeeds;
+static ALLEGRO_VOICE *voice;
+static ALLEGRO_MIXER *mixer;
+static ALLEGRO_AUDIO_STREAM *stream;
+static ALLEGRO_EVENT_QUEUE *queue;
+static ALLEGRO_THREAD *thread;
+static ALLEGRO_MUTEX *rec_mutex;
+static unsigned mix_freq;
+static unsigned underruns;
+static bool rec_started;
+
+/* Called once for each fragment while running. */
+static void soundfeed_steer(soundfeed_t *feed, unsigned avail)
+{
+    double err;
+
+    feed->level += ((double)avail - feed->level) / 32;
+    err = (feed->level - feed->latency) / feed->latency;
+    if (feed->locked) {
+        if (fabs(err) < 0.5)
+            return;
+        log_debug("soundfeed: %s drifted to %.0f samples", feed->name, feed->level);
+        feed->locked = false;
+    }
+    feed->base += err * 0.002;
+    if (feed->base < 0.25)
+        feed->base = 0.25;
+    else if (feed->base > 4.0)
+        feed->base = 4.0;
+    feed->rate = feed->base * (1.0 + err * 0.4);
+    if (feed->rate < 0.25)
+        feed->rate = 0.25;
+    else if (feed->rate > 4.0)
+        feed->rate = 4.0;
+    if (fabs(err) < 0.1 && fabs(feed->base - 1.0) < 0.001) {
+        feed->locked = true;
+        feed->base = feed->rate = 1.0;
+    }
+}
+
+/* Mix one fragment's worth of a feed into out, which is stereo. */
+static void soundfeed_fill(soundfeed_t *feed, float *out)
+{
+    float *a, *b, f, l, r, gain = feed->gain;
+    unsigned mask = feed->size - 1, tail = feed->tail, avail, i;
+    int chans = feed->channels, n = 0;
+    double step;
+
+    avail = RING_LOAD(feed->head) - tail;
+    if (!feed->running && avail >= feed->latency) {
+        feed->running = true;
+        feed->level = avail;
+        feed->pos = 0.0;
+    }
+    if (feed->running) {
+        soundfeed_steer(feed, avail);
+        step = feed->rate * feed->freq / mix_freq;
+        l = feed->last[0];
+        r = feed->last[1];
+        for (; n < SOUNDFEED_FRAG; n++) {
+            i = (unsigned)feed->pos;
+            if (i + 1 >= avail)
+                break;
+            a = feed->ring + ((tail + i) & mask) * chans;
+            b = feed->ring + ((tail + i + 1) & mask) * chans;
+            f = feed->pos - i;
+            l = a[0] + (b[0] - a[0]) * f;
+            r = (chans == 2) ? a[1] + (b[1] - a[1]) * f : l;
+            out[n * 2]     += l * gain;
+            out[n * 2 + 1] += r * gain;
+            feed->pos += step;
+        }
+        i = (unsigned)feed->pos;
+        feed->pos -= i;
+        RING_STORE(feed->tail, tail + i);
+        feed->last[0] = l;
+        feed->last[1] = r;
+        if (n < SOUNDFEED_FRAG) {
+            feed->running = false;
+            if (!RING_LOAD(feed->ended)) {
+                // Probably reading faster than the source is writing so
+                // slow down now rather than wait for the level to show it.
+                log_debug("soundfeed: %s underrun", feed->name);
+                RING_STORE(underruns, underruns + 1);
+                feed->locked = false;
+                if ((feed->base *= 0.9) < 0.25)
+                    feed->base = 0.25;
+            }
+        }
+    }
+    // Fade out whatever was playing rather than stop dead.
+    if (n < SOUNDFEED_FRAG && (feed->last[0] != 0.0f || feed->last[1] != 0.0f)) {
+        for (; n < SOUNDFEED_FRAG; n++) {
+            out[n * 2]     += (feed->last[0] *= 0.995f) * gain;
+            out[n * 2 + 1] += (feed->last[1] *= 0.995f) * gain;
+        }
+        if (fabsf(feed->last[0]) < 1e-6f && fabsf(feed->last[1]) < 1e-6f)
+            feed->last[0] = feed->last[1] = 0.0f;
+    }
+}
+
+static void soundfeed_rec(const float *out)
+{
+    unsigned char bytes[SOUNDFEED_FRAG * 4], *p = bytes;
+    int n, s;
+
+    for (n = 0; n < SOUNDFEED_FRAG * 2; n++) {
+        s = (int)(out[n] * 32767.0f);
+        if (s)
+            rec_started = true;
+        *p++ = s;
+        *p++ = s >> 8;
+    }
+    // Leave out any silence before the sound starts.
+    if (rec_started)
+        fwrite(bytes, sizeof bytes, 1, soundfeed_fp);
+}
+
+static void soundfeed_mix(float *out)
+{
+    unsigned n;
+
+    memset(out, 0, SOUNDFEED_FRAG * 2 * sizeof(float));
+    for (n = 0; n < RING_LOAD(nfeeds); n++)
+        soundfeed_fill(feeds[n], out);
+    for (n = 0; n < SOUNDFEED_FRAG * 2; n++) {
+        if (out[n] > 1.0f)
+            out[n] = 1.0f;
+        else if (out[n] < -1.0f)
+            out[n] = -1.0f;
+    }
+    al_lock_mutex(rec_mutex);
+    if (soundfeed_fp)
+        soundfeed_rec(out);
+    al_unlock_mutex(rec_mutex);
+}
+
+static void *soundfeed_thread(ALLEGRO_THREAD *thread, void *arg)
+{
+    ALLEGRO_EVENT event;
+    float *frag;
+
+    while (!al_get_thread_should_stop(thread)) {
+        al_wait_for_event_timed(queue, &event, 0.05);
+        while ((frag = al_get_audio_stream_fragment(stream))) {
+            soundfeed_mix(frag);
+            al_set_audio_stream_fragment(stream, frag);
+            al_set_audio_stream_playing(stream, true);
+        }
+    }
+    return NULL;
+}
+
+static ALLEGRO_VOICE *soundfeed_create_voice(void)
+{
+    static const unsigned freqs[] = { FREQ_OUT, FREQ_DD };
+    static const ALLEGRO_AUDIO_DEPTH depths[] = {
+        ALLEGRO_AUDIO_DEPTH_FLOAT32,
+        ALLEGRO_AUDIO_DEPTH_INT24,
+        ALLEGRO_AUDIO_DEPTH_INT16
+    };
+    ALLEGRO_VOICE *voice;
+    int f, d;
+
+    for (f = 0; f < sizeof(freqs) / sizeof(freqs[0]); f++) {
+        for (d = 0; d < sizeof(depths) / sizeof(depths[0]); d++) {
+            if ((voice = al_create_voice(freqs[f], depths[d], ALLEGRO_CHANNEL_CONF_2))) {
+                log_debug("soundfeed: created voice at %uHz, depth %d", freqs[f], depths[d]);
+                mix_freq = freqs[f];
+                return voice;
+            }
+        }
+    }
+    return NULL;
+}
+
+/* Create the single output stream all the feeds are mixed into. */
+bool soundfeed_init(void)
+{
+    if ((voice = soundfeed_create_voice())) {
+        if ((mixer = al_create_mixer(mix_freq, ALLEGRO_AUDIO_DEPTH_FLOAT32, ALLEGRO_CHANNEL_CONF_2))) {
+            if (al_attach_mixer_to_voice(mixer, voice)) {
+                if ((stream = al_create_audio_stream(4, SOUNDFEED_FRAG, mix_freq, ALLEGRO_AUDIO_DEPTH_FLOAT32, ALLEGRO_CHANNEL_CONF_2))) {
+                    if (al_attach_audio_stream_to_mixer(stream, mixer)) {
+                        if ((queue = al_create_event_queue()) && (rec_mutex = al_create_mutex())) {
+                            al_register_event_source(queue, al_get_audio_stream_event_source(stream));
+                            if ((thread = al_create_thread(soundfeed_thread, NULL))) {
+                                log_debug("soundfeed: feed thread created");
+                                al_start_thread(thread);
+                                return true;
+                            }
+                            log_error("soundfeed: failed to create feed thread");
+                        } else
+                            log_error("soundfeed: unable to create event queue");
+                    } else
+                        log_error("soundfeed: unable to attach stream to mixer");
+                } else
+                    log_error("soundfeed: unable to create stream");
+            } else
+                log_error("soundfeed: unable to attach mixer to voice");
+        } else
+            log_error("soundfeed: unable to create mixer");
+    } else
+        log_error("soundfeed: unable to create voice");
+    return false;
+}
+
+/*
+ * Create a feed for a source at freq samples per second.  The latency
+ * is how many time samples are kept waiting in the ring and needs to be
+ * comfortably more than the source writes in one go.
+ */
+soundfeed_t *soundfeed_create(const char *name, int freq, int channels, int latency)
+{
+    soundfeed_t *feed;
+    unsigned size;
+
+    if (!thread)
+        return NULL;
+    if (nfeeds == SOUNDFEED_MAX) {
+        log_error("soundfeed: no room for a feed for %s", name);
+        return NULL;
+    }
+    for (size = 1024; size < latency * 4; size <<= 1)
+        ;
+    if (!(feed = calloc(1, sizeof(soundfeed_t)))) {
+        log_error("soundfeed: out of memory creating feed for %s", name);
+        return NULL;
+    }
+    if (!(feed->ring = calloc(size * channels, sizeof(float)))) {
+        log_error("soundfeed: out of memory creating feed for %s", name);
+        free(feed);
+        return NULL;
+    }
+    feed->name = name;
+    feed->freq = freq;
+    feed->channels = channels;
+    feed->gain = 1.0f;
+    feed->size = size;
+    feed->latency = latency;
+    feed->locked = true;
+    feed->rate = feed->base = 1.0;
+    feeds[nfeeds] = feed;
+    RING_STORE(nfeeds, nfeeds + 1);
+    return feed;
+}
+
+void soundfeed_gain(soundfeed_t *feed, float gain)
+{
+    feed->gain = gain;
+}
+
+/*
+ * Write len time samples, interleaved if there is more than one channel,
+ * returning how many there was room for.
+ */
+int soundfeed_write(soundfeed_t *feed, const float *samples, int len)
+{
+    unsigned head = feed->head, space, start, first;
+    int chans = feed->channels;
+
+    if (feed->ended)
+        RING_STORE(feed->ended, 0);
+    space = feed->size - (head - RING_LOAD(feed->tail));
+    if (len > space)
+        len = space;
+    start = head & (feed->size - 1);
+    first = feed->size - start;
+    if (first > len)
+        first = len;
+    memcpy(feed->ring + start * chans, samples, first * chans * sizeof(float));
+    memcpy(feed->ring, samples + first * chans, (len - first) * chans * sizeof(float));
+    RING_STORE(feed->head, head + len);
+    return len;
+}
+
+/*
+ * Tell the feed the source has stopped writing so that running dry is
+ * not an underrun.  Writing again starts it once more.
+ */
+void soundfeed_end(soundfeed_t *feed)
+{
+    RING_STORE(feed->ended, 1);
+}
+
+unsigned soundfeed_underruns(void)
+{
+    return RING_LOAD(underruns);
+}
+
+FILE *soundfeed_rec_start(const char *filename)
+{
+    static const char zeros[] = { 0, 0, 0, 0 };
+    FILE *fp;
+
+    if (!thread) {
+        log_error("soundfeed: no sound output to record");
+        return NULL;
+    }
+    if ((fp = fopen(filename, "wb"))) {
+        fseek(fp, 44, SEEK_SET);
+        al_lock_mutex(rec_mutex);
+        fwrite(zeros, 4, 1, fp);
+        rec_started = false;
+        soundfeed_fp = fp;
+        al_unlock_mutex(rec_mutex);
+    }
+    else
+        log_error("unable to open %s for writing: %s", filename, strerror(errno));
+    return fp;
+}
+
+static void fput16le(uint16_t v, FILE *fp)
+{
+    putc(v & 0xff, fp);
+    putc((v >> 8) & 0xff, fp);
+}
+
+static void fput32le(uint32_t v, FILE *fp)
+{
+    putc(v & 0xff, fp);
+    putc((v >> 8) & 0xff, fp);
+    putc((v >> 16) & 0xff, fp);
+    putc((v >> 24) & 0xff, fp);
+}
+
+void soundfeed_rec_stop(void)
+{
+    FILE *fp;
+    long size;
+
+    al_lock_mutex(rec_mutex);
+    fp = soundfeed_fp;
+    soundfeed_fp = NULL;
+    al_unlock_mutex(rec_mutex);
+    if (fp) {
+        size = ftell(fp) - 8;
+        fseek(fp, 0, SEEK_SET);
+        fwrite("RIFF", 4, 1, fp);
+        fput32le(size, fp);
+        fwrite("WAVEfmt ", 8, 1, fp);
+        fput32le(16, fp);            // format chunk size.
+        fput16le(1, fp);             // format 1=PCM.
+        fput16le(2, fp);             // channels 2=stereo.
+        fput32le(mix_freq, fp);      // sample rate.
+        fput32le(mix_freq * 4, fp);  // byte rate.
+        fput16le(4, fp);             // block align.
+        fput16le(16, fp);            // bits per sample.
+        fwrite("data", 4, 1, fp);
+        fput32le(size - 36, fp);     // data size.
+        fclose(fp);
+    }
+}
+
+void soundfeed_close(void)
+{
+    unsigned n;
+
+    if (thread) {
+        al_join_thread(thread, NULL);
+        al_destroy_thread(thread);
+        thread = NULL;
+    }
+    if (soundfeed_fp)
+        soundfeed_rec_stop();
+    for (n = 0; n < nfeeds; n++) {
+        free(feeds[n]->ring);
+        free(feeds[n]);
+    }
+    nfeeds = 0;
+    if (rec_mutex) {
+        al_destroy_mutex(rec_mutex);
+        rec_mutex = NULL;
+    }
+    if (queue) {
+        al_destroy_event_queue(queue);
+        queue = NULL;
+    }
+    if (stream) {
+        al_destroy_audio_stream(stream);
+        stream = NULL;
+    }
+    if (mixer) {
+        al_destroy_mixer(mixer);
+        mixer = NULL;
+    }
+    if (voice) {
+        al_destroy_voice(voice);
+        voice = NULL;
+    }
+}
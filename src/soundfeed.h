@@ -0,0 +1,30 @@
+#ifndef __INC_SOUNDFEED_H
+#define __INC_SOUNDFEED_H
+
+/*
+ * Sound feeds and the mixer.
+ *
+ * Each sound source writes what it renders, at its own sample rate,
+ * into a feed from the emulation thread.  A separate thread mixes all
+ * the feeds into a single stereo audio stream as the stream asks for
+ * more, converting each to the output rate and following any difference
+ * between the emulated and audio clocks.
+ */
+
+#define SOUNDFEED_FRAG 512  // output fragment length in time samples
+
+typedef struct soundfeed soundfeed_t;
+
+bool soundfeed_init(void);
+soundfeed_t *soundfeed_create(const char *name, int freq, int channels, int latency);
+void soundfeed_gain(soundfeed_t *feed, float gain);
+int soundfeed_write(soundfeed_t *feed, const float *samples, int len);
+void soundfeed_end(soundfeed_t *feed);
+void soundfeed_close(void);
+unsigned soundfeed_underruns(void);
+FILE *soundfeed_rec_start(const char *filename);
+void soundfeed_rec_stop(void);
+
+extern FILE *soundfeed_fp;
+
+#endif
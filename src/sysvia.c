@@ -11,7 +11,12 @@
 #include "sn76489.h"
 #include "video.h"
 
-VIA sysvia;
+static void sysvia_timer_event(void)
+{
+        via_sync(&sysvia);
+}
+
+VIA sysvia = { .timer_event = SCHED_EVENT("sysvia", sysvia_timer_event) };
 
 #define KB_CAPSLOCK_FLAG 0x0400
 #define KB_SCROLOCK_FLAG 0x0100
@@ -96,6 +101,8 @@ static void sysvia_write_IC32(uint8_t val)
         if (!(IC32 & 1) && (oldIC32 & 1))
            sn_write(sdbval);
 
+        if ((IC32 ^ oldIC32) & 0x30)
+                video_sync();
         scrsize = ((IC32 & 0x10) ? 2 : 0) | ((IC32 & 0x20) ? 1 : 0);
 
         if ((IC32 & 0xC0) != (oldIC32 & 0xC0))
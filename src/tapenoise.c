@@ -5,11 +5,11 @@
 #include <math.h>
 #include "ddnoise.h"
 #include "tapenoise.h"
+#include "perf.h"
 #include "sound.h"
+#include "soundfeed.h"
 
-static ALLEGRO_VOICE *voice;
-static ALLEGRO_MIXER *mixer;
-static ALLEGRO_AUDIO_STREAM *stream;
+static soundfeed_t *feed;
 
 static int tpnoisep = 0;
 static int tmcount = 0;
@@ -21,7 +21,7 @@ static int sinewave[32];
 
 #define PI 3.142
 
-static ALLEGRO_SAMPLE *tsamples[2];
+static ddnoise_sample_t *tsamples[2];
 
 void tapenoise_init(ALLEGRO_EVENT_QUEUE *queue)
 {
@@ -29,55 +29,40 @@ void tapenoise_init(ALLEGRO_EVENT_QUEUE *queue)
     int c;
 
     log_debug("tapenoise: tapenoise_init");
-    if ((voice = al_create_voice(FREQ_DD, ALLEGRO_AUDIO_DEPTH_INT16, ALLEGRO_CHANNEL_CONF_1))) {
-        if ((mixer = al_create_mixer(FREQ_DD, ALLEGRO_AUDIO_DEPTH_INT16, ALLEGRO_CHANNEL_CONF_1))) {
-            if (al_attach_mixer_to_voice(mixer, voice)) {
-                if ((stream = al_create_audio_stream(4, BUFLEN_DD, FREQ_DD, ALLEGRO_AUDIO_DEPTH_INT16, ALLEGRO_CHANNEL_CONF_1))) {
-                    if (al_attach_audio_stream_to_mixer(stream, mixer)) {
-                        dir = al_create_path_for_directory("ddnoise");
-                        tsamples[0] = find_load_wav(dir, "motoron");
-                        tsamples[1] = find_load_wav(dir, "motoroff");
-                        al_destroy_path(dir);
-                        for (c = 0; c < 32; c++)
-                            sinewave[c] = (int)(sin((float)c * ((2.0 * PI) / 32.0)) * 128.0);
-                    } else
-                        log_error("sound: unable to attach stream to mixer for tape noise");
-                } else
-                    log_error("sound: unable to create stream for tape noise");
-            } else
-                log_error("sound: unable to attach mixer to voice for tape noise");
-        } else
-            log_error("sound: unable to create mixer for tape noise");
-    } else
-        log_error("sound: unable to create voice for for tape noise");
+    feed = soundfeed_create("tapenoise", FREQ_DD, 1, BUFLEN_DD * 4);
+    dir = al_create_path_for_directory("ddnoise");
+    tsamples[0] = find_load_wav(dir, "motoron");
+    tsamples[1] = find_load_wav(dir, "motoroff");
+    al_destroy_path(dir);
+    for (c = 0; c < 32; c++)
+        sinewave[c] = (int)(sin((float)c * ((2.0 * PI) / 32.0)) * 128.0);
 }
 
 void tapenoise_close()
 {
-    ALLEGRO_SAMPLE *smp;
+    ddnoise_sample_t *smp;
 
     log_debug("tapenoise: tapenoise_close");
     if ((smp = tsamples[0]))
-        al_destroy_sample(smp);
+        free_wav(smp);
     if ((smp = tsamples[1]))
-        al_destroy_sample(smp);
+        free_wav(smp);
 }
 
 static void send_buffer(void)
 {
-    int16_t *tapebuffer;
+    float buf[BUFLEN_DD];
     int c;
 
-    tpnoisep = 0;
-    if ((tapebuffer = al_get_audio_stream_fragment(stream))) {
-
-        for (c = 0; c < BUFLEN_DD; c++) {
-            tapebuffer[c] = tapenoise[c];
-            tapenoise[c] = 0;
+    if (feed) {
+        for (c = 0; c < tpnoisep; c++)
+            buf[c] = tapenoise[c] / 32768.0f;
+        if (soundfeed_write(feed, buf, tpnoisep) < tpnoisep) {
+            log_debug("tapenoise: overrun");
+            perf_count.sound_overruns++;
         }
-        al_set_audio_stream_fragment(stream, tapebuffer);
-    } else
-        log_debug("tapenoise: overrun");
+    }
+    tpnoisep = 0;
 }
 
 static void add_high(void)
@@ -149,9 +134,14 @@ void tapenoise_adddat(uint8_t dat)
 
 void tapenoise_motorchange(int stat)
 {
-    ALLEGRO_SAMPLE *smp;
+    ddnoise_sample_t *smp;
 
     log_debug("tapenoise: motorchange, stat=%d", stat);
+    if (!stat && feed) {
+        // No more tones until the motor starts again.
+        send_buffer();
+        soundfeed_end(feed);
+    }
     if ((stat < 2) && (smp = tsamples[stat]))
-        al_play_sample(smp, 1.0, 0.0, 1.0, ALLEGRO_PLAYMODE_ONCE, NULL);
+        ddnoise_play_tape(smp);
 }
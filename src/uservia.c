@@ -11,7 +11,12 @@
 #include "music4000.h"
 #include "sound.h"
 
-VIA uservia;
+static void uservia_timer_event(void)
+{
+        via_sync(&uservia);
+}
+
+VIA uservia = { .timer_event = SCHED_EVENT("uservia", uservia_timer_event) };
 
 uint8_t lpt_dac;
 ALLEGRO_USTR *prt_clip_str;
@@ -48,7 +53,7 @@ void uservia_write_portA(uint8_t val)
         log_debug("uservia: set CA1 low for printer");
     }
     else
-        lpt_dac = val; /*Printer port - no printer, just 8-bit DAC*/
+        sound_dac_write(val); /*Printer port - no printer, just 8-bit DAC*/
 }
 
 void printer_set_ca2(int level)
@@ -40,7 +40,7 @@ static void via_updateIFR(VIA *v)
         }
 }
 
-void via_updatetimers(VIA *v)
+static void via_updatetimers(VIA *v)
 {
         if (v->t1c<-3)
         {
@@ -72,8 +72,73 @@ void via_updatetimers(VIA *v)
         }
 }
 
+static void via_shift(VIA *v, int cycles);
+
+/*
+ * The timers are not counted down on every cycle.  Instead the time
+ * since they were last brought up to date is applied whenever the VIA
+ * is accessed and an event is scheduled for the cycle on which the
+ * next timer interrupt is due.
+ */
+
+static void via_schedule(VIA *v)
+{
+        int64_t next = INT64_MAX;
+
+        if ((v->acr & 0x1c) == 0x18)
+                next = 1; /*Shift register clocked every cycle*/
+        else
+        {
+                if (!v->t1hit)
+                        next = v->t1c + 4;
+                if (!v->t2hit && !(v->acr & 0x20) && v->t2c + 4 < next)
+                        next = v->t2c + 4;
+        }
+        if (next == INT64_MAX)
+                sched_cancel(&v->timer_event);
+        else
+                sched_at(&v->timer_event, v->sync + next);
+}
+
+void via_sync(VIA *v)
+{
+        int64_t elapsed = sched_now - v->sync;
+        int64_t t1, t2, period;
+
+        if (!elapsed)
+                return;
+        v->sync = sched_now;
+
+        t1 = v->t1c - elapsed;
+        if (t1 < -3 && v->t1hit)
+        {
+                /*Reloads with no interrupt to raise*/
+                period = v->t1l + 4;
+                t1 += ((-3 - t1 + period - 1) / period) * period;
+        }
+        v->t1c = t1;
+        if (!(v->acr & 0x20))
+        {
+                t2 = v->t2c - elapsed;
+                if (t2 < -0x20003 && v->t2hit)
+                        t2 = -4 - ((-4 - t2) % 0x20000); /*Keep within 16 bits*/
+                v->t2c = t2;
+        }
+        if (v->t1c < -3 || (v->t2c < -3 && !v->t2hit))
+        {
+                via_updatetimers(v);
+                via_schedule(v);
+        }
+        if ((v->acr & 0x1c) == 0x18)
+        {
+                via_shift(v, (int)elapsed);
+                via_schedule(v);
+        }
+}
+
 void via_write(VIA *v, uint16_t addr, uint8_t val)
 {
+        via_sync(v);
         switch (addr&0xF)
         {
             case ORA:
@@ -132,6 +197,7 @@ void via_write(VIA *v, uint16_t addr, uint8_t val)
                 break;
             case ACR:
                 v->acr  = val;
+                via_schedule(v);
                 break;
             case PCR:
                 v->pcr  = val;
@@ -186,6 +252,7 @@ void via_write(VIA *v, uint16_t addr, uint8_t val)
                 v->t1hit = 0;
                 v->ifr &= ~INT_TIMER1;
                 via_updateIFR(v);
+                via_schedule(v);
                 break;
             case T2CL:
                 v->t2l &= 0x1FE00;
@@ -204,6 +271,7 @@ void via_write(VIA *v, uint16_t addr, uint8_t val)
                 v->ifr &= ~INT_TIMER2;
                 via_updateIFR(v);
                 v->t2hit=0;
+                via_schedule(v);
                 break;
             case IER:
                 if (val & 0x80)
@@ -222,6 +290,7 @@ void via_write(VIA *v, uint16_t addr, uint8_t val)
 uint8_t via_read(VIA *v, uint16_t addr)
 {
         uint8_t temp;
+        via_sync(v);
         switch (addr&0xF)
         {
             case ORA:
@@ -356,7 +425,7 @@ void via_set_cb2(VIA *v, int level)
         v->cb2 = level;
 }
 
-void via_shift(VIA *v, int cycles) {
+static void via_shift(VIA *v, int cycles) {
     int cb1;
 
     if ((v->acr & 0x1c) == 0x18) {
@@ -399,6 +468,8 @@ void via_reset(VIA *v)
         v->t2c   = v->t2l   = 0x1FFFE;
         v->t1hit = v->t2hit = 1;
         v->acr   = v->pcr   = 0;
+        v->sync  = sched_now;
+        via_schedule(v);
 
         v->read_portA  = v->read_portB  = via_read_null;
         v->write_portA = v->write_portB = via_write_null;
@@ -408,6 +479,7 @@ void via_reset(VIA *v)
 
 void via_savestate(VIA *v, FILE *f)
 {
+        via_sync(v);
         putc(v->ora,f);
         putc(v->orb,f);
         putc(v->ira,f);
@@ -454,4 +526,6 @@ void via_loadstate(VIA *v, FILE *f)
         v->t2hit=getc(f);
         v->ca1=getc(f);
         v->ca2=getc(f);
+        v->sync=sched_now;
+        via_schedule(v);
 }
@@ -1,6 +1,8 @@
 #ifndef __INC_VIA_H
 #define __INC_VIA_H
 
+#include "sched.h"
+
 typedef struct VIA
 {
         uint8_t  ora,   orb,   ira,   irb;
@@ -13,6 +15,8 @@ typedef struct VIA
         int      ca1,   ca2,   cb1,   cb2;
         int      intnum;
         int      sr_count;
+        uint64_t sync;          // cycle the timers were last brought up to date.
+        sched_event_t timer_event;
 
         uint8_t  (*read_portA)(void);
         uint8_t  (*read_portB)(void);
@@ -29,8 +33,7 @@ typedef struct VIA
 uint8_t via_read(VIA *v, uint16_t addr);
 void    via_write(VIA *v, uint16_t addr, uint8_t val);
 void    via_reset(VIA *v);
-void    via_updatetimers(VIA *v);
-void    via_shift(VIA *v, int cycles);
+void    via_sync(VIA *v);
 
 void via_set_ca1(VIA *v, int level);
 void via_set_ca2(VIA *v, int level);
@@ -40,14 +43,4 @@ void via_set_cb2(VIA *v, int level);
 void via_savestate(VIA *v, FILE *f);
 void via_loadstate(VIA *v, FILE *f);
 
-static inline void via_poll(VIA *v, int cycles) {
-    v->t1c -= cycles;
-    if (!(v->acr & 0x20))
-        v->t2c -= cycles;
-    if (v->t1c < -3 || v->t2c < -3)
-        via_updatetimers(v);
-    if (v->acr & 0x1c)
-        via_shift(v, cycles);
-}
-
 #endif
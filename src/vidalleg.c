@@ -2,7 +2,9 @@
   Allegro video code*/
 #include <allegro5/allegro_primitives.h>
 #include "b-em.h"
+#include "main.h"
 #include "pal.h"
+#include "perf.h"
 #include "serial.h"
 #include "tape.h"
 #include "video.h"
@@ -19,8 +21,20 @@ char vid_scrshotname[260];
 
 static ALLEGRO_BITMAP *scrshotb, *scrshotb2;
 
+// Visible area of the last frame displayed, used for end-of-run dumps.
+static int dump_x0 = BORDER_MED_X_START_GRA, dump_y0 = BORDER_MED_Y_START_GRA;
+static int dump_x1 = BORDER_MED_X_END_GRA,   dump_y1 = BORDER_MED_Y_END_GRA;
+
 int vid_clear = 0;
 
+// What the display was last drawn from, to tell when it is still valid.
+static struct {
+    int x0, y0, x1, y1;
+    int scr_x_start, scr_y_start, scr_x_size, scr_y_size;
+    bool interlace, linedbl, pal, scanlines;
+} shown;
+static bool redraw = true;
+
 int winsizex, winsizey;
 int scr_x_start, scr_x_size, scr_y_start, scr_y_size;
 
@@ -35,14 +49,21 @@ void video_clearscreen()
     al_clear_to_color(black);
     al_set_target_bitmap(b32);
     al_clear_to_color(black);
-    al_set_target_backbuffer(al_get_current_display());
-    al_clear_to_color(black);
+    if (!headless) {
+        al_set_target_backbuffer(al_get_current_display());
+        al_clear_to_color(black);
+    }
     al_set_target_bitmap(b);
     al_clear_to_color(black);
+    dirty_first_y = 0;
+    dirty_last_y = 800;
+    redraw = true;
 }
 
 void video_close()
 {
+    if (bvid)
+        al_destroy_bitmap(bvid);
     al_destroy_bitmap(b32);
     al_destroy_bitmap(b16);
     al_destroy_bitmap(b);
@@ -99,6 +120,7 @@ void video_enterfullscreen()
         log_error("vidalleg: could not set graphics mode to full-screen");
         fullscreen = 0;
     }
+    redraw = true;
 }
 
 void video_set_window_size(void)
@@ -141,6 +163,7 @@ void video_update_window_size(ALLEGRO_EVENT *event)
         log_debug("vidalleg: video_update_window_size, scr_x_size=%d, scr_y_size=%d", scr_x_size, scr_y_size);
     }
     al_acknowledge_resize(event->display.source);
+    redraw = true;
 }
 
 void video_leavefullscreen(void)
@@ -153,6 +176,7 @@ void video_leavefullscreen(void)
     scr_x_size = winsizex = al_get_display_width(display);
     scr_y_start = 0;
     scr_y_size = winsizey = al_get_display_height(display);
+    redraw = true;
 }
 
 void video_toggle_fullscreen(void)
@@ -175,33 +199,176 @@ static inline void upscale_only(ALLEGRO_BITMAP *src, int sx, int sy, int sw, int
         al_draw_bitmap_region(src, sx, sy, sw, sh, dx, dy, 0);
 }
 
-void video_doblit(bool non_ttx, uint8_t vtotal)
+/*
+ * Copy the rows of the emulated screen that have changed to the display
+ * bitmap, returning false if none had.  Rows marked as changed by the
+ * renderer are checked against a copy of what was last uploaded as
+ * some, such as the cursor, are redrawn to the same pixels every frame.
+ */
+
+static bool upload_rows(int y0, int y1, bool all)
+{
+    static uint32_t *shown_pixels;
+    ALLEGRO_LOCKED_REGION *dst;
+    int y, first = 800, last = 0;
+    uint32_t *src, *copy;
+
+    if (!shown_pixels) {
+        if (!(shown_pixels = malloc(1280 * 800 * sizeof(uint32_t)))) {
+            log_fatal("vidalleg: out of memory allocating display copy");
+            exit(1);
+        }
+        all = true;
+    }
+    if (y0 < 0)
+        y0 = 0;
+    if (y1 > 800)
+        y1 = 800;
+    for (y = y0; y < y1; y++) {
+        src = (uint32_t *)((char *)region->data + region->pitch * y);
+        copy = shown_pixels + y * 1280;
+        if (all || memcmp(copy, src, 1280 * sizeof(uint32_t))) {
+            memcpy(copy, src, 1280 * sizeof(uint32_t));
+            if (y < first)
+                first = y;
+            last = y + 1;
+        }
+    }
+    if (first >= last)
+        return false;
+    if ((dst = al_lock_bitmap_region(bvid, 0, first, 1280, last - first, ALLEGRO_PIXEL_FORMAT_ARGB_8888, ALLEGRO_LOCK_WRITEONLY))) {
+        for (y = first; y < last; y++)
+            memcpy((char *)dst->data + dst->pitch * (y - first), shown_pixels + y * 1280, 1280 * sizeof(uint32_t));
+        al_unlock_bitmap(bvid);
+    }
+    return true;
+}
+
+static void blit_to_display(void)
 {
-    int c, xsize, ysize;
+    int c;
+    bool same, changed;
     ALLEGRO_COLOR black;
 
+    // Nothing to do if no pixel has changed and the display still shows
+    // the same part of the screen in the same way.  The PAL filter's
+    // subcarrier phase moves on every frame so that is always redrawn.
+    if (!vid_pal) {
+        same = !redraw && shown.x0 == firstx && shown.y0 == firsty && shown.x1 == lastx && shown.y1 == lasty
+            && shown.scr_x_start == scr_x_start && shown.scr_y_start == scr_y_start
+            && shown.scr_x_size == scr_x_size && shown.scr_y_size == scr_y_size
+            && shown.interlace == vid_interlace && shown.linedbl == vid_linedbl
+            && shown.pal == vid_pal && shown.scanlines == vid_scanlines;
+        if (same)
+            changed = upload_rows(dirty_first_y, dirty_last_y, false);
+        else
+            changed = upload_rows(0, 800, true);
+        dirty_first_y = 800;
+        dirty_last_y = 0;
+        if (same && !changed) {
+            perf_count.frames_unchanged++;
+            return;
+        }
+    }
+    redraw = false;
+    shown.x0 = firstx;
+    shown.y0 = firsty;
+    shown.x1 = lastx;
+    shown.y1 = lasty;
+    shown.scr_x_start = scr_x_start;
+    shown.scr_y_start = scr_y_start;
+    shown.scr_x_size = scr_x_size;
+    shown.scr_y_size = scr_y_size;
+    shown.interlace = vid_interlace;
+    shown.linedbl = vid_linedbl;
+    shown.pal = vid_pal;
+    shown.scanlines = vid_scanlines;
+
+    if (vid_scanlines) {
+        al_set_target_bitmap(b16);
+        al_clear_to_color(al_map_rgb(0, 0,0));
+        for (c = firsty; c < lasty; c++)
+            al_draw_bitmap_region(bvid, firstx, c, lastx - firstx, 1, 0, c << 1, 0);
+        upscale_only(b16, 0, firsty << 1, lastx - firstx, (lasty - firsty) << 1, scr_x_start, scr_y_start, scr_x_size, scr_y_size);
+    }
+    else if (vid_interlace && vid_pal) {
+        pal_convert(firstx, (firsty << 1) + (interlline ? 1 : 0), lastx, (lasty << 1) + (interlline ? 1 : 0), 2);
+        al_set_target_backbuffer(al_get_current_display());
+        upscale_only(b32, firstx, firsty << 1, lastx - firstx, (lasty - firsty) << 1, scr_x_start, scr_y_start, scr_x_size, scr_y_size);
+    }
+    else if (vid_pal) {
+        pal_convert(firstx, firsty, lastx, lasty, 1);
+        al_set_target_backbuffer(al_get_current_display());
+        upscale_only(b32, firstx, firsty << 1, lastx - firstx, (lasty - firsty) << 1, scr_x_start, scr_y_start, scr_x_size, scr_y_size);
+    }
+    else {
+        if (vid_interlace || vid_linedbl)
+            upscale_only(bvid, firstx, firsty << 1, lastx - firstx, (lasty - firsty) << 1, scr_x_start, scr_y_start, scr_x_size, scr_y_size);
+        else
+            upscale_only(bvid, firstx, firsty, lastx - firstx, lasty - firsty, scr_x_start, scr_y_start, scr_x_size, scr_y_size);
+    }
+
+    if (scr_x_start > 0) {
+        black = al_map_rgb(0, 0, 0);
+        // fill the gap between the left screen edge and the BBC image.
+        al_draw_filled_rectangle(0, 0, scr_x_start, scr_y_size, black);
+        // fill the gap between the BBC image and the right screen edge.
+        al_draw_filled_rectangle(scr_x_start + scr_x_size, 0, winsizex, winsizey, black);
+    }
+    else if (scr_y_start > 0) {
+        black = al_map_rgb(0, 0, 0);
+        // fill the gap between the top of the screen and the BBC image.
+        al_draw_filled_rectangle(0, 0, scr_x_size, scr_y_start, black);
+        // fill the gap between the BBC image and the bottom of the screen.
+        al_draw_filled_rectangle(0, scr_y_start + scr_y_size, winsizex, winsizey, black);
+    }
+    al_flip_display();
+}
+
+static bool save_screenshot(const char *name, int x0, int y0, int x1, int y1)
+{
+    int xsize, ysize;
+    bool ok;
+
+    xsize = x1 - x0;
+    ysize = y1 - y0 + 1;
+    scrshotb  = al_create_bitmap(xsize, ysize << 1);
+    if (vid_interlace || vid_linedbl) {
+        al_set_target_bitmap(scrshotb);
+        al_draw_bitmap_region(b, x0, y0 << 1, xsize, ysize << 1, 0, 0, 0);
+        ok = al_save_bitmap(name, scrshotb);
+    }
+    else {
+        scrshotb2 = al_create_bitmap(x1 - x0, y1 - y0);
+        al_set_target_bitmap(scrshotb2);
+        al_draw_bitmap_region(b, x0, y0, xsize, ysize, 0, 0, 0);
+        al_set_target_bitmap(scrshotb);
+        al_draw_scaled_bitmap(scrshotb2, 0, 0, xsize, ysize, 0, 0, xsize, ysize << 1, 0);
+        ok = al_save_bitmap(name, scrshotb);
+        al_destroy_bitmap(scrshotb2);
+    }
+    al_destroy_bitmap(scrshotb);
+    return ok;
+}
+
+bool video_dump_screen(const char *name)
+{
+    bool ok;
+
+    al_unlock_bitmap(b);
+    ok = save_screenshot(name, dump_x0, dump_y0, dump_x1, dump_y1);
+    region = al_lock_bitmap(b, ALLEGRO_PIXEL_FORMAT_ARGB_8888, ALLEGRO_LOCK_READWRITE);
+    if (!ok)
+        log_error("vidalleg: unable to save screen dump %s", name);
+    return ok;
+}
+
+void video_doblit(bool non_ttx, uint8_t vtotal)
+{
     if (vid_savescrshot) {
         vid_savescrshot--;
-        if (!vid_savescrshot) {
-            xsize = lastx - firstx;
-            ysize = lasty - firsty + 1;
-            scrshotb  = al_create_bitmap(xsize, ysize << 1);
-            if (vid_interlace || vid_linedbl) {
-                al_set_target_bitmap(scrshotb);
-                al_draw_bitmap_region(b, firstx, firsty << 1, xsize, ysize << 1, 0, 0, 0);
-                al_save_bitmap(vid_scrshotname, scrshotb);
-            }
-            else {
-                scrshotb2 = al_create_bitmap(lastx - firstx,  lasty-firsty);
-                al_set_target_bitmap(scrshotb2);
-                al_draw_bitmap_region(b, firstx, firsty, xsize, ysize, 0, 0, 0);
-                al_set_target_bitmap(scrshotb);
-                al_draw_scaled_bitmap(scrshotb2, 0, 0, xsize, ysize, 0, 0, xsize, ysize << 1, 0);
-                al_save_bitmap(vid_scrshotname, scrshotb);
-                al_destroy_bitmap(scrshotb2);
-            }
-            al_destroy_bitmap(scrshotb);
-        }
+        if (!vid_savescrshot)
+            save_screenshot(vid_scrshotname, firstx, firsty, lastx, lasty);
     }
 
     fskipcount++;
@@ -262,50 +429,15 @@ void video_doblit(bool non_ttx, uint8_t vtotal)
             }
         }
         fskipcount = 0;
-        if (vid_scanlines) {
-            al_unlock_bitmap(b);
-            al_set_target_bitmap(b16);
-            al_clear_to_color(al_map_rgb(0, 0,0));
-            for (c = firsty; c < lasty; c++)
-                al_draw_bitmap_region(b, firstx, c, lastx - firstx, 1, 0, c << 1, 0);
-            upscale_only(b16, 0, firsty << 1, lastx - firstx, (lasty - firsty) << 1, scr_x_start, scr_y_start, scr_x_size, scr_y_size);
-            region = al_lock_bitmap(b, ALLEGRO_PIXEL_FORMAT_ARGB_8888, ALLEGRO_LOCK_READWRITE);
-        }
-        else if (vid_interlace && vid_pal) {
-            pal_convert(firstx, (firsty << 1) + (interlline ? 1 : 0), lastx, (lasty << 1) + (interlline ? 1 : 0), 2);
-            al_set_target_backbuffer(al_get_current_display());
-            upscale_only(b32, firstx, firsty << 1, lastx - firstx, (lasty - firsty) << 1, scr_x_start, scr_y_start, scr_x_size, scr_y_size);
-        }
-        else if (vid_pal) {
-            pal_convert(firstx, firsty, lastx, lasty, 1);
-            al_set_target_backbuffer(al_get_current_display());
-            upscale_only(b32, firstx, firsty << 1, lastx - firstx, (lasty - firsty) << 1, scr_x_start, scr_y_start, scr_x_size, scr_y_size);
-        }
-        else {
-            al_unlock_bitmap(b);
-            if (vid_interlace || vid_linedbl)
-                upscale_only(b, firstx, firsty << 1, lastx - firstx, (lasty - firsty) << 1, scr_x_start, scr_y_start, scr_x_size, scr_y_size);
-            else
-                upscale_only(b, firstx, firsty, lastx - firstx, lasty - firsty, scr_x_start, scr_y_start, scr_x_size, scr_y_size);
-            region = al_lock_bitmap(b, ALLEGRO_PIXEL_FORMAT_ARGB_8888, ALLEGRO_LOCK_READWRITE);
-        }
-
-        if (scr_x_start > 0) {
-            black = al_map_rgb(0, 0, 0);
-            // fill the gap between the left screen edge and the BBC image.
-            al_draw_filled_rectangle(0, 0, scr_x_start, scr_y_size, black);
-            // fill the gap between the BBC image and the right screen edge.
-            al_draw_filled_rectangle(scr_x_start + scr_x_size, 0, winsizex, winsizey, black);
-        }
-        else if (scr_y_start > 0) {
-            black = al_map_rgb(0, 0, 0);
-            // fill the gap between the top of the screen and the BBC image.
-            al_draw_filled_rectangle(0, 0, scr_x_size, scr_y_start, black);
-            // fill the gap between the BBC image and the bottom of the screen.
-            al_draw_filled_rectangle(0, scr_y_start + scr_y_size, winsizex, winsizey, black);
-        }
-        al_flip_display();
+        dump_x0 = firstx;
+        dump_y0 = firsty;
+        dump_x1 = lastx;
+        dump_y1 = lasty;
+        if (!headless)
+            blit_to_display();
     }
+    else
+        perf_count.frames_skipped++;
     firstx = firsty = 65535;
     lastx  = lasty  = 0;
 }
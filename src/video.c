@@ -2,13 +2,17 @@
   Video emulation
   Incorporates 6845 CRTC, Video ULA and SAA5050*/
 
+#include <limits.h>
 #include <allegro5/allegro_native_dialog.h>
 #include <allegro5/allegro_primitives.h>
 #include "b-em.h"
 
 #include "bbctext.h"
+#include "main.h"
 #include "mem.h"
 #include "model.h"
+#include "perf.h"
+#include "sched.h"
 #include "serial.h"
 #include "tape.h"
 #include "via.h"
@@ -36,6 +40,9 @@ uint16_t ma;
 static uint16_t maback;
 static int vdispen, dispen;
 
+static uint64_t video_synced;
+static void video_update(void);
+
 void crtc_reset()
 {
     hc = vc = sc = vadj = 0;
@@ -48,10 +55,12 @@ void crtc_write(uint16_t addr, uint8_t val)
     if (!(addr & 1))
         crtc_i = val & 31;
     else {
+        video_sync();
         val &= crtc_mask[crtc_i];
         crtc[crtc_i] = val;
         if (crtc_i == 6 && vc == val)
             vdispen = 0;
+        video_update();
     }
 }
 
@@ -64,6 +73,7 @@ uint8_t crtc_read(uint16_t addr)
 
 void crtc_latchpen()
 {
+    video_sync();
     crtc[0x10] = (ma >> 8) & 0x3F;
     crtc[0x11] = ma & 0xFF;
 }
@@ -71,6 +81,8 @@ void crtc_latchpen()
 void crtc_savestate(FILE * f)
 {
     int c;
+
+    video_sync();
     for (c = 0; c < 18; c++)
         putc(crtc[c], f);
     putc(vc, f);
@@ -94,6 +106,8 @@ void crtc_loadstate(FILE * f)
     ma |= getc(f) << 8;
     maback = getc(f);
     maback |= getc(f) << 8;
+    video_synced = sched_now;
+    video_update();
 }
 
 
@@ -107,6 +121,14 @@ int nula_collook[16];           // maps palette (logical) colours to 12-bit RGB
 
 static uint8_t table4bpp[4][256][16];
 
+/*
+ * Colours of the pixels for each byte value in the current ULA mode,
+ * including the NULA attribute modes, with the palette applied.
+ * Rebuilt when the mode or palette changes.
+ */
+static uint32_t pixlut[256][16];
+static int pixlut_layout = -1;
+
 static int nula_pal_write_flag = 0;
 static uint8_t nula_pal_first_byte;
 uint8_t nula_flash[8];
@@ -132,20 +154,51 @@ static inline int get_pixel(ALLEGRO_LOCKED_REGION *region, int x, int y)
     return *((uint32_t *)((char *)region->data + region->pitch * y + x * region->pixel_size));
 }
 
+/*
+ * Rows of the bitmap changed since the last frame was shown.  Pixels
+ * are only stored, and the row marked, if they differ from what is
+ * already there so a frame that redraws the same picture leaves the
+ * range empty.
+ */
+int dirty_first_y = 0, dirty_last_y = 800;
+
+static inline void mark_dirty(int y)
+{
+    if (y < dirty_first_y)
+        dirty_first_y = y;
+    if (y >= dirty_last_y)
+        dirty_last_y = y + 1;
+}
+
 static inline void put_pixel(ALLEGRO_LOCKED_REGION *region, int x, int y, uint32_t colour)
 {
-    *((uint32_t *)((char *)region->data + region->pitch * y + x * region->pixel_size)) = colour;
+    uint32_t *ptr = (uint32_t *)((char *)region->data + region->pitch * y + x * region->pixel_size);
+    if (*ptr != colour) {
+        *ptr = colour;
+        mark_dirty(y);
+    }
 }
 
 static inline void put_pixels(ALLEGRO_LOCKED_REGION *region, int x, int y, int count, uint32_t colour)
 {
     char *ptr = (char *)region->data + region->pitch * y + x * region->pixel_size;
     while (count--) {
-        *(uint32_t *)ptr = colour;
+        if (*(uint32_t *)ptr != colour) {
+            *(uint32_t *)ptr = colour;
+            mark_dirty(y);
+        }
         ptr += region->pixel_size;
     }
 }
 
+static inline void put_row(uint32_t *dst, int y, const uint32_t *src, int count)
+{
+    if (memcmp(dst, src, count * sizeof(uint32_t))) {
+        memcpy(dst, src, count * sizeof(uint32_t));
+        mark_dirty(y);
+    }
+}
+
 static inline void nula_putpixel(ALLEGRO_LOCKED_REGION *region, int x, int y, uint32_t colour)
 {
     if (crtc_mode && (nula_horizontal_offset || nula_left_blank) && (x < nula_left_cut || x >= nula_left_edge + (crtc[1] * crtc_mode * 8)))
@@ -154,6 +207,58 @@ static inline void nula_putpixel(ALLEGRO_LOCKED_REGION *region, int x, int y, ui
         put_pixel(region, x, y, colour);
 }
 
+static inline int pixlut_current_layout(void)
+{
+    if (nula_attribute_mode && ula_mode > 1)
+        return (crtc_mode << 4) | (nula_attribute_text << 3) | 4 | ula_mode;
+    return ula_mode;
+}
+
+static void pixlut_build_attribute(void)
+{
+    int width = crtc_mode * 8;
+    int shift = crtc_mode + 1;  // source pixel steps by 0.75 or 0.375.
+    int c, d;
+
+    for (c = 0; c < 256; c++) {
+        if (crtc_mode == 1 && ula_mode == 2) {
+            // 2bpp
+            int attribute = ((c & 16) >> 1) | ((c & 1) << 2);
+            for (d = 0; d < 8; d++) {
+                int a = 3 - ((d * 3) >> 3);
+                pixlut[c][d] = ula_pal[attribute | ((c >> (a + 3)) & 2) | ((c >> a) & 1)];
+            }
+        } else if (nula_attribute_text) {
+            // 1bpp, last pixels are a very loose approximation of the
+            // text attribute mode.
+            int attribute = (c & 7) << 1;
+            for (d = 0; d < width - crtc_mode; d++)
+                pixlut[c][d] = ula_pal[attribute | ((c >> (7 - ((d * 3) >> shift))) & 1)];
+            for (; d < width; d++)
+                pixlut[c][d] = ula_pal[attribute];
+        } else {
+            // 1bpp
+            int attribute = (c & 3) << 2;
+            for (d = 0; d < width; d++)
+                pixlut[c][d] = ula_pal[attribute | ((c >> (7 - ((d * 3) >> shift))) & 1)];
+        }
+    }
+}
+
+static void pixlut_build(void)
+{
+    const int *pal = nula_palette_mode ? nula_collook : ula_pal;
+    int c, d;
+
+    if (nula_attribute_mode && ula_mode > 1)
+        pixlut_build_attribute();
+    else
+        for (c = 0; c < 256; c++)
+            for (d = 0; d < 16; d++)
+                pixlut[c][d] = pal[table4bpp[ula_mode][c][d]];
+    pixlut_layout = pixlut_current_layout();
+}
+
 void nula_default_palette(void)
 {
     nula_collook[0]  = 0xff000000; // black
@@ -174,12 +279,15 @@ void nula_default_palette(void)
     nula_collook[15] = 0xffffffff; // white
 
     mode7_need_new_lookup = 1;
+    pixlut_layout = -1;
 }
 
 void videoula_write(uint16_t addr, uint8_t val)
 {
     int c;
     //log_debug("ULA write %04X %02X %i %i\n",addr,val,hc,vc);
+    video_sync();
+    pixlut_layout = -1;
     if (nula_disable)
         addr &= ~2;             // nuke additional NULA addresses
 
@@ -208,6 +316,7 @@ void videoula_write(uint16_t addr, uint8_t val)
                 crtc_mode = 1;  // High frequency
             else
                 crtc_mode = 2;  // Low frequency
+            video_update();
             //                printf("ULAmode %i\n",ulamode);
         }
         break;
@@ -327,6 +436,7 @@ void videoula_savestate(FILE * f)
     int c;
     uint32_t v;
 
+    video_sync();
     putc(ula_ctrl, f);
     for (c = 0; c < 16; c++)
         putc(ula_palbak[c], f);
@@ -373,6 +483,7 @@ void videoula_loadstate(FILE * f)
     nula_disable = getc(f);
     nula_attribute_mode = getc(f);
     nula_attribute_text = getc(f);
+    pixlut_layout = -1;
 }
 
 /*Mode 7 (SAA5050)*/
@@ -390,6 +501,37 @@ static uint8_t *mode7_p[2] = { mode7_chars, mode7_charsi };
 static uint8_t mode7_heldchar, mode7_holdchar;
 static uint8_t *mode7_heldp[2];
 
+/*
+ * The teletext state carried from one character to the next, saved
+ * and restored around rows drawn from the row cache.
+ */
+struct mode7_state {
+    uint8_t *p[2], *heldp[2];
+    int col, bg, sep, dbl, nextdbl, wasdbl, gfx, flash;
+    uint8_t buf[2], heldchar, holdchar;
+};
+
+#define MODE7_ROW_CHARS 40
+#define MODE7_ROW_LINES 768
+
+/*
+ * A scanline of a teletext row as last rendered.  Teletext rows rarely
+ * change from frame to frame so when the same character data is
+ * displayed with the same state the pixels are copied from here rather
+ * than expanded again.
+ */
+typedef struct {
+    int chars;                  // zero if the entry is empty.
+    int scrx, sc, field, linedbl, flashon, gen;
+    struct mode7_state before, after;
+    uint8_t data[MODE7_ROW_CHARS];
+    int firstx, lastx;
+    uint32_t pixels[2][MODE7_ROW_CHARS * 16];
+} mode7_row_t;
+
+static mode7_row_t mode7_rows[MODE7_ROW_LINES];
+static int mode7_gen;           // bumped when the glyphs or colours change.
+
 void mode7_makechars()
 {
     int c, d, y;
@@ -398,6 +540,8 @@ void mode7_makechars()
     int x2;
     int stat;
     uint8_t *p = teletext_characters, *p2 = mode7_tempi;
+
+    mode7_gen++;
     for (c = 0; c < (96 * 60); c++)
         teletext_characters[c] *= 15;
     for (c = 0; c < (96 * 60); c++)
@@ -502,6 +646,7 @@ static void mode7_gen_nula_lookup(void)
         }
     }
     mode7_need_new_lookup = 0;
+    mode7_gen++;
 }
 
 static inline void mode7_render(ALLEGRO_LOCKED_REGION *region, uint8_t dat)
@@ -675,6 +820,47 @@ static inline void mode7_render(ALLEGRO_LOCKED_REGION *region, uint8_t dat)
         mode7_heldchar = 32;
 }
 
+static void mode7_get_state(struct mode7_state *st)
+{
+    memset(st, 0, sizeof(*st));
+    st->p[0] = mode7_p[0];
+    st->p[1] = mode7_p[1];
+    st->heldp[0] = mode7_heldp[0];
+    st->heldp[1] = mode7_heldp[1];
+    st->col = mode7_col;
+    st->bg = mode7_bg;
+    st->sep = mode7_sep;
+    st->dbl = mode7_dbl;
+    st->nextdbl = mode7_nextdbl;
+    st->wasdbl = mode7_wasdbl;
+    st->gfx = mode7_gfx;
+    st->flash = mode7_flash;
+    st->buf[0] = mode7_buf[0];
+    st->buf[1] = mode7_buf[1];
+    st->heldchar = mode7_heldchar;
+    st->holdchar = mode7_holdchar;
+}
+
+static void mode7_set_state(const struct mode7_state *st)
+{
+    mode7_p[0] = st->p[0];
+    mode7_p[1] = st->p[1];
+    mode7_heldp[0] = st->heldp[0];
+    mode7_heldp[1] = st->heldp[1];
+    mode7_col = st->col;
+    mode7_bg = st->bg;
+    mode7_sep = st->sep;
+    mode7_dbl = st->dbl;
+    mode7_nextdbl = st->nextdbl;
+    mode7_wasdbl = st->wasdbl;
+    mode7_gfx = st->gfx;
+    mode7_flash = st->flash;
+    mode7_buf[0] = st->buf[0];
+    mode7_buf[1] = st->buf[1];
+    mode7_heldchar = st->heldchar;
+    mode7_holdchar = st->holdchar;
+}
+
 uint16_t vidbank;
 static const int screenlen[4] = { 0x4000, 0x5000, 0x2000, 0x2800 };
 
@@ -698,7 +884,7 @@ int firstx, firsty, lastx, lasty;
 int desktop_width, desktop_height;
 
 static ALLEGRO_DISPLAY *display;
-ALLEGRO_BITMAP *b, *b16, *b32;
+ALLEGRO_BITMAP *b, *b16, *b32, *bvid;
 
 ALLEGRO_LOCKED_REGION *region;
 
@@ -707,18 +893,24 @@ ALLEGRO_DISPLAY *video_init(void)
     int c;
     int temp, temp2, left;
 
+    video_set_window_size();
+    if (headless) {
+        // Render into memory bitmaps only - no display is created.
+        display = NULL;
+        al_set_new_bitmap_flags(ALLEGRO_MEMORY_BITMAP);
+    }
+    else {
 #ifdef ALLEGRO_GTK_TOPLEVEL
-    al_set_new_display_flags(ALLEGRO_WINDOWED | ALLEGRO_GTK_TOPLEVEL | ALLEGRO_RESIZABLE);
+        al_set_new_display_flags(ALLEGRO_WINDOWED | ALLEGRO_GTK_TOPLEVEL | ALLEGRO_RESIZABLE);
 #else
-    al_set_new_display_flags(ALLEGRO_WINDOWED | ALLEGRO_RESIZABLE);
+        al_set_new_display_flags(ALLEGRO_WINDOWED | ALLEGRO_RESIZABLE);
 #endif
-    video_set_window_size();
-    if ((display = al_create_display(winsizex, winsizey)) == NULL) {
-        log_fatal("video: unable to create display");
-        exit(1);
+        if ((display = al_create_display(winsizex, winsizey)) == NULL) {
+            log_fatal("video: unable to create display");
+            exit(1);
+        }
+        al_set_new_bitmap_flags(ALLEGRO_VIDEO_BITMAP);
     }
-
-    al_set_new_bitmap_flags(ALLEGRO_VIDEO_BITMAP);
     b16 = al_create_bitmap(832, 614);
     b32 = al_create_bitmap(1536, 800);
 
@@ -751,7 +943,15 @@ ALLEGRO_DISPLAY *video_init(void)
             table4bpp[0][temp][c] = table4bpp[3][temp][c >> 3];
         }
     }
+    // The emulation draws into a memory bitmap and only the rows that
+    // changed are copied to the video bitmap shown on the display.
+    if (!headless) {
+        bvid = al_create_bitmap(1280, 800);
+        al_set_new_bitmap_flags(ALLEGRO_MEMORY_BITMAP);
+    }
     b = al_create_bitmap(1280, 800);
+    if (!headless)
+        al_set_new_bitmap_flags(ALLEGRO_VIDEO_BITMAP);
     al_set_target_bitmap(b);
     al_clear_to_color(al_map_rgb(0, 0,0));
     region = al_lock_bitmap(b, ALLEGRO_PIXEL_FORMAT_ARGB_8888, ALLEGRO_LOCK_READWRITE);
@@ -789,6 +989,8 @@ void video_reset()
     nula_left_blank = 0;
     nula_horizontal_offset = 0;
 
+    video_synced = sched_now;
+    video_update();
 }
 
 #if 0
@@ -803,10 +1005,232 @@ static inline int is_free_run(void) {
     return 0;
 }
 
-void video_poll(int clocks, int timer_enable)
+/* Where in RAM the byte for character address vma is fetched from */
+
+static inline int video_fetch_addr(uint16_t vma)
 {
-    int c, oldvc;
     uint16_t addr;
+
+    if (vma & 0x2000)
+        return 0x7C00 | (vma & 0x3FF) | vidbank;
+    if ((crtc[8] & 3) == 3)
+        addr = (vma << 3) | ((sc & 3) << 1) | interlline;
+    else
+        addr = (vma << 3) | (sc & 7);
+    if (addr & 0x8000)
+        addr -= screenlen[scrsize];
+    return (addr & 0x7FFF) | vidbank;
+}
+
+/*
+ * Copy the pixels for a byte of a graphics mode from the lookup table,
+ * which the caller has brought up to date.  The NULA horizontal offset
+ * and left blanking clip pixel by pixel so are kept out of line, which
+ * lets the plain copy be inlined with a constant length.
+ */
+
+static void video_put_cell_nula(uint8_t dat, int count)
+{
+    int c;
+
+    for (c = 0; c < count; c++) {
+        nula_putpixel(region, scrx + c, scry, pixlut[dat][c]);
+        if (vid_linedbl)
+            nula_putpixel(region, scrx + c, scry + 1, pixlut[dat][c]);
+    }
+}
+
+static inline void video_put_cell(uint8_t dat, int count)
+{
+    uint32_t *dst;
+
+    if (nula_horizontal_offset || nula_left_blank) {
+        video_put_cell_nula(dat, count);
+        return;
+    }
+    dst = (uint32_t *)((char *)region->data + region->pitch * scry) + scrx;
+    put_row(dst, scry, pixlut[dat], count);
+    if (vid_linedbl)
+        put_row((uint32_t *)((char *)dst + region->pitch), scry + 1, pixlut[dat], count);
+}
+
+/* Render one character cell of display at the current beam position */
+
+static inline void video_render_char(uint8_t dat)
+{
+    if ((crtc[8] & 0x30) == 0x30 || ((sc & 8) && !(ula_ctrl & 2))) {
+        // Gaps between lines in modes 3 & 6.
+        put_pixels(region, scrx, scry, (ula_ctrl & 0x10) ? 8 : 16, colblack);
+        if (vid_linedbl)
+            put_pixels(region, scrx, scry+1, (ula_ctrl & 0x10) ? 8 : 16, colblack);
+    } else
+        switch (crtc_mode) {
+        case 0:
+            mode7_render(region, dat & 0x7F);
+            break;
+        case 1:
+            {
+                if (scrx < firstx)
+                    firstx = scrx;
+                if ((scrx + 8) > lastx)
+                    lastx = scrx + 8;
+                video_put_cell(dat, 8);
+            }
+            break;
+        case 2:
+            {
+                if (scrx < firstx)
+                    firstx = scrx;
+                if ((scrx + 16) > lastx)
+                    lastx = scrx + 16;
+                video_put_cell(dat, 16);
+            }
+            break;
+        }
+}
+
+/*
+ * The number of character cells from the current one that can be
+ * rendered as a run: displayed characters with none of the CRTC
+ * horizontal positions, the cursor or the end of the clocks to run
+ * in between.
+ */
+
+static inline int video_span_length(int clocks)
+{
+    int n, d;
+
+    n = 256 - hc;
+    if ((d = (crtc[0] - hc) & 255) < n)
+        n = d;
+    if ((d = (crtc[1] - hc) & 255) < n)
+        n = d;
+    if ((d = (crtc[2] - hc) & 255) < n)
+        n = d;
+    if (interline && (d = ((crtc[0] >> 1) - hc) & 255) < n)
+        n = d;
+    if (con && (d = ((crtc[15] | (crtc[14] << 8)) - ma) & 0x3FFF) < n)
+        n = d;
+    d = (ula_ctrl & 0x10) ? clocks + 1 : clocks / 2 + 1;
+    return d < n ? d : n;
+}
+
+/*
+ * Render a run of n teletext cells through the row cache.  Returns
+ * zero, having rendered nothing, if the run cannot be cached.
+ */
+
+static int mode7_render_row(int n)
+{
+    struct mode7_state before;
+    uint8_t data[MODE7_ROW_CHARS];
+    mode7_row_t *row;
+    uint32_t *dst;
+    int c, field, flashon, x = scrx + 16;
+    int savefirstx, savelastx;
+
+    if (n > MODE7_ROW_CHARS || (scrx + (n - 1) * 16) >= (1280-16) || (scry >> vid_linedbl) >= MODE7_ROW_LINES)
+        return 0;
+    if ((crtc[8] & 0x30) == 0x30 || (ula_ctrl & 0x12) != 0x02)
+        return 0;
+
+    if (mode7_need_new_lookup)
+        mode7_gen_nula_lookup();
+    for (c = 0; c < n; c++)
+        data[c] = ram[video_fetch_addr(ma + c)] & 0x7F;
+    mode7_get_state(&before);
+    field = vid_interlace & interlline;
+    // Only rows containing flashing text depend on the flash phase,
+    // including a span starting part way along a row already flashing.
+    if (before.flash || memchr(data, 8, n) || before.buf[0] == 8 || before.buf[1] == 8)
+        flashon = mode7_flashon;
+    else
+        flashon = -1;
+
+    row = &mode7_rows[scry >> vid_linedbl];
+    dst = (uint32_t *)((char *)region->data + region->pitch * scry) + x;
+    if (row->chars == n && row->scrx == scrx && row->sc == sc && row->field == field && row->linedbl == vid_linedbl
+        && row->flashon == flashon && row->gen == mode7_gen && !memcmp(row->data, data, n)
+        && !memcmp(&row->before, &before, sizeof(before))) {
+        put_row(dst, scry, row->pixels[0], n * 16);
+        if (vid_linedbl)
+            put_row((uint32_t *)((char *)dst + region->pitch), scry + 1, row->pixels[1], n * 16);
+        mode7_set_state(&row->after);
+    } else {
+        savefirstx = firstx;
+        savelastx = lastx;
+        firstx = INT_MAX;
+        lastx = INT_MIN;
+        for (c = 0; c < n; c++, scrx += 16)
+            mode7_render(region, data[c]);
+        scrx -= n * 16;
+        row->chars = n;
+        row->scrx = scrx;
+        row->sc = sc;
+        row->field = field;
+        row->linedbl = vid_linedbl;
+        row->flashon = flashon;
+        row->gen = mode7_gen;
+        memcpy(row->data, data, n);
+        row->before = before;
+        mode7_get_state(&row->after);
+        row->firstx = firstx;
+        row->lastx = lastx;
+        memcpy(row->pixels[0], dst, n * 16 * sizeof(uint32_t));
+        if (vid_linedbl)
+            memcpy(row->pixels[1], (char *)dst + region->pitch, n * 16 * sizeof(uint32_t));
+        firstx = savefirstx;
+        lastx = savelastx;
+    }
+    if (row->firstx < firstx)
+        firstx = row->firstx;
+    if (row->lastx > lastx)
+        lastx = row->lastx;
+    return 1;
+}
+
+/* Render a run of n cells, returning the extra clocks used */
+
+static int video_render_span(int n)
+{
+    int step, y = scry;
+    int extra = n - 1;
+
+    if (vid_interlace)
+        scry = (scry << 1) + interlline;
+    if (vid_linedbl)
+        scry <<= 1;
+    step = (ula_ctrl & 0x10) ? 8 : 16;
+    hc = (hc + n) & 255;
+    vidbytes += n;
+    if (!crtc_mode && mode7_render_row(n)) {
+        ma += n;
+        scrx += (n - 1) * step;
+    } else {
+        if (pixlut_layout != pixlut_current_layout())
+            pixlut_build();
+        for (;;) {
+            if (scrx < (1280-16))
+                video_render_char(ram[video_fetch_addr(ma)]);
+            ma++;
+            if (!--n)
+                break;
+            scrx += step;
+        }
+    }
+    scry = y;
+    lasthc = hc;
+    if (ula_ctrl & 0x10)
+        oddclock ^= extra & 1;
+    else
+        extra *= 2;
+    vidclocks += extra;
+    return extra;
+}
+
+static void video_run(int clocks, int timer_enable)
+{
+    int c, n, oldvc;
     uint8_t dat;
 
     while (clocks--) {
@@ -816,6 +1240,11 @@ void video_poll(int clocks, int timer_enable)
         if (!(ula_ctrl & 0x10) && !oddclock)
             continue;
 
+        if (dispen && !cdraw && !hvblcount && (n = video_span_length(clocks)) > 1) {
+            clocks -= video_render_span(n);
+            continue;
+        }
+
         if (hc == crtc[1]) { // reached horizontal displayed count.
             if (dispen && ula_ctrl & 2)
                 charsleft = 3;
@@ -831,7 +1260,7 @@ void video_poll(int clocks, int timer_enable)
             scry++;
             if (scry >= 384) {
                 scry = 0;
-                video_doblit(crtc_mode, crtc[4]);
+                PERF_TIME(video_doblit, video_doblit(crtc_mode, crtc[4]));
             }
         }
 
@@ -843,133 +1272,12 @@ void video_poll(int clocks, int timer_enable)
             if (!((ma ^ (crtc[15] | (crtc[14] << 8))) & 0x3FFF) && con)
                 cdraw = cdrawlook[crtc[8] >> 6];
 
-            if (ma & 0x2000)
-                dat = ram[0x7C00 | (ma & 0x3FF) | vidbank];
-            else {
-                if ((crtc[8] & 3) == 3)
-                    addr = (ma << 3) | ((sc & 3) << 1) | interlline;
-                else
-                    addr = (ma << 3) | (sc & 7);
-                if (addr & 0x8000)
-                    addr -= screenlen[scrsize];
-                dat = ram[(addr & 0x7FFF) | vidbank];
-            }
+            dat = ram[video_fetch_addr(ma)];
 
             if (scrx < (1280-16)) {
-                if ((crtc[8] & 0x30) == 0x30 || ((sc & 8) && !(ula_ctrl & 2))) {
-                    // Gaps between lines in modes 3 & 6.
-                    put_pixels(region, scrx, scry, (ula_ctrl & 0x10) ? 8 : 16, colblack);
-                    if (vid_linedbl)
-                        put_pixels(region, scrx, scry+1, (ula_ctrl & 0x10) ? 8 : 16, colblack);
-                } else
-                    switch (crtc_mode) {
-                    case 0:
-                        mode7_render(region, dat & 0x7F);
-                        break;
-                    case 1:
-                        {
-                            if (scrx < firstx)
-                                firstx = scrx;
-                            if ((scrx + 8) > lastx)
-                                lastx = scrx + 8;
-                            if (nula_attribute_mode && ula_mode > 1) {
-                                if (ula_mode == 3) {
-                                    // 1bpp
-                                    if (nula_attribute_text) {
-                                        int attribute = ((dat & 7) << 1);
-                                        float pc = 0.0f;
-                                        for (c = 0; c < 7; c++, pc += 0.75f) {
-                                            int output = ula_pal[attribute | (dat >> (7 - (int) pc) & 1)];
-                                            nula_putpixel(region, scrx + c, scry, output);
-                                            if (vid_linedbl)
-                                                nula_putpixel(region, scrx + c, scry + 1, output);
-                                        }
-                                        // Very loose approximation of the text attribute mode
-                                        nula_putpixel(region, scrx + 7, scry, ula_pal[attribute]);
-                                        if (vid_linedbl)
-                                            nula_putpixel(region, scrx + 7, scry + 1, ula_pal[attribute]);
-                                    } else {
-                                        int attribute = ((dat & 3) << 2);
-                                        float pc = 0.0f;
-                                        for (c = 0; c < 8; c++, pc += 0.75f) {
-                                            int output = ula_pal[attribute | (dat >> (7 - (int) pc) & 1)];
-                                            nula_putpixel(region, scrx + c, scry, output);
-                                            if (vid_linedbl)
-                                                nula_putpixel(region, scrx + c, scry + 1, output);
-                                        }
-                                    }
-                                } else {
-                                    int attribute = (((dat & 16) >> 1) | ((dat & 1) << 2));
-                                    float pc = 0.0f;
-                                    for (c = 0; c < 8; c++, pc += 0.75f) {
-                                        int a = 3 - ((int) pc) / 2;
-                                        int output = ula_pal[attribute | ((dat >> (a + 3)) & 2) | ((dat >> a) & 1)];
-                                        nula_putpixel(region, scrx + c, scry, output);
-                                        if (vid_linedbl)
-                                            nula_putpixel(region, scrx + c, scry + 1, output);
-                                    }
-                                }
-                            } else {
-                                for (c = 0; c < 8; c++) {
-                                    nula_putpixel(region, scrx + c, scry, nula_palette_mode ? nula_collook[table4bpp[ula_mode][dat][c]] : ula_pal[table4bpp[ula_mode][dat][c]]);
-                                }
-                                if (vid_linedbl) {
-                                    for (c = 0; c < 8; c++) {
-                                        nula_putpixel(region, scrx + c, scry + 1, nula_palette_mode ? nula_collook[table4bpp[ula_mode][dat][c]] : ula_pal[table4bpp[ula_mode][dat][c]]);
-                                    }
-                                }
-                            }
-                        }
-                        break;
-                    case 2:
-                        {
-                            if (scrx < firstx)
-                                firstx = scrx;
-                            if ((scrx + 16) > lastx)
-                                lastx = scrx + 16;
-                            if (nula_attribute_mode && ula_mode > 1) {
-                                // In low frequency clock can only have 1bpp modes
-                                if (nula_attribute_text) {
-                                    int attribute = ((dat & 7) << 1);
-                                    float pc = 0.0f;
-                                    for (c = 0; c < 14; c++, pc += 0.375f) {
-                                        int output = ula_pal[attribute | (dat >> (7 - (int) pc) & 1)];
-                                        nula_putpixel(region, scrx + c, scry, output);
-                                        if (vid_linedbl)
-                                            nula_putpixel(region, scrx + c, scry + 1, output);
-                                    }
-
-                                    // Very loose approximation of the text attribute mode
-                                    nula_putpixel(region, scrx + 14, scry, ula_pal[attribute]);
-                                    nula_putpixel(region, scrx + 15, scry, ula_pal[attribute]);
-
-                                    if (vid_linedbl) {
-                                        nula_putpixel(region, scrx + 14, scry + 1, ula_pal[attribute]);
-                                        nula_putpixel(region, scrx + 15, scry + 1, ula_pal[attribute]);
-                                    }
-                                } else {
-                                    int attribute = ((dat & 3) << 2);
-                                    float pc = 0.0f;
-                                    for (c = 0; c < 16; c++, pc += 0.375f) {
-                                        int output = ula_pal[attribute | (dat >> (7 - (int) pc) & 1)];
-                                        nula_putpixel(region, scrx + c, scry, output);
-                                        if (vid_linedbl)
-                                            nula_putpixel(region, scrx + c, scry + 1, output);
-                                    }
-                                }
-                            } else {
-                                for (c = 0; c < 16; c++) {
-                                    nula_putpixel(region, scrx + c, scry, nula_palette_mode ? nula_collook[table4bpp[ula_mode][dat][c]] : ula_pal[table4bpp[ula_mode][dat][c]]);
-                                }
-                                if (vid_linedbl) {
-                                    for (c = 0; c < 16; c++) {
-                                        nula_putpixel(region, scrx + c, scry + 1, nula_palette_mode ? nula_collook[table4bpp[ula_mode][dat][c]] : ula_pal[table4bpp[ula_mode][dat][c]]);
-                                    }
-                                }
-                            }
-                        }
-                        break;
-                    }
+                if (pixlut_layout != pixlut_current_layout())
+                    pixlut_build();
+                video_render_char(dat);
                 if (cdraw) {
                     if (cursoron && (ula_ctrl & cursorlook[cdraw])) {
                         for (c = ((ula_ctrl & 0x10) ? 8 : 16); c >= 0; c--) {
@@ -1118,19 +1426,23 @@ void video_poll(int clocks, int timer_enable)
                         al_set_target_bitmap(b);
                         al_clear_to_color(black);
                         region = al_lock_bitmap(b, ALLEGRO_PIXEL_FORMAT_ARGB_8888, ALLEGRO_LOCK_READWRITE);
+                        dirty_first_y = 0;
+                        dirty_last_y = 800;
                     }
                     frameodd ^= 1;
                     interlline = frameodd && (crtc[8] & 1);
                     oldr8 = crtc[8] & 1;
                     if (vidclocks > 1024 && !ccount) {
-                        video_doblit(crtc_mode, crtc[4]);
+                        PERF_TIME(video_doblit, video_doblit(crtc_mode, crtc[4]));
                         vid_cleared = 0;
                     } else if (vidclocks <= 1024 && !vid_cleared) {
                         vid_cleared = 1;
                         al_unlock_bitmap(b);
                         al_clear_to_color(al_map_rgb(0, 0, 0));
                         region = al_lock_bitmap(b, ALLEGRO_PIXEL_FORMAT_ARGB_8888, ALLEGRO_LOCK_READWRITE);
-                        video_doblit(crtc_mode, crtc[4]);
+                        dirty_first_y = 0;
+                        dirty_last_y = 800;
+                        PERF_TIME(video_doblit, video_doblit(crtc_mode, crtc[4]));
                     }
                     ccount++;
                     if (ccount == 10 || ((!motor || !fasttape) && !is_free_run()))
@@ -1188,8 +1500,136 @@ void video_poll(int clocks, int timer_enable)
     }
 }
 
+/*
+ * The CRTC and ULA are not run on every CPU cycle.  Instead they are
+ * brought up to date when something that affects the picture, or
+ * depends on it, happens: a write to the video registers, a write
+ * to screen memory still to be fetched on the current line or the
+ * end of a scanline, which is when the vertical sync interrupt can
+ * change.
+ */
+
+uint8_t video_watch[RAM_SIZE >> 8];
+static uint8_t watch_pages[RAM_SIZE >> 8];
+static int watch_count;
+
+static void video_line_end(void);
+static sched_event_t video_event = SCHED_EVENT("video", video_line_end);
+
+static void video_sync_to(uint64_t when)
+{
+    int clocks = when - video_synced;
+
+    if (clocks > 0) {
+        video_synced = when;
+        PERF_TIME(video_poll, video_run(clocks, 1));
+        video_update();
+    }
+}
+
+void video_sync(void)
+{
+    video_sync_to(sched_now);
+}
+
+/*
+ * Stop exactly at the end of the line, rather than wherever the CPU
+ * instruction that crossed it finished, so the next line is normally
+ * rendered in one go.
+ */
+
+static void video_line_end(void)
+{
+    video_sync_to(video_event.when);
+}
+
+static void video_update(void)
+{
+    int chars, steps, page;
+    uint16_t vma;
+
+    // Schedule the end of the line, or the next character if the
+    // vertical sync is about to end.
+    if (hvblcount)
+        chars = 0;
+    else {
+        chars = (crtc[0] - hc) & 255;
+        if (interline && (((crtc[0] >> 1) - hc) & 255) < chars)
+            chars = ((crtc[0] >> 1) - hc) & 255;
+    }
+    steps = chars + 1;
+    if (ula_ctrl & 0x10)
+        sched_at(&video_event, video_synced + steps);
+    else
+        sched_at(&video_event, video_synced + steps * 2 - !oddclock);
+
+    // Watch the pages still to be fetched on this line.
+    while (watch_count)
+        video_watch[watch_pages[--watch_count]] = 0;
+    if (dispen) {
+        vma = ma;
+        for (chars = (crtc[1] - hc) & 255; chars > 0; chars--) {
+            page = video_fetch_addr(vma++) >> 8;
+            if (!video_watch[page]) {
+                video_watch[page] = 1;
+                watch_pages[watch_count++] = page;
+            }
+        }
+    }
+}
+
+void video_poll(int clocks, int timer_enable)
+{
+    video_sync();
+    video_run(clocks, timer_enable);
+    video_update();
+}
+
+/*
+ * Time the NULA attribute mode renderer on its own.  Screen memory is
+ * filled from a fixed pseudo-random sequence and the CRTC and ULA are
+ * set up for MODE 0, 1 or 4 with attribute mode, and optionally text
+ * attributes, on.  The CRTC and ULA are then run for the given number
+ * of frames with the CPU stopped.  Returns the host time taken.
+ */
+
+double video_bench_nula(int frames, int mode, bool text)
+{
+    static const uint8_t crtc_20k[14] = {
+        0x7f, 0x50, 0x62, 0x28, 0x26, 0x00, 0x20, 0x22, 0x00, 0x07, 0x67, 0x08, 0x06, 0x00
+    };
+    static const uint8_t crtc_10k[14] = {
+        0x3f, 0x28, 0x31, 0x24, 0x26, 0x00, 0x20, 0x22, 0x00, 0x07, 0x67, 0x08, 0x0b, 0x00
+    };
+    const uint8_t *regs = (mode == 4) ? crtc_10k : crtc_20k;
+    uint32_t seed = 1;
+    double start;
+    int c;
+
+    for (c = 0x3000; c < 0x8000; c++) {
+        seed = seed * 1103515245 + 12345;
+        ram[c] = seed >> 24;
+    }
+    for (c = 0; c < 14; c++) {
+        crtc_write(0xFE00, c);
+        crtc_write(0xFE01, regs[c]);
+    }
+    videoula_write(0xFE22, 0x40);   // reset NULA
+    videoula_write(0xFE20, (mode == 4) ? 0x88 : (mode == 1) ? 0xD8 : 0x9C);
+    for (c = 0; c < 16; c++)
+        videoula_write(0xFE21, (c << 4) | (c ^ 7));
+    videoula_write(0xFE22, 0x61);
+    videoula_write(0xFE22, text ? 0x71 : 0x70);
+
+    start = al_get_time();
+    for (c = 0; c < frames; c++)
+        video_run(128 * 312, 0);
+    return al_get_time() - start;
+}
+
 void video_savestate(FILE * f)
 {
+    video_sync();
     putc(scrx, f);
     putc(scrx >> 8, f);
     putc(scry, f);
@@ -1212,4 +1652,6 @@ void video_loadstate(FILE * f)
     vidclocks = getc(f) << 8;
     vidclocks = getc(f) << 16;
     vidclocks = getc(f) << 24;
+    video_synced = sched_now;
+    video_update();
 }
@@ -37,12 +37,15 @@ extern uint8_t nula_attribute_text;
 ALLEGRO_DISPLAY *video_init(void);
 void video_reset(void);
 void video_poll(int clocks, int timer_enable);
+void video_sync(void);
+double video_bench_nula(int frames, int mode, bool text);
 void video_savestate(FILE *f);
 void video_loadstate(FILE *f);
 
 void nula_default_palette(void);
 
 extern uint16_t vidbank;
+extern uint8_t video_watch[];   // RAM pages still to be fetched this line.
 
 void mode7_makechars(void);
 extern int interlline;
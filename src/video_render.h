@@ -1,7 +1,7 @@
 #ifndef __INC_VIDEO_RENDER_H
 #define __INC_VIDEO_RENDER_H
 
-extern ALLEGRO_BITMAP *b, *b16, *b32;
+extern ALLEGRO_BITMAP *b, *b16, *b32, *bvid;
 extern ALLEGRO_LOCKED_REGION *region;
 
 #define BORDER_NONE_X_START_GRA 336
@@ -32,6 +32,7 @@ extern ALLEGRO_LOCKED_REGION *region;
 #define BORDER_FULL_Y_END_TXT   308
 
 extern int firstx, firsty, lastx, lasty;
+extern int dirty_first_y, dirty_last_y;
 extern int desktop_width, desktop_height;
 extern int scr_x_start, scr_x_size, scr_y_start, scr_y_size;
 extern int winsizex, winsizey;
@@ -46,6 +47,7 @@ extern int vid_savescrshot;
 extern char vid_scrshotname[260];
 
 void video_doblit(bool non_ttx, uint8_t vtotal);
+bool video_dump_screen(const char *name);
 void video_enterfullscreen(void);
 void video_leavefullscreen(void);
 void video_toggle_fullscreen(void);
@@ -48,7 +48,7 @@ void wd1770_reset()
     wd1770.status = 0;
     motorspin = 0;
     log_debug("wd1770: reset 1770");
-    fdc_time = 0;
+    fdc_settime(0);
     if (fdc_type >= FDC_ACORN) {
         fdc_callback       = wd1770_callback;
         fdc_data           = wd1770_data;
@@ -67,7 +67,7 @@ void wd1770_spinup()
 {
     wd1770.status |= 0x80;
     if (!motoron) {
-        motoron = 1;
+        disc_motor(1);
         motorspin = 0;
         ddnoise_spinup();
     }
@@ -77,7 +77,7 @@ void wd1770_spindown()
 {
     wd1770.status &= ~0x80;
     if (motoron) {
-        motoron = 0;
+        disc_motor(0);
         ddnoise_spindown();
     }
 }
@@ -90,7 +90,7 @@ void wd1770_setspindown()
 static void short_spindown(void)
 {
     motorspin = 15000;
-    fdc_time = 0;
+    fdc_settime(0);
 }
 
 #define track0 (wd1770.curtrack ? 0 : 4)
@@ -401,7 +401,7 @@ uint8_t wd1770_read(uint16_t addr)
 void wd1770_callback()
 {
     log_debug("wd1770: fdc callback %02X",wd1770.command);
-    fdc_time = 0;
+    fdc_settime(0);
     switch (wd1770.command >> 4)
     {
     case 0: /*Restore*/
@@ -436,7 +436,7 @@ void wd1770_callback()
         } else {
             log_debug("wd1770: multi-sector read, inter-sector gap");
             wd1770.in_gap = 1;
-            fdc_time = 5000;
+            fdc_settime(5000);
         }
         break;
     case 0xA: /*Write sector*/
@@ -453,7 +453,7 @@ void wd1770_callback()
         } else {
             log_debug("wd1770: multi-sector write, inter-sector gap");
             wd1770.in_gap = 1;
-            fdc_time = 5000;
+            fdc_settime(5000);
         }
         break;
 
@@ -489,7 +489,7 @@ void wd1770_data(uint8_t dat)
 void wd1770_finishread()
 {
     log_debug("wd1770: data i/o finished");
-    fdc_time = 200;
+    fdc_settime(200);
 }
 
 void wd1770_notfound()
@@ -534,7 +534,7 @@ int wd1770_getdata(int last)
 
 void wd1770_writeprotect()
 {
-    fdc_time = 0;
+    fdc_settime(0);
     nmi = nmi_on_completion[fdc_type - FDC_ACORN];
     wd1770.status = 0xC0;
     wd1770_setspindown();
@@ -17,6 +17,13 @@
 static int x86ins=0;
 static int dbg_x86 = 0;
 
+/*Instruction bytes are fetched straight from x86code, the host address of
+  the current code segment, whenever the whole segment lies in RAM and the
+  debugger is not watching.  x86codeseg is the linear segment base that
+  x86code was worked out for.*/
+static uint8_t *x86code;
+static uint32_t x86codeseg=0xFFFFFFFF;
+
 #define loadcs(seg) CS=seg; cs=seg<<4
 
 static void loadseg(uint16_t val, x86seg *seg)
@@ -37,7 +44,7 @@ static inline uint8_t readmemblx86(uint32_t addr)
 
 extern cpu_debug_t tubex86_cpu_debug;
 
-static inline uint8_t readmembl(uint32_t addr)
+static uint8_t readmemblslow(uint32_t addr)
 {
     uint8_t byte = readmemblx86(addr);
     if (dbg_x86)
@@ -53,7 +60,7 @@ static inline uint16_t readmemwlx86(uint32_t addr)
         return 0xFFFF;
 }
 
-static inline uint16_t readmemwl(uint32_t seg, uint32_t addr)
+static uint16_t readmemwlslow(uint32_t seg, uint32_t addr)
 {
     uint32_t ea = seg + addr;
     uint16_t word = readmemwlx86(ea);
@@ -67,7 +74,7 @@ static inline void writememblx86(uint32_t addr, uint8_t byte)
     x86ram[addr & 0xFFFFF] = byte;
 }
 
-static inline void writemembl(uint32_t addr, uint8_t byte)
+static void writememblslow(uint32_t addr, uint8_t byte)
 {
     if (dbg_x86)
         debug_memwrite(&tubex86_cpu_debug, addr, byte, 1);
@@ -79,7 +86,7 @@ static inline void writememwlx86(uint32_t addr, uint16_t word)
     *(uint16_t *)(&x86ram[addr & 0xFFFFF]) = word;
 }
 
-static inline void writememwl(uint32_t seg, uint32_t addr, uint16_t word)
+static void writememwlslow(uint32_t seg, uint32_t addr, uint16_t word)
 {
     uint32_t ea = seg + addr;
     if (dbg_x86)
@@ -87,6 +94,15 @@ static inline void writememwl(uint32_t seg, uint32_t addr, uint16_t word)
     writememwlx86(ea, word);
 }
 
+/*x86_exec() is far too big for the compiler to inline the functions above
+  into it, so plain RAM accesses are done in line here and only the ROM,
+  the unmapped hole and accesses the debugger is watching take a call.
+  Words are read and written with a single load or store.*/
+#define readmembl(a)       ((!dbg_x86 && (uint32_t)(a)<0xE0000) ? x86ram[(uint32_t)(a)] : readmemblslow(a))
+#define readmemwl(s,a)     ((!dbg_x86 && (uint32_t)((s)+(a))<0xE0000) ? *(uint16_t *)(&x86ram[(uint32_t)((s)+(a))]) : readmemwlslow(s,a))
+#define writemembl(a,v)    do { if (dbg_x86) writememblslow(a,v); else writememblx86(a,v); } while (0)
+#define writememwl(s,a,v)  do { if (dbg_x86) writememwlslow(s,a,v); else writememwlx86((s)+(a),v); } while (0)
+
 static uint32_t x86sa,x86ss,x86src;
 static uint32_t x86da,x86ds,x86dst;
 static uint16_t x86ena;
@@ -163,6 +179,7 @@ static const char *x86_dbg_reg_names[] = {
 static int x86_dbg_debug_enable(int newvalue) {
     int oldvalue = dbg_x86;
     dbg_x86 = newvalue;
+    x86codeseg = 0xFFFFFFFF;
     return oldvalue;
 };
 
@@ -249,7 +266,7 @@ static uint32_t x86_dbg_reg_get(int which) {
 static void  x86_dbg_reg_set(int which, uint32_t value) {
     switch (which) {
     case i_IP:
-        x86pc = value;
+        x86pc = value & 0xFFFF;
         break;
     case i_FLAGS:
         flags = value;
@@ -365,7 +382,30 @@ static uint32_t old8,old82,old83;
 static uint16_t oldcs;
 
 static int tempc;
-static uint16_t getword();
+
+static void setcodeseg()
+{
+        x86codeseg=cs;
+        /*Leave a segment's worth of slack as pc is only wrapped once an
+          instruction has finished.*/
+        if (!dbg_x86 && cs<(0xE0000-0x20000)) x86code=x86ram+cs;
+        else                                 x86code=NULL;
+}
+
+static uint8_t getbyteslow()
+{
+        pc++;
+        return readmembl(cs+pc-1);
+}
+
+static uint16_t getwordslow()
+{
+        pc+=2;
+        return readmemwl(cs,pc-2);
+}
+
+#define getbyte() (x86code ? x86code[pc++] : getbyteslow())
+#define getword() (x86code ? (pc+=2, *(uint16_t *)(&x86code[pc-2])) : getwordslow())
 static uint8_t opcode;
 static int noint=0;
 
@@ -486,7 +526,7 @@ static void fetcheal()
                         switch (mod)
                         {
                                 case 0: eaaddr=0; break;
-                                case 1: eaaddr=(uint16_t)(signed char)readmembl(cs+pc); pc++; break;
+                                case 1: eaaddr=(uint16_t)(signed char)getbyte(); break;
                                 case 2: eaaddr=getword(); break;
                         }
                         eaaddr+=(*mod1add[0][rm])+(*mod1add[1][rm]);
@@ -587,12 +627,6 @@ static void x86makeznptable()
       }
 }
 
-static uint16_t getword()
-{
-        pc+=2;
-        return readmemwl(cs,(pc-2));
-}
-
 static void x86dumpregs()
 {
         FILE *f;
@@ -901,7 +935,7 @@ static void rep(int fv)
         int changeds = 0;
         uint32_t oldds = 0;
         startrep:
-        temp=readmembl(cs+pc); pc++;
+        temp=getbyte();
 //        if (firstrepcycle && temp==0xA5) printf("REP MOVSW %06X:%04X %06X:%04X\n",ds,SI,es,DI);
 //        if (x86output) printf("REP %02X %04X\n",temp,ipc);
         switch (temp)
@@ -1124,10 +1158,17 @@ void x86_exec()
                 oldcs=CS;
                 oldpc=pc;
                 opcodestart:
-                ea = cs+pc;
-                if (dbg_x86)
-                    debug_preexec(&tubex86_cpu_debug, ea);
-                opcode=readmembl(ea);
+                if (cs!=x86codeseg)
+                   setcodeseg();
+                if (x86code)
+                   opcode=x86code[pc];
+                else
+                {
+                        ea = cs+pc;
+                        if (dbg_x86)
+                            debug_preexec(&tubex86_cpu_debug, ea);
+                        opcode=readmembl(ea);
+                }
                 tempc=flags&C_FLAG;
 #if 0
                 if (x86output && /*cs<0xF0000 && */!ssegs)//opcode!=0x26 && opcode!=0x36 && opcode!=0x2E && opcode!=0x3E)
@@ -1186,7 +1227,7 @@ void x86_exec()
                         tubecycles-=((mod==3)?3:10);
                         break;
                         case 0x04: /*ADD AL,#8*/
-                        temp=readmembl(cs+pc); pc++;
+                        temp=getbyte();
                         setadd8(AL,temp);
                         AL+=temp;
                         tubecycles-=4;
@@ -1249,7 +1290,7 @@ void x86_exec()
                         tubecycles-=((mod==3)?3:10);
                         break;
                         case 0x0C: /*OR AL,#8*/
-                        AL|=readmembl(cs+pc); pc++;
+                        AL|=getbyte();
                         setznp8(AL);
                         flags&=~(C_FLAG|V_FLAG|A_FLAG);
                         tubecycles-=4;
@@ -1269,7 +1310,7 @@ void x86_exec()
                         break;
 
                         case 0x0F:
-                        temp=readmembl(cs+pc); pc++;
+                        temp=getbyte();
                         switch (temp)
                         {
                                 case 0x84: /*JE*/
@@ -1345,7 +1386,7 @@ void x86_exec()
                         tubecycles-=((mod==3)?3:10);
                         break;
                         case 0x14: /*ADC AL,#8*/
-                        tempw=readmembl(cs+pc); pc++;
+                        tempw=getbyte();
                         setadc8(AL,tempw);
                         AL+=tempw+tempc;
                         tubecycles-=4;
@@ -1408,7 +1449,7 @@ void x86_exec()
                         tubecycles-=((mod==3)?3:10);
                         break;
                         case 0x1C: /*SBB AL,#8*/
-                        temp=readmembl(cs+pc); pc++;
+                        temp=getbyte();
                         setsbc8(AL,temp);
                         AL-=(temp+tempc);
                         tubecycles-=4;
@@ -1472,7 +1513,7 @@ void x86_exec()
                         tubecycles-=((mod==3)?3:10);
                         break;
                         case 0x24: /*AND AL,#8*/
-                        AL&=readmembl(cs+pc); pc++;
+                        AL&=getbyte();
                         setznp8(AL);
                         flags&=~(C_FLAG|V_FLAG|A_FLAG);
                         tubecycles-=4;
@@ -1541,7 +1582,7 @@ void x86_exec()
                         tubecycles-=((mod==3)?3:10);
                         break;
                         case 0x2C: /*SUB AL,#8*/
-                        temp=readmembl(cs+pc); pc++;
+                        temp=getbyte();
                         setsub8(AL,temp);
                         AL-=temp;
                         tubecycles-=4;
@@ -1612,7 +1653,7 @@ void x86_exec()
                         tubecycles-=((mod==3)?3:10);
                         break;
                         case 0x34: /*XOR AL,#8*/
-                        AL^=readmembl(cs+pc); pc++;
+                        AL^=getbyte();
                         setznp8(AL);
                         flags&=~(C_FLAG|V_FLAG|A_FLAG);
                         tubecycles-=4;
@@ -1671,7 +1712,7 @@ void x86_exec()
                         tubecycles-=((mod==3)?3:10);
                         break;
                         case 0x3C: /*CMP AL,#8*/
-                        temp=readmembl(cs+pc); pc++;
+                        temp=getbyte();
                         setsub8(AL,temp);
                         tubecycles-=4;
                         break;
@@ -1778,7 +1819,7 @@ void x86_exec()
                         tubecycles-=((mod==3)?40:34);
                         break;
                         case 0x6A: /*PUSH #eb*/
-                        tempw=readmembl(cs+pc); pc++;
+                        tempw=getbyte();
                         if (tempw&0x80) tempw|=0xFF00;
                         writememwl(ss,((SP-2)&0xFFFF),tempw);
                         SP-=2;
@@ -1788,7 +1829,7 @@ void x86_exec()
                         case 0x6B: /*IMUL r8*/
                         fetchea();
                         tempw=geteaw();
-                        tempw2=readmembl(cs+pc); pc++;
+                        tempw2=getbyte();
                         if (tempw2&0x80) tempw2|=0xFF00;
 //                        printf("%04X * %04X = ",tempw,tempw2);
                         templ=((int)(signed short)tempw)*((int)(signed short)tempw2);
@@ -1817,88 +1858,88 @@ void x86_exec()
 //                        #endif
 
                         case 0x70: /*JO*/
-                        offset=(signed char)readmembl(cs+pc); pc++;
+                        offset=(signed char)getbyte();
                         if (flags&V_FLAG) { pc+=offset; tubecycles-=9; }
                         tubecycles-=4;
                         break;
                         case 0x71: /*JNO*/
-                        offset=(signed char)readmembl(cs+pc); pc++;
+                        offset=(signed char)getbyte();
                         if (!(flags&V_FLAG)) { pc+=offset; tubecycles-=9; }
                         tubecycles-=4;
                         break;
                         case 0x72: /*JB*/
-                        offset=(signed char)readmembl(cs+pc); pc++;
+                        offset=(signed char)getbyte();
                         if (flags&C_FLAG) { pc+=offset; tubecycles-=9; }
                         tubecycles-=4;
                         break;
                         case 0x73: /*JNB*/
-                        offset=(signed char)readmembl(cs+pc); pc++;
+                        offset=(signed char)getbyte();
                         if (!(flags&C_FLAG)) { pc+=offset; tubecycles-=9; }
                         tubecycles-=4;
                         break;
                         case 0x74: /*JZ*/
-                        offset=(signed char)readmembl(cs+pc); pc++;
+                        offset=(signed char)getbyte();
                         if (flags&Z_FLAG) { pc+=offset; tubecycles-=9; }
                         tubecycles-=4;
                         break;
                         case 0x75: /*JNZ*/
-                        offset=(signed char)readmembl(cs+pc); pc++;
+                        offset=(signed char)getbyte();
                         if (!(flags&Z_FLAG)) { pc+=offset; tubecycles-=9; }
                         tubecycles-=4;
                         break;
                         case 0x76: /*JBE*/
-                        offset=(signed char)readmembl(cs+pc); pc++;
+                        offset=(signed char)getbyte();
                         if (flags&(C_FLAG|Z_FLAG)) { pc+=offset; tubecycles-=9; }
                         tubecycles-=4;
                         break;
                         case 0x77: /*JNBE*/
-                        offset=(signed char)readmembl(cs+pc); pc++;
+                        offset=(signed char)getbyte();
                         if (!(flags&(C_FLAG|Z_FLAG))) { pc+=offset; tubecycles-=9; }
                         tubecycles-=4;
                         break;
                         case 0x78: /*JS*/
-                        offset=(signed char)readmembl(cs+pc); pc++;
+                        offset=(signed char)getbyte();
                         if (flags&N_FLAG)  { pc+=offset; tubecycles-=9; }
                         tubecycles-=4;
                         break;
                         case 0x79: /*JNS*/
-                        offset=(signed char)readmembl(cs+pc); pc++;
+                        offset=(signed char)getbyte();
                         if (!(flags&N_FLAG))  { pc+=offset; tubecycles-=9; }
                         tubecycles-=4;
                         break;
                         case 0x7A: /*JP*/
-                        offset=(signed char)readmembl(cs+pc); pc++;
+                        offset=(signed char)getbyte();
                         if (flags&P_FLAG)  { pc+=offset; tubecycles-=9; }
                         tubecycles-=4;
                         break;
                         case 0x7B: /*JNP*/
-                        offset=(signed char)readmembl(cs+pc); pc++;
+                        offset=(signed char)getbyte();
                         if (!(flags&P_FLAG))  { pc+=offset; tubecycles-=9; }
                         tubecycles-=4;
                         break;
                         case 0x7C: /*JL*/
-                        offset=(signed char)readmembl(cs+pc); pc++;
+                        offset=(signed char)getbyte();
                         temp=(flags&N_FLAG)?1:0;
                         temp2=(flags&V_FLAG)?1:0;
                         if (temp!=temp2)  { pc+=offset; tubecycles-=9; }
                         tubecycles-=4;
                         break;
                         case 0x7D: /*JNL*/
-                        offset=(signed char)readmembl(cs+pc); pc++;
+                        offset=(signed char)getbyte();
                         temp=(flags&N_FLAG)?1:0;
                         temp2=(flags&V_FLAG)?1:0;
                         if (temp==temp2)  { pc+=offset; tubecycles-=9; }
                         tubecycles-=4;
                         break;
                         case 0x7E: /*JLE*/
-                        offset=(signed char)readmembl(cs+pc); pc++;
+                        offset=(signed char)getbyte();
                         temp=(flags&N_FLAG)?1:0;
                         temp2=(flags&V_FLAG)?1:0;
                         if ((flags&Z_FLAG) || (temp!=temp2))  { pc+=offset; tubecycles-=9; }
                         tubecycles-=4;
                         break;
                         case 0x7F: /*JNLE*/
-                        offset=(signed char)readmembl(cs+pc); pc++;
+                        offset=(signed char)getbyte();
                         temp=(flags&N_FLAG)?1:0;
                         temp2=(flags&V_FLAG)?1:0;
                         if (!((flags&Z_FLAG) || (temp!=temp2)))  { pc+=offset; tubecycles-=9; }
@@ -1908,7 +1949,7 @@ void x86_exec()
                         case 0x80: case 0x82:
                         fetchea();
                         temp=geteab();
-                        temp2=readmembl(cs+pc); pc++;
+                        temp2=getbyte();
                         switch (rmdat&0x38)
                         {
                                 case 0x00: /*ADD b,#8*/
@@ -2033,7 +2074,7 @@ void x86_exec()
                         case 0x83:
                         fetchea();
                         tempw=geteaw();
-                        tempw2=readmembl(cs+pc); pc++;
+                        tempw2=getbyte();
                         if (tempw2&0x80) tempw2|=0xFF00;
                         switch (rmdat&0x38)
                         {
@@ -2340,7 +2381,7 @@ void x86_exec()
                         tubecycles-=22;
                         break;
                         case 0xA8: /*TEST AL,#8*/
-                        temp=readmembl(cs+pc); pc++;
+                        temp=getbyte();
                         setznp8(AL&temp);
                         flags&=~(C_FLAG|V_FLAG|A_FLAG);
                         tubecycles-=4;
@@ -2393,35 +2434,35 @@ void x86_exec()
                         break;
 
                         case 0xB0: /*MOV AL,#8*/
-                        AL=readmembl(cs+pc),pc++;
+                        AL=getbyte();
                         tubecycles-=4;
                         break;
                         case 0xB1: /*MOV CL,#8*/
-                        CL=readmembl(cs+pc),pc++;
+                        CL=getbyte();
                         tubecycles-=4;
                         break;
                         case 0xB2: /*MOV DL,#8*/
-                        DL=readmembl(cs+pc),pc++;
+                        DL=getbyte();
                         tubecycles-=4;
                         break;
                         case 0xB3: /*MOV BL,#8*/
-                        BL=readmembl(cs+pc),pc++;
+                        BL=getbyte();
                         tubecycles-=4;
                         break;
                         case 0xB4: /*MOV AH,#8*/
-                        AH=readmembl(cs+pc),pc++;
+                        AH=getbyte();
                         tubecycles-=4;
                         break;
                         case 0xB5: /*MOV CH,#8*/
-                        CH=readmembl(cs+pc),pc++;
+                        CH=getbyte();
                         tubecycles-=4;
                         break;
                         case 0xB6: /*MOV DH,#8*/
-                        DH=readmembl(cs+pc),pc++;
+                        DH=getbyte();
                         tubecycles-=4;
                         break;
                         case 0xB7: /*MOV BH,#8*/
-                        BH=readmembl(cs+pc),pc++;
+                        BH=getbyte();
                         tubecycles-=4;
                         break;
                         case 0xB8: case 0xB9: case 0xBA: case 0xBB: /*MOV reg,#16*/
@@ -2432,7 +2473,7 @@ void x86_exec()
 
                         case 0xC0:
                         fetchea();
-                        c=readmembl(cs+pc); pc++;
+                        c=getbyte();
                         temp=geteab();
                         c&=31;
                         if (!c) break;
@@ -2545,7 +2586,7 @@ void x86_exec()
 
                         case 0xC1:
                         fetchea();
-                        c=readmembl(cs+pc); pc++;
+                        c=getbyte();
                         c&=31;
                         tempw=geteaw();
                         if (!c) break;
@@ -2690,7 +2731,7 @@ void x86_exec()
                         break;
                         case 0xC6: /*MOV b,#8*/
                         fetchea();
-                        temp=readmembl(cs+pc); pc++;
+                        temp=getbyte();
                         seteab(temp);
                         tubecycles-=((mod==3)?4:13);
                         break;
@@ -2702,7 +2743,7 @@ void x86_exec()
                         break;
                         case 0xC8: /*ENTER*/
                         tempw3=getword();
-                        tempi=readmembl(cs+pc); pc++;
+                        tempi=getbyte();
                         writememwl(ss,((SP-2)&0xFFFF),BP); SP-=2;
                         tempw2=SP;
                         if (tempi>0)
@@ -2758,7 +2799,7 @@ void x86_exec()
                         case 0xCD: /*INT*/
                         lastpc=pc;
                         lastcs=CS;
-                        temp=readmembl(cs+pc); pc++;
+                        temp=getbyte();
                         if (temp==0xE0 && CL==0x32) log_debug("XIOS call %02X %04X:%04X\n",readmembl(ds+DX),CS,pc);
 /*                        if (temp==0x45)
                         {
@@ -3275,14 +3316,14 @@ void x86_exec()
                         break;
 
                         case 0xD4: /*AAM*/
-                        tempws=readmembl(cs+pc); pc++;
+                        tempws=getbyte();
                         AH=AL/tempws;
                         AL%=tempws;
                         setznp168(AX);
                         tubecycles-=19;
                         break;
                         case 0xD5: /*AAD*/
-                        tempws=readmembl(cs+pc); pc++;
+                        tempws=getbyte();
                         AL=(AH*tempws)+AL;
                         AH=0;
                         setznp168(AX);
@@ -3301,47 +3342,47 @@ void x86_exec()
                         break;
 
                         case 0xE0: /*LOOPNE*/
-                        offset=(signed char)readmembl(cs+pc); pc++;
+                        offset=(signed char)getbyte();
                         CX--;
                         if (CX && !(flags&Z_FLAG)) { pc+=offset; tubecycles-=11; }
                         tubecycles-=5;
                         break;
                         case 0xE1: /*LOOPE*/
-                        offset=(signed char)readmembl(cs+pc); pc++;
+                        offset=(signed char)getbyte();
                         CX--;
                         if (CX && (flags&Z_FLAG)) { pc+=offset; tubecycles-=11; }
                         tubecycles-=5;
                         break;
                         case 0xE2: /*LOOP*/
-                        offset=(signed char)readmembl(cs+pc); pc++;
+                        offset=(signed char)getbyte();
                         CX--;
                         if (CX) { pc+=offset; tubecycles-=10; }
                         tubecycles-=5;
                         break;
                         case 0xE3: /*JCXZ*/
-                        offset=(signed char)readmembl(cs+pc); pc++;
+                        offset=(signed char)getbyte();
                         if (!CX) { pc+=offset; tubecycles-=11; }
                         tubecycles-=5;
                         break;
 
                         case 0xE4: /*IN AL*/
-                        temp=readmembl(cs+pc); pc++;
+                        temp=getbyte();
                         AL=inb(temp);
                         tubecycles-=10;
                         break;
                         case 0xE5: /*IN AX*/
-                        temp=readmembl(cs+pc); pc++;
+                        temp=getbyte();
                         AL=inb(temp);
                         AH=inb(temp+1);
                         tubecycles-=10;
                         break;
                         case 0xE6: /*OUT AL*/
-                        temp=readmembl(cs+pc); pc++;
+                        temp=getbyte();
                         outb(temp,AL);
                         tubecycles-=9;
                         break;
                         case 0xE7: /*OUT AX*/
-                        temp=readmembl(cs+pc); pc++;
+                        temp=getbyte();
                         outb(temp,AL);
                         outb(temp+1,AH);
                         tubecycles-=9;
@@ -3357,7 +3398,8 @@ void x86_exec()
                         break;
                         case 0xE9: /*JMP rel 16*/
 //                        printf("PC was %04X\n",pc);
-                        pc+=getword();
+                        tempw=getword();
+                        pc+=tempw;
 //                        printf("PC now %04X\n",pc);
                         tubecycles-=13;
                         break;
@@ -3371,7 +3413,7 @@ void x86_exec()
                         tubecycles-=13;
                         break;
                         case 0xEB: /*JMP rel*/
-                        offset=(signed char)readmembl(cs+pc); pc++;
+                        offset=(signed char)getbyte();
                         pc+=offset;
                         tubecycles-=13;
                         break;
@@ -3424,7 +3466,7 @@ void x86_exec()
                         switch (rmdat&0x38)
                         {
                                 case 0x00: /*TEST b,#8*/
-                                temp2=readmembl(cs+pc); pc++;
+                                temp2=getbyte();
                                 temp&=temp2;
                                 setznp8(temp);
                                 flags&=~(C_FLAG|V_FLAG|A_FLAG);
@@ -10,7 +10,7 @@ uint32_t oldpc;
 #define setr8(r,v) if (r&4) regs[r&3].b.h=v; \
                    else     regs[r&3].b.l=v;
 
-#define fetchea()   { rmdat=readmembl(cs+pc); pc++;  \
+#define fetchea()   { rmdat=getbyte();              \
                     reg=(rmdat>>3)&7;             \
                     mod=rmdat>>6;                 \
                     rm=rmdat&7;                   \
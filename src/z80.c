@@ -51,6 +51,9 @@ static int tempc;
 static int output=0;
 static int ins=0;
 static uint8_t znptable[256],znptablenv[256],znptable16[65536];
+/*Flags for the 8-bit ALU operations, indexed by carry in and both operands*/
+static uint8_t addflags[2][256][256],subflags[2][256][256];
+static uint8_t incflags[256],decflags[256];
 static uint8_t intreg;
 
 static int tuberomin;
@@ -155,51 +158,22 @@ static inline void setznc(uint8_t v)
 
 static inline void z80_setadd(uint8_t a, uint8_t b)
 {
-       uint8_t r=a+b;
-                af.b.l = (r) ? ((r & 0x80) ? N_FLAG : 0) : Z_FLAG;
-                af.b.l |= (r & 0x28);   /* undocumented flag bits 5+3 */
-                if( (r & 0x0f) < (a & 0x0f) ) af.b.l |= H_FLAG;
-                if( r < a ) af.b.l |= C_FLAG;
-                if( (b^a^0x80) & (b^r) & 0x80 ) af.b.l |= V_FLAG;
+        af.b.l=addflags[0][a][b];
 }
 
 static inline void setinc(uint8_t v)
 {
-        af.b.l&=~(N_FLAG|Z_FLAG|V_FLAG|0x28|H_FLAG);
-        af.b.l|=znptable[(v+1)&0xFF];
-        if (v==0x7F)          af.b.l|=V_FLAG;
-        else                  af.b.l&=~V_FLAG;
-        if (((v&0xF)+1)&0x10) af.b.l|=H_FLAG;
+        af.b.l=(af.b.l&(S_FLAG|C_FLAG))|incflags[v];
 }
 
 static inline void setdec(uint8_t v)
 {
-        af.b.l&=~(N_FLAG|Z_FLAG|V_FLAG|0x28|H_FLAG);
-        af.b.l|=znptable[(v-1)&0xFF]|S_FLAG;
-        if (v==0x80)             af.b.l|=V_FLAG;
-        else                     af.b.l&=~V_FLAG;
-        if (!(v&8) && ((v-1)&8)) af.b.l|=H_FLAG;
+        af.b.l=(af.b.l&C_FLAG)|decflags[v];
 }
 
 static inline void setadc(uint8_t a, uint8_t b)
 {
-       uint8_t r=a+b+(af.b.l&C_FLAG);
-       if (af.b.l&C_FLAG)
-       {
-                af.b.l = (r) ? ((r & 0x80) ? N_FLAG : 0) : Z_FLAG;
-                af.b.l |= (r & 0x28);   /* undocumented flag bits 5+3 */
-                if( (r & 0x0f) <= (a & 0x0f) ) af.b.l |= H_FLAG;
-                if( r <= a ) af.b.l |= C_FLAG;
-                if( (b^a^0x80) & (b^r) & 0x80 ) af.b.l |= V_FLAG;
-       }
-       else
-       {
-                af.b.l = (r) ? ((r & 0x80) ? N_FLAG : 0) : Z_FLAG;
-                af.b.l |= (r & 0x28);   /* undocumented flag bits 5+3 */
-                if( (r & 0x0f) < (a & 0x0f) ) af.b.l |= H_FLAG;
-                if( r < a ) af.b.l |= C_FLAG;
-                if( (b^a^0x80) & (b^r) & 0x80 ) af.b.l |= V_FLAG;
-       }
+        af.b.l=addflags[af.b.l&C_FLAG][a][b];
 }
 
 static inline void setadc16(uint16_t a, uint16_t b)
@@ -222,23 +196,7 @@ static inline void z80_setadd16(uint16_t a, uint16_t b)
 
 static inline void setsbc(uint8_t a, uint8_t b)
 {
-       uint8_t r=a-(b+(af.b.l&C_FLAG));
-       if (af.b.l&C_FLAG)
-       {
-                af.b.l = S_FLAG | ((r) ? ((r & 0x80) ? N_FLAG : 0) : Z_FLAG);
-                af.b.l |= (r & 0x28);   /* undocumented flag bits 5+3 */
-                if( (r & 0x0f) >= (a & 0x0f) ) af.b.l |= H_FLAG;
-                if( r >= a ) af.b.l |= C_FLAG;
-                if( (b^a) & (a^r) & 0x80 ) af.b.l |= V_FLAG;
-       }
-       else
-       {
-                af.b.l = S_FLAG | ((r) ? ((r & 0x80) ? N_FLAG : 0) : Z_FLAG);
-                af.b.l |= (r & 0x28);   /* undocumented flag bits 5+3 */
-                if( (r & 0x0f) > (a & 0x0f) ) af.b.l |= H_FLAG;
-                if( r > a ) af.b.l |= C_FLAG;
-                if( (b^a) & (a^r) & 0x80 ) af.b.l |= V_FLAG;
-       }
+        af.b.l=subflags[af.b.l&C_FLAG][a][b];
 }
 
 static inline void setsbc16(uint16_t a, uint16_t b)
@@ -251,34 +209,115 @@ static inline void setsbc16(uint16_t a, uint16_t b)
         (((b ^ a) & (a ^ r) &0x8000) >> 13);
 }
 
+/*CP takes the undocumented flag bits 5+3 from the operand rather than the result*/
 static inline void setcpED(uint8_t a, uint8_t b)
 {
-       uint8_t r=a-b;
-       af.b.l&=C_FLAG;
-                af.b.l |= S_FLAG | ((r) ? ((r & 0x80) ? N_FLAG : 0) : Z_FLAG);
-                af.b.l |= (b & 0x28);   /* undocumented flag bits 5+3 */
-                if( (r & 0x0f) > (a & 0x0f) ) af.b.l |= H_FLAG;
-                if( (b^a) & (a^r) & 0x80 ) af.b.l |= V_FLAG;
+        af.b.l=(af.b.l&C_FLAG)|(subflags[0][a][b]&~(0x28|C_FLAG))|(b&0x28);
 }
 
 static inline void setcp(uint8_t a, uint8_t b)
 {
-       uint8_t r=a-b;
-                af.b.l = S_FLAG | ((r) ? ((r & 0x80) ? N_FLAG : 0) : Z_FLAG);
-                af.b.l |= (b & 0x28);   /* undocumented flag bits 5+3 */
-                if( (r & 0x0f) > (a & 0x0f) ) af.b.l |= H_FLAG;
-                if( r > a ) af.b.l |= C_FLAG;
-                if( (b^a) & (a^r) & 0x80 ) af.b.l |= V_FLAG;
+        af.b.l=(subflags[0][a][b]&~0x28)|(b&0x28);
 }
 
 static inline void z80_setsub(uint8_t a, uint8_t b)
 {
-       uint8_t r=a-b;
-                af.b.l = S_FLAG | ((r) ? ((r & 0x80) ? N_FLAG : 0) : Z_FLAG);
-                af.b.l |= (r & 0x28);   /* undocumented flag bits 5+3 */
-                if( (r & 0x0f) > (a & 0x0f) ) af.b.l |= H_FLAG;
-                if( r > a ) af.b.l |= C_FLAG;
-                if( (b^a) & (a^r) & 0x80 ) af.b.l |= V_FLAG;
+        af.b.l=subflags[0][a][b];
+}
+
+/*Rotate or shift v as selected by bits 5-3 of a CB prefixed opcode*/
+static inline uint8_t z80_rotshift(uint8_t opcode, uint8_t v)
+{
+        uint8_t c;
+        switch ((opcode>>3)&7)
+        {
+                case 0: c=v&0x80; v=(v<<1)|(c>>7);  break; /*RLC*/
+                case 1: c=v&1; v=(v>>1)|(c<<7);     break; /*RRC*/
+                case 2: c=v&0x80; v=(v<<1)|tempc;   break; /*RL*/
+                case 3: c=v&1; v=(v>>1)|(tempc<<7); break; /*RR*/
+                case 4: c=v&0x80; v<<=1;            break; /*SLA*/
+                case 5: c=v&1; v=(v>>1)|(v&0x80);   break; /*SRA*/
+                case 6: c=v&0x80; v=(v<<1)|1;       break; /*SLL*/
+                default: c=v&1; v>>=1;              break; /*SRL*/
+        }
+        setzn(v);
+        if (c) af.b.l|=C_FLAG;
+        return v;
+}
+
+/*DDCB and FDCB prefixed opcodes, decoded from the opcode bits rather than
+  listed one by one.  Apart from BIT, the result is also copied to the
+  register in bits 2-0 as on a real Z80*/
+static void z80_index_cb(uint16_t addr, uint8_t opcode)
+{
+        uint8_t temp, bit=1<<((opcode>>3)&7);
+        cycles+=5; temp=z80_readmem(addr);
+        if ((opcode&0xC0)==0x40) /*BIT n,(XY+nn)*/
+        {
+                setbit2(temp&bit,addr);
+                cycles+=4;
+                return;
+        }
+        switch (opcode&0xC0)
+        {
+                case 0x00: temp=z80_rotshift(opcode,temp); break;
+                case 0x80: temp&=~bit; break; /*RES n,(XY+nn)*/
+                default:   temp|=bit;  break; /*SET n,(XY+nn)*/
+        }
+        cycles+=4; z80_writemem(addr,temp);
+        cycles+=3;
+        switch (opcode&7)
+        {
+                case 0: bc.b.h=temp; break;
+                case 1: bc.b.l=temp; break;
+                case 2: de.b.h=temp; break;
+                case 3: de.b.l=temp; break;
+                case 4: hl.b.h=temp; break;
+                case 5: hl.b.l=temp; break;
+                case 7: af.b.h=temp; break;
+        }
+}
+
+static void makeflagtables()
+{
+        int a,b,c;
+        uint8_t r,f;
+        for (c=0;c<2;c++)
+        {
+                for (a=0;a<256;a++)
+                {
+                        for (b=0;b<256;b++)
+                        {
+                                r=a+b+c;
+                                f = (r) ? ((r & 0x80) ? N_FLAG : 0) : Z_FLAG;
+                                f |= (r & 0x28);   /* undocumented flag bits 5+3 */
+                                if (c ? ((r & 0x0f) <= (a & 0x0f)) : ((r & 0x0f) < (a & 0x0f))) f |= H_FLAG;
+                                if (c ? (r <= a) : (r < a)) f |= C_FLAG;
+                                if( (b^a^0x80) & (b^r) & 0x80 ) f |= V_FLAG;
+                                addflags[c][a][b]=f;
+
+                                r=a-(b+c);
+                                f = S_FLAG | ((r) ? ((r & 0x80) ? N_FLAG : 0) : Z_FLAG);
+                                f |= (r & 0x28);   /* undocumented flag bits 5+3 */
+                                if (c ? ((r & 0x0f) >= (a & 0x0f)) : ((r & 0x0f) > (a & 0x0f))) f |= H_FLAG;
+                                if (c ? (r >= a) : (r > a)) f |= C_FLAG;
+                                if( (b^a) & (a^r) & 0x80 ) f |= V_FLAG;
+                                subflags[c][a][b]=f;
+                        }
+                }
+        }
+        for (a=0;a<256;a++)
+        {
+                f=znptable[(a+1)&0xFF]&~V_FLAG;
+                if (a==0x7F)            f|=V_FLAG;
+                if (((a&0xF)+1)&0x10)   f|=H_FLAG;
+                incflags[a]=f;
+
+                f=(znptable[(a-1)&0xFF]|S_FLAG)&~V_FLAG;
+                if (a==0x80)               f|=V_FLAG;
+                if (!(a&8) && ((a-1)&8))   f|=H_FLAG;
+                decflags[a]=f;
+        }
 }
 
 static void makeznptable()
@@ -424,6 +463,7 @@ bool z80_init(FILE *romf)
         if (fread(z80rom, 0x1000, 1, romf) != 1)
             return false;
         makeznptable();
+        makeflagtables();
         return true;
 }
 
@@ -526,6 +566,7 @@ void z80_exec()
 {
         uint8_t opcode,temp;
         uint16_t addr;
+        z80reg *xy;
         int enterint=0;
 //        tubecycles+=(cy<<1);
         while (tubecycles>0)
@@ -1609,429 +1650,6 @@ void z80_exec()
                            cycles+=3;
                         break;
 
-                        case 0xDD: /*More opcodes*/
-                        ir.b.l=((ir.b.l+1)&0x7F)|(ir.b.l&0x80);
-                        cycles+=4;
-                        opcode=z80_readmem(pc++);
-                        switch (opcode)
-                        {
-                                case 0xCD:
-                                pc--;
-//                                cycles+=4;
-                                break;
-                                case 0x09: /*ADD IX,BC*/
-                                z80_setadd16(ix.w,bc.w);
-                                ix.w+=bc.w;
-                                cycles+=11;
-                                break;
-                                case 0x19: /*ADD IX,DE*/
-                                z80_setadd16(ix.w,de.w);
-                                ix.w+=de.w;
-                                cycles+=11;
-                                break;
-                                case 0x21: /*LD IX,nn*/
-                                cycles+=4; ix.b.l=z80_readmem(pc++);
-                                cycles+=3; ix.b.h=z80_readmem(pc++);
-                                cycles+=3;
-                                break;
-                                case 0x22: /*LD (nn),IX*/
-                                cycles+=4; addr=z80_readmem(pc);
-                                cycles+=3; addr|=(z80_readmem(pc+1)<<8); pc+=2;
-                                cycles+=3; z80_writemem(addr,ix.b.l);
-                                cycles+=3; z80_writemem(addr+1,ix.b.h);
-                                cycles+=3;
-                                break;
-                                case 0x23: /*INC IX*/
-                                ix.w++;
-                                cycles+=6;
-                                break;
-                                case 0x24: /*INC IXh*/
-                                setinc(ix.b.h);
-                                ix.b.h++;
-                                cycles+=4;
-                                break;
-                                case 0x25: /*DEC IXh*/
-                                setdec(ix.b.h);
-                                ix.b.h--;
-                                cycles+=4;
-                                break;
-                                case 0x26: /*LD IXh,nn*/
-                                cycles+=4; ix.b.h=z80_readmem(pc++);
-                                cycles+=3;
-                                break;
-                                case 0x29: /*ADD IX,IX*/
-                                z80_setadd16(ix.w,ix.w);
-                                ix.w+=ix.w;
-                                cycles+=11;
-                                break;
-                                case 0x2A: /*LD IX,(nn)*/
-                                cycles+=4; addr=z80_readmem(pc);
-                                cycles+=3; addr|=(z80_readmem(pc+1)<<8); pc+=2;
-                                cycles+=3; ix.b.l=z80_readmem(addr);
-                                cycles+=3; ix.b.h=z80_readmem(addr+1);
-                                cycles+=3;
-                                break;
-                                case 0x2B: /*DEC IX*/
-                                ix.w--;
-                                cycles+=6;
-                                break;
-                                case 0x2C: /*INC IXl*/
-                                setinc(ix.b.l);
-                                ix.b.l++;
-                                cycles+=4;
-                                break;
-                                case 0x2D: /*DEC IXl*/
-                                setdec(ix.b.l);
-                                ix.b.l--;
-                                cycles+=4;
-                                break;
-                                case 0x2E: /*LD IXl,nn*/
-                                cycles+=4; ix.b.l=z80_readmem(pc++);
-                                cycles+=3;
-                                break;
-                                case 0x34: /*INC (IX+nn)*/
-                                cycles+=4; addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
-                                addr+=ix.w;
-                                cycles+=3; temp=z80_readmem(addr);
-                                setinc(temp);
-                                cycles+=5; z80_writemem(addr,temp+1);
-                                cycles+=7;
-                                break;
-                                case 0x35: /*DEC (IX+nn)*/
-                                cycles+=4; addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
-                                addr+=ix.w;
-                                cycles+=3; temp=z80_readmem(addr);
-                                setdec(temp);
-                                cycles+=5; z80_writemem(addr,temp-1);
-                                cycles+=7;
-                                break;
-                                case 0x36: /*LD (IX+nn),nn*/
-                                cycles+=4; addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
-                                cycles+=3; temp=z80_readmem(pc++);
-                                cycles+=5; z80_writemem(ix.w+addr,temp);
-                                cycles+=3;
-                                break;
-                                case 0x39: /*ADD IX,SP*/
-                                z80_setadd16(ix.w,sp);
-                                ix.w+=sp;
-                                cycles+=11;
-                                break;
-
-                                case 0x46: /*LD B,(IX+nn)*/
-                                addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
-                                intreg=(ix.w+addr)>>8;
-                                cycles+=7; bc.b.h=z80_readmem(ix.w+addr);
-                                cycles+=8;
-                                break;
-                                case 0x4E: /*LD C,(IX+nn)*/
-                                addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
-                                intreg=(ix.w+addr)>>8;
-                                cycles+=7; bc.b.l=z80_readmem(ix.w+addr);
-                                cycles+=8;
-                                break;
-                                case 0x56: /*LD D,(IX+nn)*/
-                                addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
-                                intreg=(ix.w+addr)>>8;
-                                cycles+=7; de.b.h=z80_readmem(ix.w+addr);
-                                cycles+=8;
-                                break;
-                                case 0x44: bc.b.h=ix.b.h; cycles+=3; break; /*LD B,IXh*/
-                                case 0x45: bc.b.h=ix.b.l; cycles+=3; break; /*LD B,IXl*/
-                                case 0x54: de.b.h=ix.b.h; cycles+=3; break; /*LD D,IXh*/
-                                case 0x55: de.b.h=ix.b.l; cycles+=3; break; /*LD D,IXl*/
-                                case 0x5C: de.b.l=ix.b.h; cycles+=3; break; /*LD E,IXh*/
-                                case 0x5D: de.b.l=ix.b.l; cycles+=3; break; /*LD E,IXl*/
-                                case 0x5E: /*LD E,(IX+nn)*/
-                                addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
-                                intreg=(ix.w+addr)>>8;
-                                cycles+=7; de.b.l=z80_readmem(ix.w+addr);
-                                cycles+=8;
-                                break;
-                                case 0x66: /*LD H,(IX+nn)*/
-                                addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
-                                intreg=(ix.w+addr)>>8;
-                                cycles+=7; hl.b.h=z80_readmem(ix.w+addr);
-                                cycles+=8;
-                                break;
-                                case 0x6E: /*LD L,(IX+nn)*/
-                                addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
-                                intreg=(ix.w+addr)>>8;
-                                cycles+=7; hl.b.l=z80_readmem(ix.w+addr);
-                                cycles+=8;
-                                break;
-                                case 0x60: ix.b.h=bc.b.h; cycles+=3; break;  /*LD IXh,B*/
-                                case 0x61: ix.b.h=bc.b.l; cycles+=3; break;  /*LD IXh,C*/
-                                case 0x62: ix.b.h=de.b.h; cycles+=3; break;  /*LD IXh,D*/
-                                case 0x63: ix.b.h=de.b.l; cycles+=3; break;  /*LD IXh,E*/
-                                case 0x64: ix.b.h=hl.b.h; cycles+=3; break;  /*LD IXh,H*/
-                                case 0x65: ix.b.h=hl.b.l; cycles+=3; break;  /*LD IXh,L*/
-                                case 0x67: ix.b.h=af.b.h; cycles+=3; break;  /*LD IXh,A*/
-                                case 0x68: ix.b.l=bc.b.h; cycles+=3; break;  /*LD IXl,B*/
-                                case 0x69: ix.b.l=bc.b.l; cycles+=3; break;  /*LD IXl,C*/
-                                case 0x6A: ix.b.l=de.b.h; cycles+=3; break;  /*LD IXl,D*/
-                                case 0x6B: ix.b.l=de.b.l; cycles+=3; break;  /*LD IXl,E*/
-                                case 0x6C: ix.b.l=hl.b.h; cycles+=3; break;  /*LD IXl,H*/
-                                case 0x6D: ix.b.l=hl.b.l; cycles+=3; break;  /*LD IXl,L*/
-                                case 0x6F: ix.b.l=af.b.h; cycles+=3; break;  /*LD IXl,A*/
-                                case 0x70: /*LD (IX+nn),B*/
-                                addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
-                                cycles+=7; z80_writemem(ix.w+addr,bc.b.h);
-                                cycles+=8;
-                                break;
-                                case 0x71: /*LD (IX+nn),C*/
-                                addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
-                                cycles+=7; z80_writemem(ix.w+addr,bc.b.l);
-                                cycles+=8;
-                                break;
-                                case 0x72: /*LD (IX+nn),D*/
-                                addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
-                                cycles+=7; z80_writemem(ix.w+addr,de.b.h);
-                                cycles+=8;
-                                break;
-                                case 0x73: /*LD (IX+nn),E*/
-                                addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
-                                cycles+=7; z80_writemem(ix.w+addr,de.b.l);
-                                cycles+=8;
-                                break;
-                                case 0x74: /*LD (IX+nn),H*/
-                                addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
-                                cycles+=7; z80_writemem(ix.w+addr,hl.b.h);
-                                cycles+=8;
-                                break;
-                                case 0x75: /*LD (IX+nn),L*/
-                                addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
-                                cycles+=7; z80_writemem(ix.w+addr,hl.b.l);
-                                cycles+=8;
-                                break;
-                                case 0x77: /*LD (IX+nn),A*/
-                                addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
-                                cycles+=7; z80_writemem(ix.w+addr,af.b.h);
-                                cycles+=8;
-                                break;
-                                case 0x7E: /*LD A,(IX+nn)*/
-                                addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
-                                cycles+=7; af.b.h=z80_readmem(ix.w+addr);
-                                cycles+=8;
-                                break;
-                                case 0x7C: af.b.h=ix.b.h; cycles+=3; break; /*LD A,IXh*/
-                                case 0x7D: af.b.h=ix.b.l; cycles+=3; break; /*LD A,IXl*/
-
-                                case 0x84: z80_setadd(af.b.h,ix.b.h); af.b.h+=ix.b.h; cycles+=3; break;         /*ADD IXh*/
-                                case 0x85: z80_setadd(af.b.h,ix.b.l); af.b.h+=ix.b.l; cycles+=3; break;         /*ADD IXl*/
-                                case 0x8C: setadc(af.b.h,ix.b.h); af.b.h+=ix.b.h+tempc; cycles+=3; break;   /*ADC IXh*/
-                                case 0x8D: setadc(af.b.h,ix.b.l); af.b.h+=ix.b.l+tempc; cycles+=3; break;   /*ADC IXl*/
-                                case 0x94: z80_setsub(af.b.h,ix.b.h); af.b.h-=ix.b.h; cycles+=3; break;         /*SUB IXh*/
-                                case 0x95: z80_setsub(af.b.h,ix.b.l); af.b.h-=ix.b.l; cycles+=3; break;         /*SUB IXl*/
-                                case 0x9C: setsbc(af.b.h,ix.b.h); af.b.h-=(ix.b.h+tempc); cycles+=3; break; /*SBC IXh*/
-                                case 0x9D: setsbc(af.b.h,ix.b.l); af.b.h-=(ix.b.l+tempc); cycles+=3; break; /*SBC IXl*/
-                                case 0xA4: setand(af.b.h&ix.b.h); af.b.h&=ix.b.h; cycles+=3; break;         /*AND IXh*/
-                                case 0xA5: setand(af.b.h&ix.b.l); af.b.h&=ix.b.l; cycles+=3; break;         /*AND IXl*/
-                                case 0xAC: setzn(af.b.h^ix.b.h);  af.b.h^=ix.b.h; cycles+=3; break;         /*XOR IXh*/
-                                case 0xAD: setzn(af.b.h^ix.b.l);  af.b.h^=ix.b.l; cycles+=3; break;         /*XOR IXl*/
-                                case 0xB4: setzn(af.b.h|ix.b.h);  af.b.h|=ix.b.h; cycles+=3; break;         /*OR  IXh*/
-                                case 0xB5: setzn(af.b.h|ix.b.l);  af.b.h|=ix.b.l; cycles+=3; break;         /*OR  IXl*/
-                                case 0xBC: setcp(af.b.h,ix.b.h); cycles+=3; break;                          /*CP  IXh*/
-                                case 0xBD: setcp(af.b.h,ix.b.l); cycles+=3; break;                          /*CP  IXl*/
-
-                                case 0x86: /*ADD (IX+nn)*/
-                                cycles+=4; addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
-                                cycles+=3; temp=z80_readmem(ix.w+addr);
-                                z80_setadd(af.b.h,temp);
-                                af.b.h+=temp;
-                                cycles+=8;
-                                break;
-                                case 0x8E: /*ADC (IX+nn)*/
-                                cycles+=4; addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
-                                cycles+=3; temp=z80_readmem(ix.w+addr);
-                                setadc(af.b.h,temp);
-                                af.b.h+=(temp+tempc);
-                                cycles+=8;
-                                break;
-                                case 0x96: /*SUB (IX+nn)*/
-                                cycles+=4; addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
-                                cycles+=3; temp=z80_readmem(ix.w+addr);
-                                z80_setsub(af.b.h,temp);
-                                af.b.h-=temp;
-                                cycles+=8;
-                                break;
-                                case 0x9E: /*SBC (IX+nn)*/
-                                cycles+=4; addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
-                                cycles+=3; temp=z80_readmem(ix.w+addr);
-                                setsbc(af.b.h,temp);
-                                af.b.h-=(temp+tempc);
-                                cycles+=8;
-                                break;
-                                case 0xA6: /*AND (IX+nn)*/
-                                cycles+=4; addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
-                                cycles+=3; temp=z80_readmem(ix.w+addr);
-                                setand(af.b.h);
-                                cycles+=8;
-                                break;
-                                case 0xAE: /*XOR (IX+nn)*/
-                                cycles+=4; addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
-                                cycles+=3; temp=z80_readmem(ix.w+addr);
-                                setzn(af.b.h);
-                                cycles+=8;
-                                break;
-                                case 0xB6: /*OR (IX+nn)*/
-                                cycles+=4; addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
-                                cycles+=3; temp=z80_readmem(ix.w+addr);
-                                setzn(af.b.h);
-                                cycles+=8;
-                                break;
-                                case 0xBE: /*CP (IX+nn)*/
-                                cycles+=4; addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
-                                cycles+=3; temp=z80_readmem(ix.w+addr);
-                                setcp(af.b.h,temp);
-                                cycles+=8;
-                                break;
-
-                                case 0xCB: /*More opcodes*/
-                                ir.b.l=((ir.b.l+1)&0x7F)|(ir.b.l&0x80);
-                                cycles+=4; addr=z80_readmem(pc++);
-                                if (addr&0x80) addr|=0xFF00;
-                                cycles+=3; opcode=z80_readmem(pc++);
-                                switch (opcode)
-                                {
-                                        case 0x06: /*RLC (IX+nn)*/
-                                        cycles+=5; temp=z80_readmem(addr+ix.w);
-                                        tempc=temp&0x80;
-                                        temp<<=1;
-                                        if (tempc) temp|=1;
-                                        setzn(temp);
-                                        if (tempc) af.b.l|=C_FLAG;
-                                        cycles+=4; z80_writemem(addr+ix.w,temp);
-                                        cycles+=3;
-                                        break;
-                                        case 0x0E: /*RRC (IX+nn)*/
-                                        cycles+=5; temp=z80_readmem(addr+ix.w);
-                                        tempc=temp&1;
-                                        temp>>=1;
-                                        if (tempc) temp|=0x80;
-                                        setzn(temp);
-                                        if (tempc) af.b.l|=C_FLAG;
-                                        cycles+=4; z80_writemem(addr+ix.w,temp);
-                                        cycles+=3;
-                                        break;
-                                        case 0x16:  /*RL (IX+nn)*/
-                                        cycles+=5; temp=z80_readmem(addr+ix.w);
-                                        addr=temp&0x80;
-                                        temp<<=1;
-                                        if (tempc) temp|=1;
-                                        setzn(temp);
-                                        if (addr) af.b.l|=C_FLAG;
-                                        cycles+=4; z80_writemem(addr+ix.w,temp);
-                                        cycles+=3;
-                                        break;
-                                        case 0x1E:  /*RR (IX+nn)*/
-                                        cycles+=5; temp=z80_readmem(addr+ix.w);
-                                        addr=temp&1;
-                                        temp>>=1;
-                                        if (tempc) temp|=0x80;
-                                        setzn(temp);
-                                        if (addr) af.b.l|=C_FLAG;
-                                        cycles+=4; z80_writemem(addr+ix.w,temp);
-                                        cycles+=3;
-                                        break;
-                                        case 0x26:  /*SLA (IX+nn)*/
-                                        cycles+=5; temp=z80_readmem(addr+ix.w);
-                                        tempc=temp&0x80;
-                                        temp<<=1;
-                                        setzn(temp);
-                                        if (tempc) af.b.l|=C_FLAG;
-                                        cycles+=4; z80_writemem(addr+ix.w,temp);
-                                        cycles+=3;
-                                        break;
-                                        case 0x2E:  /*SRA (IX+nn)*/
-                                        cycles+=5; temp=z80_readmem(addr+ix.w);
-                                        tempc=temp&1;
-                                        temp>>=1;
-                                        if (temp&0x40) temp|=0x80;
-                                        setzn(temp);
-                                        if (tempc) af.b.l|=C_FLAG;
-                                        cycles+=4; z80_writemem(addr+ix.w,temp);
-                                        cycles+=3;
-                                        break;
-                                        case 0x3E:  /*SRL (IX+nn)*/
-                                        cycles+=5; temp=z80_readmem(addr+ix.w);
-                                        tempc=temp&1;
-                                        temp>>=1;
-                                        setzn(temp);
-                                        if (tempc) af.b.l|=C_FLAG;
-                                        cycles+=4; z80_writemem(addr+ix.w,temp);
-                                        cycles+=3;
-                                        break;
-
-
-                                        case 0x46: cycles+=5; temp=z80_readmem(ix.w+addr); setbit2(temp&1,ix.w+addr); cycles+=4; break; /*BIT 0,(IX+nn)*/
-                                        case 0x4E: cycles+=5; temp=z80_readmem(ix.w+addr); setbit2(temp&2,ix.w+addr); cycles+=4; break; /*BIT 1,(IX+nn)*/
-                                        case 0x56: cycles+=5; temp=z80_readmem(ix.w+addr); setbit2(temp&4,ix.w+addr); cycles+=4; break; /*BIT 2,(IX+nn)*/
-                                        case 0x5E: cycles+=5; temp=z80_readmem(ix.w+addr); setbit2(temp&8,ix.w+addr); cycles+=4; break; /*BIT 3,(IX+nn)*/
-                                        case 0x66: cycles+=5; temp=z80_readmem(ix.w+addr); setbit2(temp&0x10,ix.w+addr); cycles+=4; break; /*BIT 4,(IX+nn)*/
-                                        case 0x6E: cycles+=5; temp=z80_readmem(ix.w+addr); setbit2(temp&0x20,ix.w+addr); cycles+=4; break; /*BIT 5,(IX+nn)*/
-                                        case 0x76: cycles+=5; temp=z80_readmem(ix.w+addr); setbit2(temp&0x40,ix.w+addr); cycles+=4; break; /*BIT 6,(IX+nn)*/
-                                        case 0x7E: cycles+=5; temp=z80_readmem(ix.w+addr); setbit2(temp&0x80,ix.w+addr); cycles+=4; break; /*BIT 7,(IX+nn)*/
-
-                                        case 0x86: cycles+=5; temp=z80_readmem(ix.w+addr)&~1; cycles+=4; z80_writemem(ix.w+addr,temp); cycles+=3; break;    /*RES 0,(IX+nn)*/
-                                        case 0x8E: cycles+=5; temp=z80_readmem(ix.w+addr)&~2; cycles+=4; z80_writemem(ix.w+addr,temp); cycles+=3; break;    /*RES 1,(IX+nn)*/
-                                        case 0x96: cycles+=5; temp=z80_readmem(ix.w+addr)&~4; cycles+=4; z80_writemem(ix.w+addr,temp); cycles+=3; break;    /*RES 2,(IX+nn)*/
-                                        case 0x9E: cycles+=5; temp=z80_readmem(ix.w+addr)&~8; cycles+=4; z80_writemem(ix.w+addr,temp); cycles+=3; break;    /*RES 3,(IX+nn)*/
-                                        case 0xA6: cycles+=5; temp=z80_readmem(ix.w+addr)&~0x10; cycles+=4; z80_writemem(ix.w+addr,temp); cycles+=3; break; /*RES 4,(IX+nn)*/
-                                        case 0xAE: cycles+=5; temp=z80_readmem(ix.w+addr)&~0x20; cycles+=4; z80_writemem(ix.w+addr,temp); cycles+=3; break; /*RES 5,(IX+nn)*/
-                                        case 0xB6: cycles+=5; temp=z80_readmem(ix.w+addr)&~0x40; cycles+=4; z80_writemem(ix.w+addr,temp); cycles+=3; break; /*RES 6,(IX+nn)*/
-                                        case 0xBE: cycles+=5; temp=z80_readmem(ix.w+addr)&~0x80; cycles+=4; z80_writemem(ix.w+addr,temp); cycles+=3; break; /*RES 7,(IX+nn)*/
-                                        case 0xC6: cycles+=5; temp=z80_readmem(ix.w+addr)|1; cycles+=4; z80_writemem(ix.w+addr,temp); cycles+=3; break;     /*SET 0,(IX+nn)*/
-                                        case 0xCE: cycles+=5; temp=z80_readmem(ix.w+addr)|2; cycles+=4; z80_writemem(ix.w+addr,temp); cycles+=3; break;     /*SET 1,(IX+nn)*/
-                                        case 0xD6: cycles+=5; temp=z80_readmem(ix.w+addr)|4; cycles+=4; z80_writemem(ix.w+addr,temp); cycles+=3; break;     /*SET 2,(IX+nn)*/
-                                        case 0xDE: cycles+=5; temp=z80_readmem(ix.w+addr)|8; cycles+=4; z80_writemem(ix.w+addr,temp); cycles+=3; break;     /*SET 3,(IX+nn)*/
-                                        case 0xE6: cycles+=5; temp=z80_readmem(ix.w+addr)|0x10; cycles+=4; z80_writemem(ix.w+addr,temp); cycles+=3; break;  /*SET 4,(IX+nn)*/
-                                        case 0xEE: cycles+=5; temp=z80_readmem(ix.w+addr)|0x20; cycles+=4; z80_writemem(ix.w+addr,temp); cycles+=3; break;  /*SET 5,(IX+nn)*/
-                                        case 0xF6: cycles+=5; temp=z80_readmem(ix.w+addr)|0x40; cycles+=4; z80_writemem(ix.w+addr,temp); cycles+=3; break;  /*SET 6,(IX+nn)*/
-                                        case 0xFE: cycles+=5; temp=z80_readmem(ix.w+addr)|0x80; cycles+=4; z80_writemem(ix.w+addr,temp); cycles+=3; break;  /*SET 7,(IX+nn)*/
-
-                                        default:
-                                        break;
-//                                        printf("Bad DD CB opcode %02X at %04X\n",opcode,pc);
-//                                        z80_dumpregs();
-//                                        exit(-1);
-                                }
-                                break;
-
-                                case 0xE1: /*POP IX*/
-                                cycles+=4; ix.b.l=z80_readmem(sp); sp++;
-                                cycles+=3; ix.b.h=z80_readmem(sp); sp++;
-                                cycles+=3;
-                                break;
-                                case 0xE3: /*EX (SP),IX*/
-                                cycles+=4; addr=z80_readmem(sp);
-                                cycles+=3; addr|=(z80_readmem(sp+1)<<8);
-                                cycles+=4; z80_writemem(sp,ix.b.l);
-                                cycles+=3; z80_writemem(sp+1,ix.b.h);
-                                ix.w=addr;
-                                cycles+=5;
-                                break;
-                                case 0xE5: /*PUSH IX*/
-                                cycles+=5; sp--; z80_writemem(sp,ix.b.h);
-                                cycles+=3; sp--; z80_writemem(sp,ix.b.l);
-                                cycles+=3;
-                                break;
-                                case 0xE9: /*JP (IX)*/
-                                pc=ix.w;
-                                cycles+=4;
-                                break;
-
-                                case 0xF9: /*LD SP,IX*/
-                                sp=ix.w;
-                                cycles+=6;
-                                break;
-
-                                default:
-                                break;
-//                                printf("Bad DD opcode %02X at %04X\n",opcode,pc);
-//                                z80_dumpregs();
-//                                exit(-1);
-                        }
-                        break;
 
                         case 0xDE: /*SBC A,nn*/
                         cycles+=4; temp=z80_readmem(pc++);
@@ -2553,285 +2171,283 @@ void z80_exec()
                            cycles+=3;
                         break;
 
-                        case 0xFD: /*More opcodes*/
+                        case 0xDD: /*More opcodes, XY below being IX for DD and IY for FD*/
+                        case 0xFD:
+                        xy=(opcode==0xDD)?&ix:&iy;
                         ir.b.l=((ir.b.l+1)&0x7F)|(ir.b.l&0x80);
                         cycles+=4;
                         opcode=z80_readmem(pc++);
                         switch (opcode)
                         {
-                                case 0x3A:
-                                pc--;
-                                break;
-
-                                case 0x09: /*ADD IY,BC*/
-                                z80_setadd16(iy.w,bc.w);
-                                iy.w+=bc.w;
+                                case 0x09: /*ADD XY,BC*/
+                                z80_setadd16(xy->w,bc.w);
+                                xy->w+=bc.w;
                                 cycles+=11;
                                 break;
-                                case 0x19: /*ADD IY,DE*/
-                                z80_setadd16(iy.w,de.w);
-                                iy.w+=de.w;
+                                case 0x19: /*ADD XY,DE*/
+                                z80_setadd16(xy->w,de.w);
+                                xy->w+=de.w;
                                 cycles+=11;
                                 break;
-                                case 0x21: /*LD IY,nn*/
-                                cycles+=4; iy.b.l=z80_readmem(pc++);
-                                cycles+=3; iy.b.h=z80_readmem(pc++);
+                                case 0x21: /*LD XY,nn*/
+                                cycles+=4; xy->b.l=z80_readmem(pc++);
+                                cycles+=3; xy->b.h=z80_readmem(pc++);
                                 cycles+=3;
                                 break;
-                                case 0x22: /*LD (nn),IY*/
+                                case 0x22: /*LD (nn),XY*/
                                 cycles+=4; addr=z80_readmem(pc);
                                 cycles+=3; addr|=(z80_readmem(pc+1)<<8); pc+=2;
-                                cycles+=3; z80_writemem(addr,iy.b.l);
-                                cycles+=3; z80_writemem(addr+1,iy.b.h);
+                                cycles+=3; z80_writemem(addr,xy->b.l);
+                                cycles+=3; z80_writemem(addr+1,xy->b.h);
                                 cycles+=3;
                                 break;
-                                case 0x23: /*INC IY*/
-                                iy.w++;
+                                case 0x23: /*INC XY*/
+                                xy->w++;
                                 cycles+=6;
                                 break;
-                                case 0x24: /*INC IYh*/
-                                setinc(iy.b.h);
-                                iy.b.h++;
+                                case 0x24: /*INC XYh*/
+                                setinc(xy->b.h);
+                                xy->b.h++;
                                 cycles+=4;
                                 break;
-                                case 0x25: /*DEC IYh*/
-                                setdec(iy.b.h);
-                                iy.b.h--;
+                                case 0x25: /*DEC XYh*/
+                                setdec(xy->b.h);
+                                xy->b.h--;
                                 cycles+=4;
                                 break;
-                                case 0x26: /*LD IYh,nn*/
-                                cycles+=4; iy.b.h=z80_readmem(pc++);
+                                case 0x26: /*LD XYh,nn*/
+                                cycles+=4; xy->b.h=z80_readmem(pc++);
                                 cycles+=3;
                                 break;
-                                case 0x29: /*ADD IY,IY*/
-                                z80_setadd16(iy.w,iy.w);
-                                iy.w+=iy.w;
+                                case 0x29: /*ADD XY,XY*/
+                                z80_setadd16(xy->w,xy->w);
+                                xy->w+=xy->w;
                                 cycles+=11;
                                 break;
-                                case 0x2A: /*LD IY,(nn)*/
+                                case 0x2A: /*LD XY,(nn)*/
                                 cycles+=4; addr=z80_readmem(pc);
                                 cycles+=3; addr|=(z80_readmem(pc+1)<<8); pc+=2;
-                                cycles+=3; iy.b.l=z80_readmem(addr);
-                                cycles+=3; iy.b.h=z80_readmem(addr+1);
+                                cycles+=3; xy->b.l=z80_readmem(addr);
+                                cycles+=3; xy->b.h=z80_readmem(addr+1);
                                 cycles+=3;
                                 break;
-                                case 0x2B: /*DEC IY*/
-                                iy.w--;
+                                case 0x2B: /*DEC XY*/
+                                xy->w--;
                                 cycles+=6;
                                 break;
-                                case 0x2C: /*INC IYl*/
-                                setinc(iy.b.l);
-                                iy.b.l++;
+                                case 0x2C: /*INC XYl*/
+                                setinc(xy->b.l);
+                                xy->b.l++;
                                 cycles+=4;
                                 break;
-                                case 0x2D: /*DEC IYl*/
-                                setdec(iy.b.l);
-                                iy.b.l--;
+                                case 0x2D: /*DEC XYl*/
+                                setdec(xy->b.l);
+                                xy->b.l--;
                                 cycles+=4;
                                 break;
-                                case 0x2E: /*LD IYl,nn*/
-                                cycles+=4; iy.b.l=z80_readmem(pc++);
+                                case 0x2E: /*LD XYl,nn*/
+                                cycles+=4; xy->b.l=z80_readmem(pc++);
                                 cycles+=3;
                                 break;
-                                case 0x34: /*INC (IY+nn)*/
+                                case 0x34: /*INC (XY+nn)*/
                                 cycles+=4; addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
-                                addr+=iy.w;
+                                addr+=xy->w;
                                 cycles+=3; temp=z80_readmem(addr);
                                 setinc(temp);
                                 cycles+=5; z80_writemem(addr,temp+1);
                                 cycles+=7;
                                 break;
-                                case 0x35: /*DEC (IY+nn)*/
+                                case 0x35: /*DEC (XY+nn)*/
                                 cycles+=4; addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
-                                addr+=iy.w;
+                                addr+=xy->w;
                                 cycles+=3; temp=z80_readmem(addr);
                                 setdec(temp);
                                 cycles+=5; z80_writemem(addr,temp-1);
                                 cycles+=7;
                                 break;
-                                case 0x36: /*LD (IY+nn),nn*/
+                                case 0x36: /*LD (XY+nn),nn*/
                                 cycles+=4; addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
                                 cycles+=3; temp=z80_readmem(pc++);
-                                cycles+=5; z80_writemem(iy.w+addr,temp);
+                                cycles+=5; z80_writemem(xy->w+addr,temp);
                                 cycles+=3;
                                 break;
-                                case 0x39: /*ADD IY,SP*/
+                                case 0x39: /*ADD XY,SP*/
 //                                output=1;
-                                z80_setadd16(iy.w,sp);
-                                iy.w+=sp;
+                                z80_setadd16(xy->w,sp);
+                                xy->w+=sp;
                                 cycles+=11;
                                 break;
 
-                                case 0x44: bc.b.h=iy.b.h; cycles+=3; break; /*LD B,IYh*/
-                                case 0x45: bc.b.h=iy.b.l; cycles+=3; break; /*LD B,IYl*/
-                                case 0x4C: bc.b.l=iy.b.h; cycles+=3; break; /*LD C,IYh*/
-                                case 0x4D: bc.b.l=iy.b.l; cycles+=3; break; /*LD C,IYl*/
-                                case 0x54: de.b.h=iy.b.h; cycles+=3; break; /*LD D,IYh*/
-                                case 0x55: de.b.h=iy.b.l; cycles+=3; break; /*LD D,IYl*/
-                                case 0x5C: de.b.l=iy.b.h; cycles+=3; break; /*LD E,IYh*/
-                                case 0x5D: de.b.l=iy.b.l; cycles+=3; break; /*LD E,IYl*/
+                                case 0x44: bc.b.h=xy->b.h; cycles+=3; break; /*LD B,XYh*/
+                                case 0x45: bc.b.h=xy->b.l; cycles+=3; break; /*LD B,XYl*/
+                                case 0x4C: bc.b.l=xy->b.h; cycles+=3; break; /*LD C,XYh*/
+                                case 0x4D: bc.b.l=xy->b.l; cycles+=3; break; /*LD C,XYl*/
+                                case 0x54: de.b.h=xy->b.h; cycles+=3; break; /*LD D,XYh*/
+                                case 0x55: de.b.h=xy->b.l; cycles+=3; break; /*LD D,XYl*/
+                                case 0x5C: de.b.l=xy->b.h; cycles+=3; break; /*LD E,XYh*/
+                                case 0x5D: de.b.l=xy->b.l; cycles+=3; break; /*LD E,XYl*/
 
-                                case 0x46: /*LD B,(IY+nn)*/
+                                case 0x46: /*LD B,(XY+nn)*/
                                 addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
-                                intreg=(iy.w+addr)>>8;
-                                cycles+=7; bc.b.h=z80_readmem(iy.w+addr);
+                                intreg=(xy->w+addr)>>8;
+                                cycles+=7; bc.b.h=z80_readmem(xy->w+addr);
                                 cycles+=8;
                                 break;
-                                case 0x4E: /*LD C,(IY+nn)*/
+                                case 0x4E: /*LD C,(XY+nn)*/
                                 addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
-                                intreg=(iy.w+addr)>>8;
-                                cycles+=7; bc.b.l=z80_readmem(iy.w+addr);
+                                intreg=(xy->w+addr)>>8;
+                                cycles+=7; bc.b.l=z80_readmem(xy->w+addr);
                                 cycles+=8;
                                 break;
-                                case 0x56: /*LD D,(IY+nn)*/
+                                case 0x56: /*LD D,(XY+nn)*/
                                 addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
-                                intreg=(iy.w+addr)>>8;
-                                cycles+=7; de.b.h=z80_readmem(iy.w+addr);
+                                intreg=(xy->w+addr)>>8;
+                                cycles+=7; de.b.h=z80_readmem(xy->w+addr);
                                 cycles+=8;
                                 break;
-                                case 0x5E: /*LD E,(IY+nn)*/
+                                case 0x5E: /*LD E,(XY+nn)*/
                                 addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
-                                intreg=(iy.w+addr)>>8;
-                                cycles+=7; de.b.l=z80_readmem(iy.w+addr);
+                                intreg=(xy->w+addr)>>8;
+                                cycles+=7; de.b.l=z80_readmem(xy->w+addr);
                                 cycles+=8;
                                 break;
-                                case 0x66: /*LD H,(IY+nn)*/
+                                case 0x66: /*LD H,(XY+nn)*/
                                 addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
-                                intreg=(iy.w+addr)>>8;
-                                cycles+=7; hl.b.h=z80_readmem(iy.w+addr);
+                                intreg=(xy->w+addr)>>8;
+                                cycles+=7; hl.b.h=z80_readmem(xy->w+addr);
                                 cycles+=8;
                                 break;
-                                case 0x6E: /*LD L,(IY+nn)*/
+                                case 0x6E: /*LD L,(XY+nn)*/
                                 addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
-                                intreg=(iy.w+addr)>>8;
-                                cycles+=7; hl.b.l=z80_readmem(iy.w+addr);
+                                intreg=(xy->w+addr)>>8;
+                                cycles+=7; hl.b.l=z80_readmem(xy->w+addr);
                                 cycles+=8;
                                 break;
-                                case 0x60: iy.b.h=bc.b.h; cycles+=3; break;  /*LD IYh,B*/
-                                case 0x61: iy.b.h=bc.b.l; cycles+=3; break;  /*LD IYh,C*/
-                                case 0x62: iy.b.h=de.b.h; cycles+=3; break;  /*LD IYh,D*/
-                                case 0x63: iy.b.h=de.b.l; cycles+=3; break;  /*LD IYh,E*/
-                                case 0x64: iy.b.h=hl.b.h; cycles+=3; break;  /*LD IYh,H*/
-                                case 0x65: iy.b.h=hl.b.l; cycles+=3; break;  /*LD IYh,L*/
-                                case 0x67: iy.b.h=af.b.h; cycles+=3; break;  /*LD IYh,A*/
-                                case 0x68: iy.b.l=bc.b.h; cycles+=3; break;  /*LD IYl,B*/
-                                case 0x69: iy.b.l=bc.b.l; cycles+=3; break;  /*LD IYl,C*/
-                                case 0x6A: iy.b.l=de.b.h; cycles+=3; break;  /*LD IYl,D*/
-                                case 0x6B: iy.b.l=de.b.l; cycles+=3; break;  /*LD IYl,E*/
-                                case 0x6C: iy.b.l=hl.b.h; cycles+=3; break;  /*LD IYl,H*/
-                                case 0x6D: iy.b.l=hl.b.l; cycles+=3; break;  /*LD IYl,L*/
-                                case 0x6F: iy.b.l=af.b.h; cycles+=3; break;  /*LD IYl,A*/
-
-                                case 0x84: z80_setadd(af.b.h,iy.b.h); af.b.h+=iy.b.h; cycles+=3; break;         /*ADD IYh*/
-                                case 0x85: z80_setadd(af.b.h,iy.b.l); af.b.h+=iy.b.l; cycles+=3; break;         /*ADD IYl*/
-                                case 0x8C: setadc(af.b.h,iy.b.h); af.b.h+=iy.b.h+tempc; cycles+=3; break;   /*ADC IYh*/
-                                case 0x8D: setadc(af.b.h,iy.b.l); af.b.h+=iy.b.l+tempc; cycles+=3; break;   /*ADC IYl*/
-                                case 0x94: z80_setsub(af.b.h,iy.b.h); af.b.h-=iy.b.h; cycles+=3; break;         /*SUB IYh*/
-                                case 0x95: z80_setsub(af.b.h,iy.b.l); af.b.h-=iy.b.l; cycles+=3; break;         /*SUB IYl*/
-                                case 0x9C: setsbc(af.b.h,iy.b.h); af.b.h-=(iy.b.h+tempc); cycles+=3; break; /*SBC IYh*/
-                                case 0x9D: setsbc(af.b.h,iy.b.l); af.b.h-=(iy.b.l+tempc); cycles+=3; break; /*SBC IYl*/
-                                case 0xA4: setand(af.b.h&iy.b.h); af.b.h&=iy.b.h; cycles+=3; break;         /*AND IYh*/
-                                case 0xA5: setand(af.b.h&iy.b.l); af.b.h&=iy.b.l; cycles+=3; break;         /*AND IYl*/
-                                case 0xAC: setzn(af.b.h^iy.b.h);  af.b.h^=iy.b.h; cycles+=3; break;         /*XOR IYh*/
-                                case 0xAD: setzn(af.b.h^iy.b.l);  af.b.h^=iy.b.l; cycles+=3; break;         /*XOR IYl*/
-                                case 0xB4: setzn(af.b.h|iy.b.h);  af.b.h|=iy.b.h; cycles+=3; break;         /*OR  IYh*/
-                                case 0xB5: setzn(af.b.h|iy.b.l);  af.b.h|=iy.b.l; cycles+=3; break;         /*OR  IYl*/
-                                case 0xBC: setcp(af.b.h,iy.b.h); cycles+=3; break;                          /*CP  IYh*/
-                                case 0xBD: setcp(af.b.h,iy.b.l); cycles+=3; break;                          /*CP  IYl*/
-
-                                case 0x70: /*LD (IY+nn),B*/
+                                case 0x60: xy->b.h=bc.b.h; cycles+=3; break;  /*LD XYh,B*/
+                                case 0x61: xy->b.h=bc.b.l; cycles+=3; break;  /*LD XYh,C*/
+                                case 0x62: xy->b.h=de.b.h; cycles+=3; break;  /*LD XYh,D*/
+                                case 0x63: xy->b.h=de.b.l; cycles+=3; break;  /*LD XYh,E*/
+                                case 0x64: xy->b.h=hl.b.h; cycles+=3; break;  /*LD XYh,H*/
+                                case 0x65: xy->b.h=hl.b.l; cycles+=3; break;  /*LD XYh,L*/
+                                case 0x67: xy->b.h=af.b.h; cycles+=3; break;  /*LD XYh,A*/
+                                case 0x68: xy->b.l=bc.b.h; cycles+=3; break;  /*LD XYl,B*/
+                                case 0x69: xy->b.l=bc.b.l; cycles+=3; break;  /*LD XYl,C*/
+                                case 0x6A: xy->b.l=de.b.h; cycles+=3; break;  /*LD XYl,D*/
+                                case 0x6B: xy->b.l=de.b.l; cycles+=3; break;  /*LD XYl,E*/
+                                case 0x6C: xy->b.l=hl.b.h; cycles+=3; break;  /*LD XYl,H*/
+                                case 0x6D: xy->b.l=hl.b.l; cycles+=3; break;  /*LD XYl,L*/
+                                case 0x6F: xy->b.l=af.b.h; cycles+=3; break;  /*LD XYl,A*/
+
+                                case 0x84: z80_setadd(af.b.h,xy->b.h); af.b.h+=xy->b.h; cycles+=3; break;         /*ADD XYh*/
+                                case 0x85: z80_setadd(af.b.h,xy->b.l); af.b.h+=xy->b.l; cycles+=3; break;         /*ADD XYl*/
+                                case 0x8C: setadc(af.b.h,xy->b.h); af.b.h+=xy->b.h+tempc; cycles+=3; break;   /*ADC XYh*/
+                                case 0x8D: setadc(af.b.h,xy->b.l); af.b.h+=xy->b.l+tempc; cycles+=3; break;   /*ADC XYl*/
+                                case 0x94: z80_setsub(af.b.h,xy->b.h); af.b.h-=xy->b.h; cycles+=3; break;         /*SUB XYh*/
+                                case 0x95: z80_setsub(af.b.h,xy->b.l); af.b.h-=xy->b.l; cycles+=3; break;         /*SUB XYl*/
+                                case 0x9C: setsbc(af.b.h,xy->b.h); af.b.h-=(xy->b.h+tempc); cycles+=3; break; /*SBC XYh*/
+                                case 0x9D: setsbc(af.b.h,xy->b.l); af.b.h-=(xy->b.l+tempc); cycles+=3; break; /*SBC XYl*/
+                                case 0xA4: setand(af.b.h&xy->b.h); af.b.h&=xy->b.h; cycles+=3; break;         /*AND XYh*/
+                                case 0xA5: setand(af.b.h&xy->b.l); af.b.h&=xy->b.l; cycles+=3; break;         /*AND XYl*/
+                                case 0xAC: setzn(af.b.h^xy->b.h);  af.b.h^=xy->b.h; cycles+=3; break;         /*XOR XYh*/
+                                case 0xAD: setzn(af.b.h^xy->b.l);  af.b.h^=xy->b.l; cycles+=3; break;         /*XOR XYl*/
+                                case 0xB4: setzn(af.b.h|xy->b.h);  af.b.h|=xy->b.h; cycles+=3; break;         /*OR  XYh*/
+                                case 0xB5: setzn(af.b.h|xy->b.l);  af.b.h|=xy->b.l; cycles+=3; break;         /*OR  XYl*/
+                                case 0xBC: setcp(af.b.h,xy->b.h); cycles+=3; break;                          /*CP  XYh*/
+                                case 0xBD: setcp(af.b.h,xy->b.l); cycles+=3; break;                          /*CP  XYl*/
+
+                                case 0x70: /*LD (XY+nn),B*/
                                 addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
-                                cycles+=7; z80_writemem(iy.w+addr,bc.b.h);
+                                cycles+=7; z80_writemem(xy->w+addr,bc.b.h);
                                 cycles+=8;
                                 break;
-                                case 0x71: /*LD (IY+nn),C*/
+                                case 0x71: /*LD (XY+nn),C*/
                                 addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
-                                cycles+=7; z80_writemem(iy.w+addr,bc.b.l);
+                                cycles+=7; z80_writemem(xy->w+addr,bc.b.l);
                                 cycles+=8;
                                 break;
-                                case 0x72: /*LD (IY+nn),D*/
+                                case 0x72: /*LD (XY+nn),D*/
                                 addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
-                                cycles+=7; z80_writemem(iy.w+addr,de.b.h);
+                                cycles+=7; z80_writemem(xy->w+addr,de.b.h);
                                 cycles+=8;
                                 break;
-                                case 0x73: /*LD (IY+nn),E*/
+                                case 0x73: /*LD (XY+nn),E*/
                                 addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
-                                cycles+=7; z80_writemem(iy.w+addr,de.b.l);
+                                cycles+=7; z80_writemem(xy->w+addr,de.b.l);
                                 cycles+=8;
                                 break;
-                                case 0x74: /*LD (IY+nn),H*/
+                                case 0x74: /*LD (XY+nn),H*/
                                 addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
-                                cycles+=7; z80_writemem(iy.w+addr,hl.b.h);
+                                cycles+=7; z80_writemem(xy->w+addr,hl.b.h);
                                 cycles+=8;
                                 break;
-                                case 0x75: /*LD (IY+nn),L*/
+                                case 0x75: /*LD (XY+nn),L*/
                                 addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
-                                cycles+=7; z80_writemem(iy.w+addr,hl.b.l);
+                                cycles+=7; z80_writemem(xy->w+addr,hl.b.l);
                                 cycles+=8;
                                 break;
-                                case 0x77: /*LD (IY+nn),A*/
+                                case 0x77: /*LD (XY+nn),A*/
                                 addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
-                                cycles+=7; z80_writemem(iy.w+addr,af.b.h);
+                                cycles+=7; z80_writemem(xy->w+addr,af.b.h);
                                 cycles+=8;
                                 break;
-                                case 0x7E: /*LD A,(IY+nn)*/
+                                case 0x7E: /*LD A,(XY+nn)*/
                                 addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
-                                cycles+=7; af.b.h=z80_readmem(iy.w+addr);
+                                cycles+=7; af.b.h=z80_readmem(xy->w+addr);
                                 cycles+=8;
                                 break;
 
-                                case 0x7C: af.b.h=iy.b.h; cycles+=3; break; /*LD A,IYh*/
-                                case 0x7D: af.b.h=iy.b.l; cycles+=3; break; /*LD A,IYl*/
+                                case 0x7C: af.b.h=xy->b.h; cycles+=3; break; /*LD A,XYh*/
+                                case 0x7D: af.b.h=xy->b.l; cycles+=3; break; /*LD A,XYl*/
 
-                                case 0x86: /*ADD (IY+nn)*/
+                                case 0x86: /*ADD (XY+nn)*/
                                 cycles+=4; addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
-                                cycles+=3; temp=z80_readmem(iy.w+addr);
+                                cycles+=3; temp=z80_readmem(xy->w+addr);
                                 z80_setadd(af.b.h,temp);
                                 af.b.h+=temp;
                                 cycles+=8;
                                 break;
-                                case 0x8E: /*ADC (IY+nn)*/
+                                case 0x8E: /*ADC (XY+nn)*/
                                 cycles+=4; addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
-                                cycles+=3; temp=z80_readmem(iy.w+addr);
+                                cycles+=3; temp=z80_readmem(xy->w+addr);
                                 setadc(af.b.h,temp);
                                 af.b.h+=(temp+tempc);
                                 cycles+=8;
                                 break;
-                                case 0x96: /*SUB (IY+nn)*/
+                                case 0x96: /*SUB (XY+nn)*/
                                 cycles+=4; addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
-                                cycles+=3; temp=z80_readmem(iy.w+addr);
+                                cycles+=3; temp=z80_readmem(xy->w+addr);
                                 z80_setsub(af.b.h,temp);
                                 af.b.h-=temp;
                                 cycles+=8;
                                 break;
-                                case 0x9E: /*SBC (IY+nn)*/
+                                case 0x9E: /*SBC (XY+nn)*/
                                 cycles+=4; addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
-                                cycles+=3; temp=z80_readmem(iy.w+addr);
+                                cycles+=3; temp=z80_readmem(xy->w+addr);
                                 setsbc(af.b.h,temp);
                                 af.b.h-=(temp+tempc);
                                 cycles+=8;
                                 break;
-                                case 0xA6: /*AND (IY+nn)*/
+                                case 0xA6: /*AND (XY+nn)*/
                                 cycles+=4; addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
-                                cycles+=3; af.b.h&=z80_readmem(iy.w+addr);
+                                cycles+=3; af.b.h&=z80_readmem(xy->w+addr);
                                 setand(af.b.h);
                                 cycles+=8;
                                 break;
-                                case 0xAE: /*XOR (IY+nn)*/
+                                case 0xAE: /*XOR (XY+nn)*/
                                 cycles+=4; addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
-                                cycles+=3; af.b.h^=z80_readmem(iy.w+addr);
+                                cycles+=3; af.b.h^=z80_readmem(xy->w+addr);
                                 setzn(af.b.h);
                                 cycles+=8;
                                 break;
-                                case 0xB6: /*OR (IY+nn)*/
+                                case 0xB6: /*OR (XY+nn)*/
                                 cycles+=4; addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
-                                cycles+=3; af.b.h|=z80_readmem(iy.w+addr);
+                                cycles+=3; af.b.h|=z80_readmem(xy->w+addr);
                                 setzn(af.b.h);
                                 cycles+=8;
                                 break;
-                                case 0xBE: /*CP (IY+nn)*/
+                                case 0xBE: /*CP (XY+nn)*/
                                 cycles+=4; addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
-                                cycles+=3; temp=z80_readmem(iy.w+addr);
+                                cycles+=3; temp=z80_readmem(xy->w+addr);
                                 setcp(af.b.h,temp);
                                 cycles+=8;
                                 break;
@@ -2841,118 +2457,34 @@ void z80_exec()
                                 cycles+=4; addr=z80_readmem(pc++);
                                 if (addr&0x80) addr|=0xFF00;
                                 cycles+=3; opcode=z80_readmem(pc++);
-                                switch (opcode)
-                                {
-                                        case 0x06: /*RLC (IY+nn)*/
-                                        cycles+=5; temp=z80_readmem(addr+iy.w);
-                                        tempc=temp&0x80;
-                                        temp<<=1;
-                                        if (tempc) temp|=1;
-                                        setzn(temp);
-                                        if (tempc) af.b.l|=C_FLAG;
-                                        cycles+=4; z80_writemem(addr+iy.w,temp);
-                                        cycles+=3;
-                                        break;
-                                        case 0x0E: /*RRC (IY+nn)*/
-                                        cycles+=5; temp=z80_readmem(addr+iy.w);
-                                        tempc=temp&1;
-                                        temp>>=1;
-                                        if (tempc) temp|=0x80;
-                                        setzn(temp);
-                                        if (tempc) af.b.l|=C_FLAG;
-                                        cycles+=4; z80_writemem(addr+iy.w,temp);
-                                        cycles+=3;
-                                        break;
-                                        case 0x16:  /*RL (IY+nn)*/
-                                        cycles+=5; temp=z80_readmem(addr+iy.w);
-                                        addr=temp&0x80;
-                                        temp<<=1;
-                                        if (tempc) temp|=1;
-                                        setzn(temp);
-                                        if (addr) af.b.l|=C_FLAG;
-                                        cycles+=4; z80_writemem(addr+iy.w,temp);
-                                        cycles+=3;
-                                        break;
-                                        case 0x1E:  /*RR (IY+nn)*/
-                                        cycles+=5; temp=z80_readmem(addr+iy.w);
-                                        addr=temp&1;
-                                        temp>>=1;
-                                        if (tempc) temp|=0x80;
-                                        setzn(temp);
-                                        if (addr) af.b.l|=C_FLAG;
-                                        cycles+=4; z80_writemem(addr+iy.w,temp);
-                                        cycles+=3;
-                                        break;
-                                        case 0x2E:  /*SRA (IY+nn)*/
-                                        cycles+=5; temp=z80_readmem(addr+iy.w);
-                                        tempc=temp&1;
-                                        temp>>=1;
-                                        if (temp&0x40) temp|=0x80;
-                                        setzn(temp);
-                                        if (tempc) af.b.l|=C_FLAG;
-                                        cycles+=4; z80_writemem(addr+iy.w,temp);
-                                        cycles+=3;
-                                        break;
-
-                                        case 0x46: cycles+=5; temp=z80_readmem(iy.w+addr); setbit2(temp&1,iy.w+addr); cycles+=4; break; /*BIT 0,(iy+nn)*/
-                                        case 0x4E: cycles+=5; temp=z80_readmem(iy.w+addr); setbit2(temp&2,iy.w+addr); cycles+=4; break; /*BIT 1,(iy+nn)*/
-                                        case 0x56: cycles+=5; temp=z80_readmem(iy.w+addr); setbit2(temp&4,iy.w+addr); cycles+=4; break; /*BIT 2,(iy+nn)*/
-                                        case 0x5E: cycles+=5; temp=z80_readmem(iy.w+addr); setbit2(temp&8,iy.w+addr); cycles+=4; break; /*BIT 3,(iy+nn)*/
-                                        case 0x66: cycles+=5; temp=z80_readmem(iy.w+addr); setbit2(temp&0x10,iy.w+addr); cycles+=4; break; /*BIT 4,(iy+nn)*/
-                                        case 0x6E: cycles+=5; temp=z80_readmem(iy.w+addr); setbit2(temp&0x20,iy.w+addr); cycles+=4; break; /*BIT 5,(iy+nn)*/
-                                        case 0x76: cycles+=5; temp=z80_readmem(iy.w+addr); setbit2(temp&0x40,iy.w+addr); cycles+=4; break; /*BIT 6,(iy+nn)*/
-                                        case 0x7E: cycles+=5; temp=z80_readmem(iy.w+addr); setbit2(temp&0x80,iy.w+addr); cycles+=4; break; /*BIT 7,(iy+nn)*/
-
-                                        case 0x86: cycles+=5; temp=z80_readmem(iy.w+addr)&~1; cycles+=4; z80_writemem(iy.w+addr,temp); cycles+=3; break;    /*RES 0,(iy+nn)*/
-                                        case 0x8E: cycles+=5; temp=z80_readmem(iy.w+addr)&~2; cycles+=4; z80_writemem(iy.w+addr,temp); cycles+=3; break;    /*RES 1,(iy+nn)*/
-                                        case 0x96: cycles+=5; temp=z80_readmem(iy.w+addr)&~4; cycles+=4; z80_writemem(iy.w+addr,temp); cycles+=3; break;    /*RES 2,(iy+nn)*/
-                                        case 0x9E: cycles+=5; temp=z80_readmem(iy.w+addr)&~8; cycles+=4; z80_writemem(iy.w+addr,temp); cycles+=3; break;    /*RES 3,(iy+nn)*/
-                                        case 0xA6: cycles+=5; temp=z80_readmem(iy.w+addr)&~0x10; cycles+=4; z80_writemem(iy.w+addr,temp); cycles+=3; break; /*RES 4,(iy+nn)*/
-                                        case 0xAE: cycles+=5; temp=z80_readmem(iy.w+addr)&~0x20; cycles+=4; z80_writemem(iy.w+addr,temp); cycles+=3; break; /*RES 5,(iy+nn)*/
-                                        case 0xB6: cycles+=5; temp=z80_readmem(iy.w+addr)&~0x40; cycles+=4; z80_writemem(iy.w+addr,temp); cycles+=3; break; /*RES 6,(iy+nn)*/
-                                        case 0xBE: cycles+=5; temp=z80_readmem(iy.w+addr)&~0x80; cycles+=4; z80_writemem(iy.w+addr,temp); cycles+=3; break; /*RES 7,(iy+nn)*/
-                                        case 0xC6: cycles+=5; temp=z80_readmem(iy.w+addr)|1; cycles+=4; z80_writemem(iy.w+addr,temp); cycles+=3; break;     /*SET 0,(iy+nn)*/
-                                        case 0xCE: cycles+=5; temp=z80_readmem(iy.w+addr)|2; cycles+=4; z80_writemem(iy.w+addr,temp); cycles+=3; break;     /*SET 1,(iy+nn)*/
-                                        case 0xD6: cycles+=5; temp=z80_readmem(iy.w+addr)|4; cycles+=4; z80_writemem(iy.w+addr,temp); cycles+=3; break;     /*SET 2,(iy+nn)*/
-                                        case 0xDE: cycles+=5; temp=z80_readmem(iy.w+addr)|8; cycles+=4; z80_writemem(iy.w+addr,temp); cycles+=3; break;     /*SET 3,(iy+nn)*/
-                                        case 0xE6: cycles+=5; temp=z80_readmem(iy.w+addr)|0x10; cycles+=4; z80_writemem(iy.w+addr,temp); cycles+=3; break;  /*SET 4,(iy+nn)*/
-                                        case 0xEE: cycles+=5; temp=z80_readmem(iy.w+addr)|0x20; cycles+=4; z80_writemem(iy.w+addr,temp); cycles+=3; break;  /*SET 5,(iy+nn)*/
-                                        case 0xF6: cycles+=5; temp=z80_readmem(iy.w+addr)|0x40; cycles+=4; z80_writemem(iy.w+addr,temp); cycles+=3; break;  /*SET 6,(iy+nn)*/
-                                        case 0xFE: cycles+=5; temp=z80_readmem(iy.w+addr)|0x80; cycles+=4; z80_writemem(iy.w+addr,temp); cycles+=3; break;  /*SET 7,(iy+nn)*/
-
-                                        default:
-                                        break;
-//                                        printf("Bad FD CB opcode %02X at %04X\n",opcode,pc);
-//                                        z80_dumpregs();
-//                                        exit(-1);
-                                }
+                                z80_index_cb(xy->w+addr,opcode);
                                 break;
 
-                                case 0xE1: /*POP IY*/
-                                cycles+=4; iy.b.l=z80_readmem(sp); sp++;
-                                cycles+=3; iy.b.h=z80_readmem(sp); sp++;
+                                case 0xE1: /*POP XY*/
+                                cycles+=4; xy->b.l=z80_readmem(sp); sp++;
+                                cycles+=3; xy->b.h=z80_readmem(sp); sp++;
                                 cycles+=3;
                                 break;
-                                case 0xE3: /*EX (SP),IY*/
+                                case 0xE3: /*EX (SP),XY*/
                                 cycles+=4; addr=z80_readmem(sp);
                                 cycles+=3; addr|=(z80_readmem(sp+1)<<8);
-                                cycles+=4; z80_writemem(sp,iy.b.l);
-                                cycles+=3; z80_writemem(sp+1,iy.b.h);
-                                iy.w=addr;
+                                cycles+=4; z80_writemem(sp,xy->b.l);
+                                cycles+=3; z80_writemem(sp+1,xy->b.h);
+                                xy->w=addr;
                                 cycles+=5;
                                 break;
-                                case 0xE5: /*PUSH IY*/
-                                cycles+=5; sp--; z80_writemem(sp,iy.b.h);
-                                cycles+=3; sp--; z80_writemem(sp,iy.b.l);
+                                case 0xE5: /*PUSH XY*/
+                                cycles+=5; sp--; z80_writemem(sp,xy->b.h);
+                                cycles+=3; sp--; z80_writemem(sp,xy->b.l);
                                 cycles+=3;
                                 break;
-                                case 0xE9: /*JP (IY)*/
-                                pc=iy.w;
+                                case 0xE9: /*JP (XY)*/
+                                pc=xy->w;
                                 cycles+=4;
                                 break;
 
-                                case 0xF9: /*LD SP,IY*/
-                                sp=iy.w;
+                                case 0xF9: /*LD SP,XY*/
+                                sp=xy->w;
                                 cycles+=6;
                                 break;
 
@@ -2962,9 +2494,10 @@ void z80_exec()
                                 cycles+=4;
                                 break;*/
 
-                                default:
+                                default: /*No index register involved, run the opcode unprefixed*/
+                                pc--;
                                 break;
-//                                printf("Bad FD opcode %02X at %04X\n",opcode,pc);
+//                                printf("Bad DD/FD opcode %02X at %04X\n",opcode,pc);
 //                                z80_dumpregs();
 //                                exit(-1);
                         }